@@ -0,0 +1,89 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "common/Types.hpp"
+
+constexpr std::size_t kDepthLevels = 10;   // MBP-10
+
+struct BookLevel {
+  PriceI px{0};
+  QtyI   sz{0};
+};
+
+// One MBP-10 update: the full top-10 on both sides after the event.
+struct QuoteL10 {
+  TsNanos ts{0};
+  std::array<BookLevel, kDepthLevels> bid{}, ask{};
+
+  QuoteL1 top() const { return QuoteL1{ts, bid[0].px, ask[0].px, bid[0].sz, ask[0].sz}; }
+};
+
+// An aggressive order walked through the visible levels.
+struct BookWalk {
+  QtyI   filled = 0;     // < wanted when the visible depth runs out
+  double vwap   = 0.0;   // average fill price (0 if nothing filled)
+  PriceI worst  = 0.0;   // price of the deepest level touched
+  int    levels = 0;     // levels touched
+};
+
+struct DepthFillStats {
+  std::uint64_t takes = 0;          // aggressive fills walked through the book
+  std::uint64_t partial = 0;        // ... that ran out of visible depth
+  std::uint64_t lots_wanted = 0, lots_filled = 0;
+  std::uint64_t levels_walked = 0;
+  double        slip_ticks = 0.0;   // sum over fills of |vwap - touch| in ticks, per lot
+
+  double avg_levels() const { return takes ? double(levels_walked) / double(takes) : 0.0; }
+  double avg_slip_ticks() const { return lots_filled ? slip_ticks / double(lots_filled) : 0.0; }
+};
+
+// Top-of-book depth in two fixed arrays, overwritten in place by each
+// MBP-10 update (the feed sends whole levels, so there is nothing to
+// insert or shift). A market order's fill is a linear scan down at most
+// kDepthLevels levels of the opposite side.
+class DepthBook {
+ public:
+  void apply(const QuoteL10& u) {
+    ts = u.ts;
+    bid = u.bid;
+    ask = u.ask;
+  }
+
+  TsNanos time() const { return ts; }
+  QuoteL1 top() const { return QuoteL1{ts, bid[0].px, ask[0].px, bid[0].sz, ask[0].sz}; }
+  const BookLevel& level(int side, std::size_t i) const { return side > 0 ? bid[i] : ask[i]; }
+
+  // buy (side > 0) lifts the offers, sell hits the bids; a non-zero `limit`
+  // stops the walk at that price
+  BookWalk walk(int side, QtyI qty, PriceI limit = 0.0) const {
+    const auto& lv = side > 0 ? ask : bid;
+    BookWalk w;
+    double notional = 0.0;
+    for (std::size_t i = 0; i < kDepthLevels && w.filled < qty; ++i) {
+      const BookLevel& l = lv[i];
+      if (l.sz <= 0 || l.px <= 0.0) break;
+      if (limit > 0.0 && (side > 0 ? l.px > limit : l.px < limit)) break;
+      const QtyI take = qty - w.filled < l.sz ? qty - w.filled : l.sz;
+      notional += double(take) * l.px;
+      w.filled += take;
+      w.worst = l.px;
+      ++w.levels;
+    }
+    if (w.filled > 0) w.vwap = notional / double(w.filled);
+    return w;
+  }
+
+  // visible size on one side across the first n levels
+  QtyI depth(int side, std::size_t n = kDepthLevels) const {
+    const auto& lv = side > 0 ? bid : ask;
+    QtyI s = 0;
+    for (std::size_t i = 0; i < n && i < kDepthLevels; ++i) s += lv[i].sz;
+    return s;
+  }
+
+ private:
+  TsNanos ts = 0;
+  std::array<BookLevel, kDepthLevels> bid{}, ask{};
+};
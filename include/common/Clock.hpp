@@ -0,0 +1,56 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Cheap monotonic clock for the live path: raw TSC reads, converted to
+// nanoseconds with a one-off calibration against steady_clock. Falls back
+// to steady_clock on targets without an invariant TSC.
+class TscClock {
+ public:
+  static std::uint64_t ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+  }
+
+  static std::int64_t to_ns(std::uint64_t t) {
+    const Calib& c = calib();
+    // signed: a tick read just before the first calibration precedes t0
+    const auto dt = static_cast<std::int64_t>(t - c.t0);
+    return static_cast<std::int64_t>(static_cast<double>(dt) * c.ns_per_tick) + c.ns0;
+  }
+
+  static std::int64_t now_ns() { return to_ns(ticks()); }
+  static double ns_per_tick() { return calib().ns_per_tick; }
+
+ private:
+  struct Calib {
+    std::uint64_t t0 = 0;
+    std::int64_t  ns0 = 0;
+    double        ns_per_tick = 1.0;
+  };
+
+  static const Calib& calib() {
+    static const Calib c = [] {
+      using namespace std::chrono;
+      Calib k;
+      const auto s0 = steady_clock::now();
+      k.t0  = ticks();
+      std::this_thread::sleep_for(milliseconds(20));
+      const auto s1 = steady_clock::now();
+      const std::uint64_t t1 = ticks();
+      const double dns = static_cast<double>(duration_cast<nanoseconds>(s1 - s0).count());
+      if (t1 > k.t0) k.ns_per_tick = dns / static_cast<double>(t1 - k.t0);
+      k.ns0 = duration_cast<nanoseconds>(s0.time_since_epoch()).count();
+      return k;
+    }();
+    return c;
+  }
+};
@@ -0,0 +1,184 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+// Named counters and gauges, declared once below. Hot paths count into a
+// CounterSet they own (plain increments, one writer, padded to whole cache
+// lines so sets of neighbouring workers never share one); finished sets
+// are merged per combo by the caller and/or into this thread's registry
+// slot, and CounterRegistry::total() sums every slot on demand.
+
+// name, meaning
+#define OFI_COUNTERS(X)                                                         \
+  X(quotes,          "quotes run through the gates")                            \
+  X(trades,          "prints fed to the strategy")                              \
+  X(gate_rth,        "quotes rejected: outside RTH")                            \
+  X(gate_spread,     "quotes rejected: spread != min_spread_ticks")             \
+  X(gate_size,       "quotes rejected: touch size below min_bid/ask_sz")        \
+  X(no_signal,       "gated quotes with no raw signal (thresholds / warmup)")   \
+  X(rej_confirm,     "raw signals without a confirming trade")                  \
+  X(rej_persist,     "raw signals not yet persistent")                          \
+  X(rej_cooldown,    "flips blocked by the cooldown")                           \
+  X(signals,         "signals emitted")                                         \
+  X(entries,         "entries opened or placed")                                \
+  X(fills,           "exits that realized PnL")                                 \
+  X(quotes_skipped,  "quotes in zone-map minutes skipped without replay")       \
+  X(load_records,    "records decoded by the DBN loaders")                      \
+  X(load_instrument, "records dropped: other instrument")                       \
+  X(load_rth,        "records dropped: outside RTH")                            \
+  X(load_crossed,    "quotes dropped: empty or crossed top")                    \
+  X(load_kept,       "records kept")                                            \
+  X(side_feed,       "prints with the aggressor from the feed")                 \
+  X(side_quote,      "Unknown prints signed by the quote rule")                 \
+  X(side_tick,       "Unknown prints signed by the tick rule")                  \
+  X(side_unknown,    "prints left Unknown")
+
+// name, meaning (current value and high-water mark)
+#define OFI_GAUGES(X)                                                           \
+  X(position_lots,   "lots held")                                               \
+  X(load_day_kept,   "records kept by the last load")
+
+enum class Ctr : std::uint16_t {
+#define OFI_CTR_ENUM(name, help) name,
+  OFI_COUNTERS(OFI_CTR_ENUM)
+#undef OFI_CTR_ENUM
+  Count
+};
+
+enum class Gauge : std::uint16_t {
+#define OFI_GAUGE_ENUM(name, help) name,
+  OFI_GAUGES(OFI_GAUGE_ENUM)
+#undef OFI_GAUGE_ENUM
+  Count
+};
+
+inline constexpr std::size_t kCounters = static_cast<std::size_t>(Ctr::Count);
+inline constexpr std::size_t kGauges   = static_cast<std::size_t>(Gauge::Count);
+
+struct alignas(64) CounterSet {
+  std::array<std::uint64_t, kCounters> c{};
+  std::array<std::int64_t, kGauges>    g{}, g_peak{};
+
+  void add(Ctr k, std::uint64_t n = 1) { c[static_cast<std::size_t>(k)] += n; }
+  std::uint64_t operator[](Ctr k) const { return c[static_cast<std::size_t>(k)]; }
+
+  void set(Gauge k, std::int64_t v) {
+    const auto i = static_cast<std::size_t>(k);
+    g[i] = v;
+    g_peak[i] = std::max(g_peak[i], v);
+  }
+  std::int64_t gauge(Gauge k) const { return g[static_cast<std::size_t>(k)]; }
+  std::int64_t peak(Gauge k) const { return g_peak[static_cast<std::size_t>(k)]; }
+
+  // counters and current gauge values add up, peaks take the max
+  void merge(const CounterSet& o) {
+    for (std::size_t i = 0; i < kCounters; ++i) c[i] += o.c[i];
+    for (std::size_t i = 0; i < kGauges; ++i) {
+      g[i] += o.g[i];
+      g_peak[i] = std::max(g_peak[i], o.g_peak[i]);
+    }
+  }
+};
+
+// Process-wide aggregation: one padded slot per thread that ever add()ed,
+// kept after the thread exits so its counts still show in total(). A slot
+// is written only by its thread (relaxed load + store, no lock prefix).
+class CounterRegistry {
+ public:
+  static void add(const CounterSet& s) {
+    Slot& m = local();
+    for (std::size_t i = 0; i < kCounters; ++i)
+      if (s.c[i]) m.c[i].store(m.c[i].load(std::memory_order_relaxed) + s.c[i], std::memory_order_relaxed);
+    for (std::size_t i = 0; i < kGauges; ++i) {
+      if (s.g[i] == 0 && s.g_peak[i] == 0) continue;   // never set in s
+      m.g[i].store(s.g[i], std::memory_order_relaxed);
+      if (s.g_peak[i] > m.g_peak[i].load(std::memory_order_relaxed))
+        m.g_peak[i].store(s.g_peak[i], std::memory_order_relaxed);
+    }
+  }
+
+  static CounterSet total() {
+    CounterSet t;
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lk(r.mu);
+    for (const auto& m : r.slots) {
+      for (std::size_t i = 0; i < kCounters; ++i) t.c[i] += m->c[i].load(std::memory_order_relaxed);
+      for (std::size_t i = 0; i < kGauges; ++i) {
+        t.g[i] += m->g[i].load(std::memory_order_relaxed);
+        t.g_peak[i] = std::max(t.g_peak[i], m->g_peak[i].load(std::memory_order_relaxed));
+      }
+    }
+    return t;
+  }
+
+ private:
+  struct alignas(64) Slot {
+    std::array<std::atomic<std::uint64_t>, kCounters> c{};
+    std::array<std::atomic<std::int64_t>, kGauges>    g{}, g_peak{};
+  };
+  struct Registry {
+    std::mutex mu;
+    std::vector<std::unique_ptr<Slot>> slots;
+  };
+
+  static Registry& registry() { static Registry r; return r; }
+
+  static Slot& local() {
+    thread_local Slot* mine = nullptr;
+    if (!mine) {
+      Registry& r = registry();
+      std::lock_guard<std::mutex> lk(r.mu);
+      r.slots.push_back(std::make_unique<Slot>());
+      mine = r.slots.back().get();
+    }
+    return *mine;
+  }
+};
+
+// The strategy funnel, stage by stage, then the rejection reasons:
+//   [diag] quotes=… rth=… spread1=… size_ok=… raw=… signals=… entries=… fills=…
+//   [reject] rth=… spread=… size=… no_signal=… confirm=… persist=… cooldown=…
+inline void print_funnel(std::ostream& os, const CounterSet& s, const char* indent = "") {
+  const std::uint64_t rth   = s[Ctr::quotes] - s[Ctr::gate_rth];
+  const std::uint64_t sp1   = rth - s[Ctr::gate_spread];
+  const std::uint64_t size  = sp1 - s[Ctr::gate_size];
+  const std::uint64_t raw   = size - s[Ctr::no_signal];
+  os << indent << "[diag] quotes=" << s[Ctr::quotes]
+     << " rth=" << rth
+     << " spread1=" << sp1
+     << " size_ok=" << size
+     << " raw=" << raw
+     << " signals=" << s[Ctr::signals]
+     << " entries=" << s[Ctr::entries]
+     << " fills=" << s[Ctr::fills];
+  if (s[Ctr::quotes_skipped]) os << " skipped=" << s[Ctr::quotes_skipped];
+  os << "\n" << indent << "[reject] rth=" << s[Ctr::gate_rth]
+     << " spread=" << s[Ctr::gate_spread]
+     << " size=" << s[Ctr::gate_size]
+     << " no_signal=" << s[Ctr::no_signal]
+     << " confirm=" << s[Ctr::rej_confirm]
+     << " persist=" << s[Ctr::rej_persist]
+     << " cooldown=" << s[Ctr::rej_cooldown] << "\n";
+}
+
+// loader counters, from CounterRegistry::total()
+inline void print_load_counters(std::ostream& os, const CounterSet& s) {
+  os << "[load] records=" << s[Ctr::load_records]
+     << " kept=" << s[Ctr::load_kept]
+     << " other_instrument=" << s[Ctr::load_instrument]
+     << " outside_rth=" << s[Ctr::load_rth]
+     << " crossed=" << s[Ctr::load_crossed]
+     << " largest_day=" << s.peak(Gauge::load_day_kept);
+  const std::uint64_t inferred = s[Ctr::side_quote] + s[Ctr::side_tick];
+  if (inferred + s[Ctr::side_unknown])
+    os << " side_inferred=" << s[Ctr::side_quote] << "+" << s[Ctr::side_tick]
+       << "/" << inferred + s[Ctr::side_unknown];
+  os << "\n";
+}
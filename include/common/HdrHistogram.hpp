@@ -0,0 +1,139 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <ostream>
+#include <vector>
+
+// High-dynamic-range histogram of non-negative integer values (ns here).
+// Log-linear buckets keep `sig_digits` significant decimal digits of
+// resolution from 1 up to `highest`, in a fixed array: record() is a
+// couple of shifts and an increment. Values above `highest` are clamped.
+class HdrHistogram {
+ public:
+  explicit HdrHistogram(std::int64_t highest = 60'000'000'000LL, int sig_digits = 3) {
+    const std::int64_t largest_single = 2 * static_cast<std::int64_t>(std::pow(10.0, sig_digits));
+    sub_bits = static_cast<int>(std::bit_width(static_cast<std::uint64_t>(largest_single - 1)));
+    half = std::int64_t{1} << (sub_bits - 1);
+    max_value = std::max<std::int64_t>(highest, 2 * half);
+    const int buckets = static_cast<int>(std::bit_width(static_cast<std::uint64_t>(max_value))) - sub_bits + 1;
+    counts.assign(static_cast<std::size_t>((buckets + 1) * half), 0);
+  }
+
+  void record(std::int64_t v, std::uint64_t n = 1) {
+    v = std::clamp<std::int64_t>(v, 0, max_value);
+    counts[index_of(v)] += n;
+    total += n;
+    vmax = std::max(vmax, v);
+    vmin = std::min(vmin, v);
+    sum += double(v) * double(n);
+  }
+
+  void merge(const HdrHistogram& o) {
+    if (o.counts.size() != counts.size() || o.sub_bits != sub_bits) {
+      for (std::size_t i = 0; i < o.counts.size(); ++i)
+        if (o.counts[i]) record(o.value_at(i), o.counts[i]);
+      return;
+    }
+    for (std::size_t i = 0; i < counts.size(); ++i) counts[i] += o.counts[i];
+    total += o.total;
+    sum += o.sum;
+    vmax = std::max(vmax, o.vmax);
+    vmin = std::min(vmin, o.vmin);
+  }
+
+  void reset() {
+    std::fill(counts.begin(), counts.end(), 0);
+    total = 0; sum = 0.0; vmax = 0; vmin = std::numeric_limits<std::int64_t>::max();
+  }
+
+  std::uint64_t count() const { return total; }
+  std::int64_t  max() const { return total ? vmax : 0; }
+  std::int64_t  min() const { return total ? vmin : 0; }
+  double        mean() const { return total ? sum / double(total) : 0.0; }
+
+  // smallest recorded-bucket upper edge with at least p% of samples at or below it
+  std::int64_t percentile(double p) const {
+    if (total == 0) return 0;
+    const auto want = std::max<std::uint64_t>(
+        1, static_cast<std::uint64_t>(std::ceil(std::clamp(p, 0.0, 100.0) / 100.0 * double(total))));
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < counts.size(); ++i) {
+      seen += counts[i];
+      if (seen >= want) return std::min(vmax, highest_equivalent(i));
+    }
+    return vmax;
+  }
+
+  // percentile distribution in HdrHistogram's .hgrm text layout, values
+  // divided by `scale` (1000 = microseconds for ns samples)
+  void write_hgrm(std::ostream& os, double scale = 1000.0, int ticks_per_half = 5) const {
+    char line[128];
+    os << "       Value     Percentile TotalCount 1/(1-Percentile)\n\n";
+    if (total == 0) return;
+    double pct = 0.0;
+    for (;;) {
+      const std::int64_t v = percentile(pct);
+      std::uint64_t at_or_below = 0;
+      for (std::size_t i = 0; i < counts.size() && value_at(i) <= v; ++i) at_or_below += counts[i];
+      if (pct < 100.0) {
+        std::snprintf(line, sizeof(line), "%12.3f %14.12f %10llu %14.2f\n", double(v) / scale,
+                      pct / 100.0, (unsigned long long)at_or_below, 1.0 / (1.0 - pct / 100.0));
+      } else {
+        std::snprintf(line, sizeof(line), "%12.3f %14.12f %10llu\n", double(v) / scale, 1.0,
+                      (unsigned long long)total);
+      }
+      os << line;
+      if (pct >= 100.0 || v >= vmax) break;
+      // ticks_per_half steps per halving of the remaining distance to 100%
+      const double halvings = std::floor(std::log2(100.0 / (100.0 - pct)));
+      pct = std::min(100.0, pct + 100.0 / (std::exp2(halvings + 1.0) * ticks_per_half));
+      if (100.0 - pct < 1e-9) pct = 100.0;
+    }
+    std::snprintf(line, sizeof(line), "#[Mean    = %12.3f, StdDeviation   = %12.3f]\n",
+                  mean() / scale, stddev() / scale);
+    os << line;
+    std::snprintf(line, sizeof(line), "#[Max     = %12.3f, Total count    = %12llu]\n",
+                  double(max()) / scale, (unsigned long long)total);
+    os << line;
+  }
+
+ private:
+  int sub_bits = 0;
+  std::int64_t half = 0;
+  std::int64_t max_value = 0;
+  std::vector<std::uint64_t> counts;
+  std::uint64_t total = 0;
+  double sum = 0.0;
+  std::int64_t vmax = 0, vmin = std::numeric_limits<std::int64_t>::max();
+
+  std::size_t index_of(std::int64_t v) const {
+    const int b = std::max(0, static_cast<int>(std::bit_width(static_cast<std::uint64_t>(v))) - sub_bits);
+    return static_cast<std::size_t>(std::int64_t{b} * half + (v >> b));
+  }
+  std::int64_t value_at(std::size_t i) const {
+    const auto idx = static_cast<std::int64_t>(i);
+    if (idx < 2 * half) return idx;
+    const int b = static_cast<int>(idx / half) - 1;
+    return (idx - std::int64_t{b} * half) << b;
+  }
+  std::int64_t highest_equivalent(std::size_t i) const {
+    const auto idx = static_cast<std::int64_t>(i);
+    const int b = idx < 2 * half ? 0 : static_cast<int>(idx / half) - 1;
+    return value_at(i) + (std::int64_t{1} << b) - 1;
+  }
+  double stddev() const {
+    if (total == 0) return 0.0;
+    const double m = mean();
+    double acc = 0.0;
+    for (std::size_t i = 0; i < counts.size(); ++i)
+      if (counts[i]) {
+        const double d = double(value_at(i)) - m;
+        acc += d * d * double(counts[i]);
+      }
+    return std::sqrt(acc / double(total));
+  }
+};
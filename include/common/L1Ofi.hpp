@@ -0,0 +1,21 @@
+#pragma once
+#include "common/Types.hpp"
+
+// L1 order-flow imbalance of one top-of-book update against the previous
+// top: bid-side flow minus ask-side flow, in contracts. A better bid adds
+// its whole size, a worse one removes the old size, an unchanged price
+// adds the size change (mirrored on the ask). The strategy's OFI signal is
+// an EWMA of this; bars sum it.
+inline double l1_ofi(const QuoteL1& prev, const QuoteL1& q) {
+  double e_b = 0.0;
+  if (q.bid_px > prev.bid_px)      e_b = static_cast<double>(q.bid_sz);
+  else if (q.bid_px < prev.bid_px) e_b = -static_cast<double>(prev.bid_sz);
+  else                             e_b = static_cast<double>(q.bid_sz) - static_cast<double>(prev.bid_sz);
+
+  double e_a = 0.0;
+  if (q.ask_px < prev.ask_px)      e_a = static_cast<double>(q.ask_sz);
+  else if (q.ask_px > prev.ask_px) e_a = -static_cast<double>(prev.ask_sz);
+  else                             e_a = static_cast<double>(prev.ask_sz) - static_cast<double>(q.ask_sz);
+
+  return e_b - e_a;
+}
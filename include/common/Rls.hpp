@@ -0,0 +1,72 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Recursive least squares with exponential forgetting, fixed dimension N.
+// w tracks the weighted least-squares fit of y ~ w.x with weight lambda^age
+// per sample; P is the (scaled) inverse input covariance. One update is a
+// matrix-vector product and a symmetric rank-one downdate over flat,
+// aligned arrays with compile-time trip counts, so the loops unroll and
+// vectorize. A trace cap keeps P from winding up while some input is
+// not excited (e.g. a flat feature through a quiet stretch).
+template <std::size_t N>
+class Rls {
+ public:
+  using Vec = std::array<double, N>;
+
+  explicit Rls(double lambda = 0.999, double delta = 100.0, double max_trace = 1e6)
+      : lam(lambda), inv_lam(1.0 / lambda), p0(delta), max_tr(max_trace) {
+    reset();
+  }
+
+  void reset() {
+    w.fill(0.0);
+    P.fill(0.0);
+    for (std::size_t i = 0; i < N; ++i) P[i * N + i] = p0;
+    n = 0;
+  }
+
+  double predict(const Vec& x) const {
+    double s = 0.0;
+    for (std::size_t i = 0; i < N; ++i) s += w[i] * x[i];
+    return s;
+  }
+
+  // fold in (x, y); returns the a-priori error y - w.x
+  double update(const Vec& x, double y) {
+    alignas(32) Vec Px{};
+    for (std::size_t i = 0; i < N; ++i) {
+      double s = 0.0;
+      for (std::size_t j = 0; j < N; ++j) s += P[i * N + j] * x[j];
+      Px[i] = s;
+    }
+    double xPx = 0.0;
+    for (std::size_t i = 0; i < N; ++i) xPx += x[i] * Px[i];
+    const double g = 1.0 / (lam + xPx);
+    const double err = y - predict(x);
+    for (std::size_t i = 0; i < N; ++i) w[i] += Px[i] * g * err;
+
+    double tr = 0.0;
+    for (std::size_t i = 0; i < N; ++i) {
+      const double gi = Px[i] * g;
+      for (std::size_t j = 0; j < N; ++j) P[i * N + j] = (P[i * N + j] - gi * Px[j]) * inv_lam;
+      tr += P[i * N + i];
+    }
+    if (tr > max_tr) {
+      const double s = max_tr / tr;
+      for (double& v : P) v *= s;
+    }
+    ++n;
+    return err;
+  }
+
+  const Vec& weights() const { return w; }
+  std::uint64_t updates() const { return n; }
+
+ private:
+  double lam, inv_lam, p0, max_tr;
+  alignas(32) Vec w{};
+  alignas(32) std::array<double, N * N> P{};
+  std::uint64_t n = 0;
+};
@@ -0,0 +1,9 @@
+#pragma once
+#include "common/Types.hpp"
+
+// RTH for Oct 2023 (EDT=UTC-4): 09:30–16:00 ET => 13:30–20:00 UTC
+inline bool is_rth_utc(TsNanos ts_ns) {
+  const long long sec = ts_ns / 1'000'000'000LL;
+  const long long sec_in_day = sec % 86400LL;
+  return (sec_in_day >= 48600LL) && (sec_in_day < 72000LL);
+}
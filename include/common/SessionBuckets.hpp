@@ -0,0 +1,119 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+#include <string>
+
+#include "common/Sharpe.hpp"
+#include "common/Types.hpp"
+
+// Count / mean / variance of a stream in one pass (Welford), mergeable.
+struct OnlineStats {
+  std::uint64_t n = 0;
+  std::uint64_t wins = 0;
+  double mean = 0.0, m2 = 0.0, sum = 0.0;
+
+  void add(double x) {
+    ++n;
+    wins += x > 0.0;
+    sum += x;
+    const double d = x - mean;
+    mean += d / double(n);
+    m2 += d * (x - mean);
+  }
+
+  // Chan et al. parallel combination
+  void merge(const OnlineStats& o) {
+    if (o.n == 0) return;
+    if (n == 0) { *this = o; return; }
+    const double nn = double(n + o.n);
+    const double d = o.mean - mean;
+    mean += d * double(o.n) / nn;
+    m2 += o.m2 + d * d * double(n) * double(o.n) / nn;
+    n += o.n;
+    wins += o.wins;
+    sum += o.sum;
+  }
+
+  double var() const { return n > 1 ? m2 / double(n - 1) : 0.0; }
+  double sd() const { return std::sqrt(var()); }
+  double winrate() const { return n ? 100.0 * double(wins) / double(n) : 0.0; }
+  double sharpe() const { return sharpe_annualized(n, mean, var()); }
+};
+
+// Realized trade PnL split by intraday bucket and by weekday, accumulated
+// as fills happen. Buckets are `bucket_s` wide from `origin_s` seconds
+// after UTC midnight (default 13:30 UTC, the Oct-2023 RTH open) and wrap
+// at 24h. Fills are keyed by their realization time; with holds of a few
+// seconds that is the entry window too. Fixed arrays, so merging across
+// days or workers is a loop over two arrays.
+class SessionBuckets {
+ public:
+  static constexpr std::size_t kMaxBuckets = 96;   // 15 min at the finest
+  static constexpr std::int64_t kDay = 86'400;
+
+  explicit SessionBuckets(std::int64_t bucket_s = 1800, std::int64_t origin_s = 48'600)
+      : width(bucket_s < kDay / std::int64_t(kMaxBuckets) ? kDay / std::int64_t(kMaxBuckets) : bucket_s),
+        origin(origin_s) {}
+
+  void add(TsNanos ts, double pnl) {
+    const std::int64_t sec = ts / 1'000'000'000LL;
+    by_bucket[bucket_of(sec)].add(pnl);
+    by_weekday[weekday_of(sec)].add(pnl);
+  }
+
+  void merge(const SessionBuckets& o) {
+    for (std::size_t i = 0; i < kMaxBuckets; ++i) by_bucket[i].merge(o.by_bucket[i]);
+    for (std::size_t i = 0; i < 7; ++i) by_weekday[i].merge(o.by_weekday[i]);
+  }
+
+  std::size_t buckets() const { return static_cast<std::size_t>((kDay + width - 1) / width); }
+  const OnlineStats& bucket(std::size_t i) const { return by_bucket[i]; }
+  const OnlineStats& weekday(std::size_t d) const { return by_weekday[d]; }   // 0 = Sunday
+
+  // "HH:MM" (UTC) at the start of bucket i
+  std::string bucket_label(std::size_t i) const {
+    const std::int64_t s = (origin + std::int64_t(i) * width) % kDay;
+    char buf[8];
+    std::snprintf(buf, sizeof(buf), "%02d:%02d", int(s / 3600), int(s % 3600 / 60));
+    return buf;
+  }
+  static const char* weekday_label(std::size_t d) {
+    static constexpr const char* names[7] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+    return names[d % 7];
+  }
+
+ private:
+  std::int64_t width, origin;
+  std::array<OnlineStats, kMaxBuckets> by_bucket{};
+  std::array<OnlineStats, 7> by_weekday{};
+
+  std::size_t bucket_of(std::int64_t sec) const {
+    const std::int64_t in_day = ((sec - origin) % kDay + kDay) % kDay;
+    return static_cast<std::size_t>(in_day / width);
+  }
+  static std::size_t weekday_of(std::int64_t sec) {
+    const std::int64_t days = sec >= 0 ? sec / kDay : (sec - kDay + 1) / kDay;
+    return static_cast<std::size_t>(((days + 4) % 7 + 7) % 7);   // 1970-01-01 was a Thursday
+  }
+};
+
+// [tod] / [dow] lines for the non-empty buckets (bucket start is UTC)
+inline void print_buckets(std::ostream& os, const SessionBuckets& b) {
+  const auto line = [&](const char* tag, const std::string& label, const OnlineStats& x) {
+    if (x.n == 0) return;
+    os << "[" << tag << "] " << label
+       << " trades=" << x.n
+       << " pnl=$" << x.sum
+       << " mean=$" << x.mean
+       << " sd=$" << x.sd()
+       << " win%=" << x.winrate()
+       << " sharpe=" << x.sharpe() << "\n";
+  };
+  for (std::size_t i = 0; i < b.buckets(); ++i) line("tod", b.bucket_label(i), b.bucket(i));
+  for (std::size_t d = 0; d < 7; ++d) line("dow", SessionBuckets::weekday_label(d), b.weekday(d));
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <numeric>
+#include <vector>
+
+// Per-trade Sharpe, annualized at 60 trades/day over 252 days. Every
+// report (runs, buckets, CV paths) goes through this one formula.
+inline double sharpe_annualized(std::size_t n, double mean, double var) {
+  if (n < 2) return 0.0;
+  const double sd = std::sqrt(std::max(1e-12, var));
+  const double trades_per_year = 60.0 * 252.0;
+  return (mean / sd) * std::sqrt(trades_per_year);
+}
+
+inline double sharpe_annualized(const std::vector<double>& rets) {
+  if (rets.size() < 2) return 0.0;
+  const double mean = std::accumulate(rets.begin(), rets.end(), 0.0) / double(rets.size());
+  double var = 0.0;
+  for (double r : rets) var += (r - mean) * (r - mean);
+  var /= double(rets.size() - 1);
+  return sharpe_annualized(rets.size(), mean, var);
+}
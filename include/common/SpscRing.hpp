@@ -0,0 +1,82 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+// Single-producer / single-consumer lock-free ring. Capacity is rounded up
+// to a power of two; head and tail live on separate cache lines, and each
+// side caches the other's index to avoid touching the shared line per op.
+template <class T>
+class SpscRing {
+  static_assert(std::is_trivially_copyable_v<T>, "SpscRing holds trivially copyable records");
+
+ public:
+  explicit SpscRing(std::size_t capacity) {
+    std::size_t c = 2;
+    while (c < capacity) c <<= 1;
+    mask = c - 1;
+    buf = std::make_unique<T[]>(c);
+  }
+
+  SpscRing(const SpscRing&) = delete;
+  SpscRing& operator=(const SpscRing&) = delete;
+
+  std::size_t capacity() const { return mask + 1; }
+
+  // ---- producer ----
+  bool try_push(const T& v) {
+    const std::size_t t = tail.load(std::memory_order_relaxed);
+    if (t - head_cache > mask) {
+      head_cache = head.load(std::memory_order_acquire);
+      if (t - head_cache > mask) return false;
+    }
+    buf[t & mask] = v;
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  // ---- consumer ----
+  bool try_pop(T& out) {
+    const std::size_t h = head.load(std::memory_order_relaxed);
+    if (h == tail_cache) {
+      tail_cache = tail.load(std::memory_order_acquire);
+      if (h == tail_cache) return false;
+    }
+    out = buf[h & mask];
+    head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+
+  // pointer to the next `n` readable records (may be fewer at the wrap point);
+  // hand them back with consume(n)
+  std::size_t peek(const T*& first, std::size_t max_n) {
+    const std::size_t h = head.load(std::memory_order_relaxed);
+    tail_cache = tail.load(std::memory_order_acquire);
+    std::size_t n = tail_cache - h;
+    const std::size_t to_wrap = capacity() - (h & mask);
+    if (n > to_wrap) n = to_wrap;
+    if (n > max_n)   n = max_n;
+    first = &buf[h & mask];
+    return n;
+  }
+  void consume(std::size_t n) {
+    head.store(head.load(std::memory_order_relaxed) + n, std::memory_order_release);
+  }
+
+  // backlog as seen from the consumer side (exact for the consumer, approximate elsewhere)
+  std::size_t depth() const {
+    return tail.load(std::memory_order_acquire) - head.load(std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr std::size_t kLine = 64;
+
+  alignas(kLine) std::atomic<std::size_t> head{0};  // consumer-owned
+  alignas(kLine) std::size_t tail_cache = 0;        // consumer's copy of tail
+  alignas(kLine) std::atomic<std::size_t> tail{0};  // producer-owned
+  alignas(kLine) std::size_t head_cache = 0;        // producer's copy of head
+  alignas(kLine) std::size_t mask = 0;
+  std::unique_ptr<T[]> buf;
+};
@@ -0,0 +1,78 @@
+#pragma once
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Fixed-size worker pool. Tasks run FIFO; submit() hands back a future.
+class ThreadPool {
+ public:
+  explicit ThreadPool(std::size_t n_threads = std::thread::hardware_concurrency()) {
+    n_threads = std::max<std::size_t>(1, n_threads);
+    workers.reserve(n_threads);
+    for (std::size_t i = 0; i < n_threads; ++i) workers.emplace_back([this] { worker_loop(); });
+  }
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lk(mu);
+      stopping = true;
+    }
+    cv.notify_all();
+    for (auto& w : workers) w.join();
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  std::size_t size() const { return workers.size(); }
+
+  template <class F>
+  auto submit(F&& f) -> std::future<std::invoke_result_t<F>> {
+    using R = std::invoke_result_t<F>;
+    auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+    auto fut = task->get_future();
+    {
+      std::lock_guard<std::mutex> lk(mu);
+      queue.emplace_back([task] { (*task)(); });
+    }
+    cv.notify_one();
+    return fut;
+  }
+
+  // run f(i) for i in [0, n) across the pool and block until all are done
+  template <class F>
+  void parallel_for(std::size_t n, F&& f) {
+    std::vector<std::future<void>> futs;
+    futs.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) futs.push_back(submit([&f, i] { f(i); }));
+    for (auto& fu : futs) fu.get();
+  }
+
+ private:
+  std::vector<std::thread> workers;
+  std::deque<std::function<void()>> queue;
+  std::mutex mu;
+  std::condition_variable cv;
+  bool stopping = false;
+
+  void worker_loop() {
+    for (;;) {
+      std::function<void()> job;
+      {
+        std::unique_lock<std::mutex> lk(mu);
+        cv.wait(lk, [this] { return stopping || !queue.empty(); });
+        if (stopping && queue.empty()) return;
+        job = std::move(queue.front());
+        queue.pop_front();
+      }
+      job();
+    }
+  }
+};
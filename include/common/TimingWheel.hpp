@@ -0,0 +1,202 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Hierarchical timing wheel (6 levels x 256 slots) over an int64 ns clock.
+// insert/cancel are O(1); advance() walks slot boundaries, jumping straight
+// over stretches where the lower levels are empty. Timer nodes live in a
+// pooled vector and are addressed by generation-checked handles, so
+// steady-state use does not allocate.
+//
+// A timer fires on the first advance(now) with now >= its deadline rounded
+// up to the wheel's tick.
+class TimingWheel {
+ public:
+  struct TimerId {
+    std::uint32_t idx = 0;
+    std::uint32_t gen = 0;   // 0 = never armed
+    explicit operator bool() const { return gen != 0; }
+  };
+
+  explicit TimingWheel(std::int64_t tick_ns = 1'000, std::int64_t start_ns = 0)
+      : tick(tick_ns > 0 ? tick_ns : 1), cur(to_tick_floor(start_ns)) {
+    for (auto& lvl : heads) lvl.fill(kNil);
+  }
+
+  TimerId insert(std::int64_t deadline_ns, std::uint32_t kind, std::uint64_t data = 0) {
+    const std::uint32_t i = alloc();
+    Node& n = nodes[i];
+    n.deadline = deadline_ns;
+    n.when     = to_tick_ceil(deadline_ns);
+    n.kind     = kind;
+    n.data     = data;
+    place(i);
+    ++live;
+    return {i, n.gen};
+  }
+
+  // false if the timer already fired or was cancelled
+  bool cancel(TimerId id) {
+    if (!id || id.idx >= nodes.size()) return false;
+    Node& n = nodes[id.idx];
+    if (n.gen != id.gen || !n.linked) return false;
+    unlink(id.idx);
+    release(id.idx);
+    --live;
+    return true;
+  }
+
+  bool pending(TimerId id) const {
+    return id && id.idx < nodes.size() && nodes[id.idx].gen == id.gen && nodes[id.idx].linked;
+  }
+
+  // fire(kind, data, deadline_ns) for every timer due by now_ns, in tick order;
+  // callbacks may insert or cancel timers
+  template <class F>
+  void advance(std::int64_t now_ns, F&& fire) {
+    const std::uint64_t target = to_tick_floor(now_ns);
+    fire_list(due, fire);
+    while (cur < target) {
+      if (live == 0) { cur = target; break; }
+
+      // the lowest non-empty level bounds how far we may jump
+      int L = 0;
+      while (L < kLevels && level_count[L] == 0) ++L;
+      std::uint64_t next;
+      if (L == 0) {
+        next = cur + 1;
+      } else {
+        const int sh = kBits * L;
+        next = ((cur >> sh) + 1) << sh;
+      }
+      if (next > target) { cur = target; break; }
+      cur = next;
+
+      // cascade every level whose window starts here, highest first
+      int top = 0;
+      while (top + 1 < kLevels && (cur & ((std::uint64_t{1} << (kBits * (top + 1))) - 1)) == 0) ++top;
+      for (int l = top; l >= 1; --l) cascade(l);
+
+      fire_list(heads[0][cur & kMask], fire);
+    }
+    fire_list(due, fire);
+  }
+
+  std::size_t size() const { return live; }
+  std::int64_t now_ns() const { return static_cast<std::int64_t>(cur) * tick; }
+
+ private:
+  static constexpr int           kLevels = 6;
+  static constexpr int           kBits   = 8;
+  static constexpr std::uint32_t kSlots  = 1u << kBits;
+  static constexpr std::uint64_t kMask   = kSlots - 1;
+  static constexpr std::uint32_t kNil    = 0xffffffffu;
+
+  struct Node {
+    std::int64_t  deadline = 0;
+    std::uint64_t when = 0;      // deadline in ticks
+    std::uint64_t data = 0;
+    std::uint32_t kind = 0;
+    std::uint32_t gen  = 0;
+    std::uint32_t prev = kNil, next = kNil;
+    std::int16_t  level = -1;        // list the node is on: -1 = due list
+    std::uint16_t slot  = 0;
+    bool          linked = false;
+  };
+
+  std::int64_t tick;
+  std::uint64_t cur;
+  std::array<std::array<std::uint32_t, kSlots>, kLevels> heads{};
+  std::array<std::size_t, kLevels> level_count{};
+  std::uint32_t due = kNil;        // already-expired timers, fired on the next advance
+  std::vector<Node> nodes;
+  std::vector<std::uint32_t> free_list;
+  std::size_t live = 0;
+
+  std::uint64_t to_tick_floor(std::int64_t ns) const {
+    return ns <= 0 ? 0 : static_cast<std::uint64_t>(ns / tick);
+  }
+  std::uint64_t to_tick_ceil(std::int64_t ns) const {
+    return ns <= 0 ? 0 : static_cast<std::uint64_t>((ns + tick - 1) / tick);
+  }
+
+  std::uint32_t alloc() {
+    if (!free_list.empty()) {
+      const std::uint32_t i = free_list.back();
+      free_list.pop_back();
+      return i;
+    }
+    nodes.emplace_back();
+    return static_cast<std::uint32_t>(nodes.size() - 1);
+  }
+  void release(std::uint32_t i) {
+    if (++nodes[i].gen == 0) nodes[i].gen = 1;   // stale handles stop matching
+    free_list.push_back(i);
+  }
+
+  std::uint32_t& head_of(int level, std::uint32_t slot) {
+    return level < 0 ? due : heads[level][slot];
+  }
+
+  void push(int level, std::uint32_t slot, std::uint32_t i) {
+    std::uint32_t& head = head_of(level, slot);
+    Node& n = nodes[i];
+    n.prev = kNil;
+    n.next = head;
+    if (head != kNil) nodes[head].prev = i;
+    head = i;
+    n.level = static_cast<std::int16_t>(level);
+    n.slot  = static_cast<std::uint16_t>(slot);
+    n.linked = true;
+    if (level >= 0) ++level_count[level];
+  }
+
+  void unlink(std::uint32_t i) {
+    Node& n = nodes[i];
+    if (n.prev != kNil) nodes[n.prev].next = n.next;
+    else                head_of(n.level, n.slot) = n.next;
+    if (n.next != kNil) nodes[n.next].prev = n.prev;
+    if (n.level >= 0) --level_count[n.level];
+    n.prev = n.next = kNil;
+    n.linked = false;
+  }
+
+  // cascading=true: the level-0 slot of `cur` is about to fire, so a timer
+  // due exactly now can go there instead of the due list
+  void place(std::uint32_t i, bool cascading = false) {
+    Node& n = nodes[i];
+    if (n.gen == 0) n.gen = 1;
+    if (n.when < cur || (n.when == cur && !cascading)) { push(-1, 0, i); return; }
+    const std::uint64_t diff = n.when ^ cur;
+    int level = 0;
+    while (level + 1 < kLevels && (diff >> (kBits * (level + 1))) != 0) ++level;
+    push(level, static_cast<std::uint32_t>((n.when >> (kBits * level)) & kMask), i);
+  }
+
+  void cascade(int level) {
+    std::uint32_t& head = heads[level][(cur >> (kBits * level)) & kMask];
+    std::uint32_t i = head;
+    head = kNil;
+    while (i != kNil) {
+      const std::uint32_t nx = nodes[i].next;
+      --level_count[level];
+      nodes[i].linked = false;
+      nodes[i].prev = nodes[i].next = kNil;
+      place(i, true);
+      i = nx;
+    }
+  }
+
+  template <class F>
+  void fire_list(std::uint32_t& head, F& fire) {
+    while (head != kNil) {
+      const std::uint32_t i = head;
+      const Node n = nodes[i];
+      unlink(i);
+      release(i);
+      --live;
+      fire(n.kind, n.data, n.deadline);
+    }
+  }
+};
@@ -0,0 +1,22 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include "data/Bars.hpp"
+
+// Columnar on-disk bars, one file per (day, resolution):
+//   <dir>/<YYYYMMDD>.<label>.bars
+// A fixed header, then each OFI_BAR_COLUMNS column as one contiguous
+// native-endian array, in declaration order. Bar studies read these
+// instead of re-decoding tick data; adding a column bumps the version.
+struct BarFileHeader {
+  char          magic[8] = {'O', 'F', 'I', 'B', 'A', 'R', 'S', '1'};
+  std::uint32_t version  = 1;
+  std::uint32_t columns  = 0;
+  std::int64_t  bar_ns   = 0;
+  std::uint64_t rows     = 0;
+};
+
+std::string bar_file_path(const std::string& dir, const std::string& ymd, std::int64_t bar_ns);
+
+bool write_bars(const std::string& path, const BarColumns& bars);   // via <path>.tmp + rename
+bool read_bars(const std::string& path, BarColumns& bars);          // false on a missing or foreign file
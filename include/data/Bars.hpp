@@ -0,0 +1,62 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+#include "common/Types.hpp"
+
+// Time bars over one merged day, kept column-wise. A bar covers
+// [ts, ts + bar_ns) and exists only if some event fell in it. Mid and
+// microprice OHLC come from the bar's quotes (a bar with prints only
+// repeats the previous close, NaN before the first quote); volume is split
+// by aggressor; ofi sums the instantaneous L1 OFI of each quote against
+// the one before it (no EWMA, so bars add up across resolutions).
+
+// name, type
+#define OFI_BAR_COLUMNS(X)    \
+  X(ts,        TsNanos)       \
+  X(mid_o,     double)        \
+  X(mid_h,     double)        \
+  X(mid_l,     double)        \
+  X(mid_c,     double)        \
+  X(micro_o,   double)        \
+  X(micro_h,   double)        \
+  X(micro_l,   double)        \
+  X(micro_c,   double)        \
+  X(buy_vol,   std::int64_t)  \
+  X(sell_vol,  std::int64_t)  \
+  X(other_vol, std::int64_t)  \
+  X(ofi,       double)        \
+  X(quotes,    std::uint32_t) \
+  X(trades,    std::uint32_t)
+
+// one bar as the builder accumulates it
+struct Bar {
+#define OFI_BAR_MEMBER(name, type) type name{};
+  OFI_BAR_COLUMNS(OFI_BAR_MEMBER)
+#undef OFI_BAR_MEMBER
+};
+
+struct BarColumns {
+  std::int64_t bar_ns = 0;
+#define OFI_BAR_VECTOR(name, type) std::vector<type> name;
+  OFI_BAR_COLUMNS(OFI_BAR_VECTOR)
+#undef OFI_BAR_VECTOR
+
+  std::size_t size() const { return ts.size(); }
+  void push_back(const Bar& b);
+  void reserve(std::size_t n);
+  Bar row(std::size_t i) const;
+  std::size_t bytes() const;
+};
+
+// "500ms", "1s", "10s", "1m", "1h" -> ns; 0 if malformed
+std::int64_t parse_bar_size(const std::string& s);
+std::string  bar_size_label(std::int64_t bar_ns);
+
+// All resolutions in one scan: the finest is built from the events, each
+// coarser one is rolled up from the finest (bit-identical to scanning at
+// that size). Every size must be a multiple of the smallest; the result
+// is in the order of `bar_ns`.
+std::vector<BarColumns> build_bars(std::span<const Event> ev, const std::vector<std::int64_t>& bar_ns);
@@ -0,0 +1,80 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "common/Types.hpp"
+
+// One decoded, merged trading day as the replay loops consume it.
+struct DayData {
+  std::vector<Event> events;    // quotes + trades merged by ts
+  QuoteL1 last_quote{};         // for the EOD flatten
+  bool    has_quotes = false;
+
+  std::size_t bytes() const { return sizeof(DayData) + events.capacity() * sizeof(Event); }
+};
+
+enum class EvictPolicy : std::uint8_t {
+  Lru = 0,        // least recently used day goes first
+  CostAware = 1,  // GreedyDual-Size: keep days that were expensive to decode per byte
+};
+
+struct DayCacheStats {
+  std::uint64_t hits = 0, misses = 0, evictions = 0;
+  std::uint64_t bytes_decoded = 0;   // sum of DayData::bytes() over all loads
+  std::int64_t  decode_ns = 0;       // wall time spent in loaders
+  std::size_t   resident_bytes = 0, peak_bytes = 0;
+  double hit_rate() const {
+    const auto n = hits + misses;
+    return n ? double(hits) / double(n) : 0.0;
+  }
+};
+
+// Byte-budgeted cache of decoded days keyed by "YYYYMMDD". Days handed out
+// stay alive while a caller holds the shared_ptr even if evicted meanwhile.
+class DayCache {
+ public:
+  using Loader = std::function<DayData(const std::string& ymd)>;
+
+  DayCache(std::size_t budget_bytes, EvictPolicy policy = EvictPolicy::Lru)
+      : budget(budget_bytes), policy(policy) {}
+
+  // cached day, or loader(ymd) on a miss (concurrent misses on one day load it once)
+  std::shared_ptr<const DayData> get(const std::string& ymd, const Loader& loader);
+
+  bool resident(const std::string& ymd) const;
+
+  // Task order for a pass over `days`: resident days first (most recent
+  // first) so every combo runs on them before anything gets evicted,
+  // then the misses in their original order.
+  std::vector<std::string> schedule(const std::vector<std::string>& days) const;
+
+  DayCacheStats stats() const;
+  std::size_t budget_bytes() const { return budget; }
+
+ private:
+  struct Entry {
+    std::shared_future<std::shared_ptr<const DayData>> day;
+    std::size_t   bytes = 0;
+    bool          ready = false;
+    std::uint64_t last_use = 0;   // LRU clock
+    double        h = 0.0;        // GreedyDual-Size priority
+    double        cost = 0.0;     // decode ns per byte, refreshed on hit
+  };
+
+  std::size_t budget;
+  EvictPolicy policy;
+
+  mutable std::mutex mu;
+  std::unordered_map<std::string, Entry> entries;
+  std::uint64_t clock = 0;
+  double inflation = 0.0;  // GreedyDual "L"
+  DayCacheStats st{};
+
+  void evict_to_budget_locked(const std::string& keep);
+};
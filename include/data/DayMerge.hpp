@@ -0,0 +1,15 @@
+#pragma once
+#include <span>
+#include <vector>
+
+#include "common/Types.hpp"
+#include "data/DayCache.hpp"
+#include "data/DbnReader.hpp"
+
+// One day's quotes and prints as a single time-ordered stream; a quote
+// sorts before a print with the same ts.
+std::vector<Event> merge_streams(std::span<const QuoteL1> qs, std::span<const Trade> ts);
+
+// A decoded day as the replay loops take it: prints the feed left Unknown
+// are signed first (data/TradeSign.hpp, in place in `trades`), then merged.
+DayData make_day(const DayEvents& quotes, DayEvents& trades);
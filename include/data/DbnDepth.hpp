@@ -0,0 +1,12 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+#include "book/DepthBook.hpp"
+
+// MBP-10 day file -> one QuoteL10 per record, with the same instrument/RTH
+// filtering as load_day_from_dbn; records with a crossed or empty top are dropped.
+std::vector<QuoteL10> load_depth_from_dbn(const std::string& path,
+                                          std::optional<std::uint32_t> instrument_filter = std::nullopt,
+                                          bool rth_only = false);
@@ -0,0 +1,14 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include "data/DbnReader.hpp"
+
+// Same filtering as the file loader, but decodes a .dbn / .dbn.zst image that
+// is already in memory (see io/DayPrefetcher.hpp), so the decoder never blocks on I/O.
+DayEvents load_day_from_buffer(std::span<const std::byte> bytes,
+                               const std::string& schema_name,
+                               std::optional<std::uint32_t> instrument_filter = std::nullopt,
+                               bool rth_only = false);
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include "data/DbnReader.hpp"
+
+// Pull-style, chunked version of load_day_from_dbn: same instrument/RTH
+// filtering, but the day is decoded a few thousand records at a time
+// instead of being materialized whole.
+class DbnChunkReader {
+ public:
+  DbnChunkReader(const std::string& path,
+                 const std::string& schema_name,
+                 std::optional<std::uint32_t> instrument_filter = std::nullopt,
+                 bool rth_only = false);
+  ~DbnChunkReader();
+
+  DbnChunkReader(const DbnChunkReader&) = delete;
+  DbnChunkReader& operator=(const DbnChunkReader&) = delete;
+
+  // clears `out` and decodes up to max_records accepted records into it;
+  // false once the file is exhausted and nothing was added
+  bool next(DayEvents& out, std::size_t max_records);
+
+ private:
+  struct Impl;
+  std::unique_ptr<Impl> impl;
+};
@@ -0,0 +1,25 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "common/Types.hpp"
+
+// Seeded synthetic L1 feed for benchmarks that must run without DBN files.
+// Quotes and trades follow a simple queue model: sizes at the touch random-
+// walk, trades deplete the side they hit, and an emptied level moves the
+// book one tick. Arrivals are Poisson at rate_per_s, switching into bursts
+// of burst_mult× intensity so the live path sees realistic backlogs.
+struct SyntheticOptions {
+  std::uint64_t seed       = 1;
+  std::size_t   events     = 1'000'000;
+  double        rate_per_s = 50'000.0;   // mean arrival rate outside bursts
+  double        burst_prob = 0.0005;     // per event, chance a burst starts
+  double        burst_mult = 20.0;       // arrival intensity inside a burst
+  std::size_t   burst_len  = 5'000;      // mean events per burst
+  double        trade_frac = 0.08;
+  double        tick_size  = 0.25;
+  double        start_px   = 4300.0;
+  TsNanos       start_ts   = 1'696'253'400'000'000'000LL;   // 2023-10-02 13:30 UTC (RTH open)
+};
+
+std::vector<Event> synthetic_day(const SyntheticOptions& o = {});
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include "common/Types.hpp"
+
+// Aggressor side for prints the feed left Unknown, from the prevailing L1
+// quote (the last one strictly before the print): above mid is a buy,
+// below a sell. Prints at mid fall back to the tick rule (the direction
+// of the last price change over all prints). Sides the feed supplied are
+// kept; prints neither rule resolves stay Unknown.
+
+struct TradeSignStats {
+  std::uint64_t trades = 0;
+  std::uint64_t feed = 0;         // side given by the feed
+  std::uint64_t by_quote = 0;
+  std::uint64_t by_tick = 0;
+  std::uint64_t unresolved = 0;
+
+  std::uint64_t missing() const { return trades - feed; }
+  double inferred_frac() const {   // of the prints that came in Unknown
+    return missing() ? double(by_quote + by_tick) / double(missing()) : 0.0;
+  }
+  void merge(const TradeSignStats& o) {
+    trades += o.trades; feed += o.feed; by_quote += o.by_quote; by_tick += o.by_tick; unresolved += o.unresolved;
+  }
+};
+
+// Whole day, both streams time-sorted: a galloping merge-join finds each
+// print's prevailing quote, the quote rule runs as a flat pass over the
+// joined arrays, the tick rule as one running scan. Counts also go to the
+// loader counters (common/Counters.hpp).
+TradeSignStats infer_aggressors(std::span<const QuoteL1> quotes, std::span<Trade> trades);
+
+// Same rules for merged streams that never hold a whole day: feed every
+// quote and print in time order, and reset() between days so the quote and
+// tick state starts fresh like infer_aggressors does.
+class TradeSignClassifier {
+ public:
+  void on_quote(const QuoteL1& q) {
+    if (!have_last || q.ts > last.ts) { before = last; have_before = have_last; }
+    last = q;
+    have_last = true;
+  }
+  void classify(Trade& t);
+  void reset() {   // forget the quote and tick state; stats are kept
+    last = before = QuoteL1{};
+    have_last = have_before = have_px = false;
+    prev_px = 0.0;
+    tick = 0;
+  }
+  const TradeSignStats& stats() const { return st; }
+  void flush_counters();   // counts since the last flush into the loader counters
+
+ private:
+  QuoteL1 last{}, before{};          // latest quote, and the latest one with an earlier ts
+  bool    have_last = false, have_before = false;
+  double  prev_px = 0.0;
+  bool    have_px = false;
+  int     tick = 0;
+  TradeSignStats st, flushed;
+};
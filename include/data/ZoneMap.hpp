@@ -0,0 +1,143 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "data/DayCache.hpp"
+#include "strategy/QueueOfi.hpp"
+
+// One minute of a day under one gate configuration. "Fed" quotes are the
+// ones passing the quote gates, i.e. the ones on_quote would see; the OFI
+// and imbalance ranges are over those, with OFI carried across minutes
+// exactly as the strategy carries it.
+struct MinuteZone {
+  std::uint32_t first = 0, last = 0;   // events [first, last)
+  std::uint32_t quotes = 0;
+  std::uint32_t spread1 = 0;           // quotes with a one-tick spread
+  std::uint32_t fed = 0;               // quotes passing the RTH / spread / size gates
+  std::uint32_t gate_rth = 0, gate_spread = 0, gate_size = 0;   // why the others did not
+  std::uint32_t trades = 0;
+  double ofi_min = 0.0, ofi_max = 0.0;
+  double imb_min = 0.0, imb_max = 0.0;
+  QuietStretch end{};                  // what the minute changed, for skip_quiet
+
+  double spread1_frac() const { return quotes ? double(spread1) / double(quotes) : 0.0; }
+
+  // The entry rule needs OFI and imbalance past their thresholds on the
+  // same fed quote; ranges over the minute can only over-approximate that,
+  // so false means no signal under P (true means maybe).
+  bool may_signal(const OfiParams& P) const {
+    if (fed == 0) return false;
+    return (ofi_max > P.theta_ofi && imb_max > P.theta_imb) ||
+           (ofi_min < -P.theta_ofi && imb_min < -P.theta_imb);
+  }
+};
+
+// The parameters a zone map depends on: everything that decides which
+// quotes are fed. Entry thresholds are checked against it afterwards.
+struct ZoneKey {
+  bool   rth_only = true;
+  int    min_spread_ticks = 1;
+  QtyI   min_bid_sz = 0, min_ask_sz = 0;
+  double tick_size = 0.25;
+
+  static ZoneKey of(const OfiParams& P) {
+    return {P.rth_only, P.min_spread_ticks, P.min_bid_sz, P.min_ask_sz, P.tick_size};
+  }
+  auto operator<=>(const ZoneKey&) const = default;
+};
+
+// Per-minute zone map of one decoded day. Built in one pass over the
+// events (OFI only, no decisions), then consulted per candidate: a day
+// with no minute that may signal produces no trades and need not be
+// replayed at all, and an idle strategy can skip_quiet() over minutes that
+// may not signal. Both are exact: results match a full replay.
+class ZoneMap {
+ public:
+  static ZoneMap build(const DayData& day, const ZoneKey& key);
+
+  const std::vector<MinuteZone>& minutes() const { return mins; }
+  bool may_signal(const OfiParams& P) const;
+  std::size_t signal_minutes(const OfiParams& P) const;
+  std::size_t events() const { return n_events; }
+
+ private:
+  std::vector<MinuteZone> mins;
+  std::size_t n_events = 0;
+};
+
+struct ZoneStats {
+  std::atomic<std::uint64_t> maps_built{0};
+  std::atomic<std::int64_t>  build_ns{0};
+  std::atomic<std::uint64_t> day_runs{0}, days_pruned{0};       // (candidate, day) runs
+  std::atomic<std::uint64_t> minutes{0}, minutes_skipped{0};    // within replayed days
+  std::atomic<std::uint64_t> days_not_loaded{0};                // pruned for every candidate, never decoded
+};
+
+// Zone maps by (day, gate key), shared by every candidate and kept for the
+// whole run, so later passes (CMA-ES generations, validation) can prune a
+// day before the cache has to decode it. Thread-safe.
+class ZoneIndex {
+ public:
+  // map for this day and P's gates, built from `day` on first use
+  std::shared_ptr<const ZoneMap> get(const std::string& ymd, const DayData& day, const OfiParams& P);
+  // map if already built, else nullptr
+  std::shared_ptr<const ZoneMap> find(const std::string& ymd, const OfiParams& P) const;
+
+  // true only if every candidate's map for this day is known and none may signal
+  bool prunable(const std::string& ymd, const std::vector<OfiParams>& cands) const;
+
+  ZoneStats& stats() { return st; }
+
+ private:
+  mutable std::mutex mu;
+  std::map<std::pair<std::string, ZoneKey>, std::shared_ptr<const ZoneMap>> maps;
+  ZoneStats st;
+};
+
+// The counters a replay of a minute that cannot signal would have added:
+// every fed quote is a no_signal, and no decision gets further.
+inline void count_skipped(CounterSet& c, const MinuteZone& m) {
+  c.add(Ctr::quotes, m.quotes);
+  c.add(Ctr::gate_rth, m.gate_rth);
+  c.add(Ctr::gate_spread, m.gate_spread);
+  c.add(Ctr::gate_size, m.gate_size);
+  c.add(Ctr::no_signal, m.fed);
+  c.add(Ctr::trades, m.trades);
+  c.add(Ctr::quotes_skipped, m.quotes);
+}
+
+// run_one_day's replay loop with zone-map skipping: events of each minute go
+// through on_events unless the strategy is idle and the minute cannot signal.
+// `on_fill` gets every realized Fill.
+template <class F>
+void replay_with_zones(QueueOfiStrategy& strat, const DayData& day, const ZoneMap& zm,
+                       const OfiParams& P, ZoneStats& st, F&& on_fill) {
+  std::array<Fill, 1024> fills;
+  std::uint64_t skipped = 0;
+  for (const MinuteZone& m : zm.minutes()) {
+    if (strat.idle() && !m.may_signal(P)) {
+      strat.skip_quiet(m.end);
+      count_skipped(strat.counters(), m);
+      ++skipped;
+      continue;
+    }
+    std::span<const Event> rest{day.events.data() + m.first, m.last - m.first};
+    while (!rest.empty()) {
+      const BatchResult br = strat.on_events(rest, fills);
+      for (std::size_t k = 0; k < br.fills; ++k) on_fill(fills[k]);
+      rest = rest.subspan(br.consumed);
+    }
+  }
+  st.minutes += zm.minutes().size();
+  st.minutes_skipped += skipped;
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Async read-ahead of whole day files (.dbn.zst) into memory.
+//
+// The consumer walks `paths` in order: acquire(i) blocks until file i is
+// resident, release(i) hands its slot back so the reader can start on
+// file i+depth. Reads are issued in large chunks through io_uring into
+// registered slot buffers when built with OFI_HAVE_IO_URING and the kernel
+// allows it; otherwise a small thread pool does the same with pread().
+
+struct PrefetchOptions {
+  std::size_t depth            = 4;          // files resident/in flight ahead of the consumer
+  std::size_t slot_bytes       = 256u << 20; // registered buffer per slot, at most (sized to the largest queued file; larger files use a heap buffer)
+  std::size_t chunk_bytes      = 4u << 20;   // size of a single async read
+  std::size_t fallback_threads = 4;          // pread workers when io_uring is unavailable
+  bool        use_io_uring     = true;
+};
+
+struct PrefetchStats {
+  std::uint64_t files       = 0;
+  std::uint64_t bytes_read  = 0;
+  std::uint64_t failed      = 0;  // missing / unreadable files
+  std::int64_t  stall_ns    = 0;  // consumer time spent blocked in acquire()
+};
+
+class DayPrefetcher {
+ public:
+  explicit DayPrefetcher(std::vector<std::string> paths, PrefetchOptions opt = {});
+  ~DayPrefetcher();
+
+  DayPrefetcher(const DayPrefetcher&) = delete;
+  DayPrefetcher& operator=(const DayPrefetcher&) = delete;
+
+  // bytes of file i (empty if the file is missing or the read failed);
+  // valid until release(i)
+  std::span<const std::byte> acquire(std::size_t i);
+  void release(std::size_t i);
+
+  std::size_t size() const { return paths.size(); }
+  const char* backend() const;
+  PrefetchStats stats() const;
+
+ private:
+  enum class SlotState : std::uint8_t { Free, Loading, Ready, Failed };
+
+  struct Slot {
+    std::unique_ptr<std::byte[]> fixed;   // registered with io_uring, never reallocated
+    std::size_t   fixed_bytes = 0;
+    std::vector<std::byte> overflow;  // for files larger than slot_bytes
+    std::byte*    data  = nullptr;
+    std::size_t   bytes = 0;
+    std::size_t   file  = 0;
+    int           fd    = -1;
+    SlotState     state = SlotState::Free;
+    std::atomic<std::size_t> chunks_left{0};
+    std::atomic<bool>        io_error{false};
+    std::vector<std::uint32_t> chunk_done;  // io_uring short-read bookkeeping
+  };
+
+  std::vector<std::string> paths;
+  PrefetchOptions opt;
+  std::vector<Slot> slots;
+
+  mutable std::mutex mu;
+  std::condition_variable cv_slot;   // reader waits for a free slot
+  std::condition_variable cv_ready;  // consumer waits for its file
+  std::size_t next_issue = 0;
+  bool stopping = false;
+  bool uring_active = false;
+
+  PrefetchStats st{};
+  std::thread reader;
+
+  void* ring = nullptr;  // io_uring*, opaque so liburing stays out of this header
+
+  bool open_slot(Slot& s, std::size_t file);  // open + size + pick buffer
+  void finish_slot(Slot& s);                  // close fd, publish Ready/Failed
+  void run_uring();
+  void run_pool();
+};
@@ -0,0 +1,136 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "common/Types.hpp"
+#include "live/FeedMsg.hpp"
+#include "strategy/QueueOfi.hpp"
+
+// L1 book as of a feed sequence number.
+struct BookSnapshot {
+  std::uint64_t seq = 0;   // last feed message reflected in q
+  QuoteL1       q{};
+};
+
+// Where a recovering engine gets its snapshot. request() starts a fetch,
+// poll() hands back a snapshot once one is available. Neither may block:
+// poll() runs on the engine thread once per batch.
+class SnapshotSource {
+ public:
+  virtual ~SnapshotSource() = default;
+  virtual void request() = 0;
+  virtual std::optional<BookSnapshot> poll() = 0;
+};
+
+// Snapshot file: 8-byte magic "OFISNAP1", then fixed-size BookSnapshot
+// records appended in sequence order.
+class SnapshotWriter {
+ public:
+  SnapshotWriter() = default;
+  ~SnapshotWriter() { close(); }
+  SnapshotWriter(const SnapshotWriter&) = delete;
+  SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+  bool open(const std::string& path);
+  void append(const BookSnapshot& s);   // flushed, so a reader sees whole records
+  void close();
+
+ private:
+  std::FILE* f = nullptr;
+};
+
+// Reads the newest record of a snapshot file on a background thread.
+class FileSnapshotSource : public SnapshotSource {
+ public:
+  explicit FileSnapshotSource(std::string path) : path(std::move(path)) {}
+  void request() override;
+  std::optional<BookSnapshot> poll() override;
+
+  static std::optional<BookSnapshot> read_latest(const std::string& path);
+
+ private:
+  std::string path;
+  std::future<std::optional<BookSnapshot>> pending;
+};
+
+// Stand-in for an exchange snapshot channel: the feed side publishes the
+// current book every so often; poll() takes the latest one without ever
+// waiting on the publisher (a busy lock just means "try next batch").
+class ChannelSnapshotSource : public SnapshotSource {
+ public:
+  void publish(const BookSnapshot& s);
+  void request() override {}
+  std::optional<BookSnapshot> poll() override;
+
+ private:
+  std::mutex mu;
+  std::optional<BookSnapshot> latest;
+};
+
+struct RecoveryStats {
+  std::uint64_t recoveries = 0;      // completed
+  std::uint64_t restarts = 0;        // another gap hit while replaying the buffer
+  std::uint64_t buffered = 0;        // incrementals queued while recovering
+  std::uint64_t replayed = 0;        // ... and applied over a snapshot
+  std::uint64_t stale = 0;           // already covered by the snapshot, dropped
+  std::uint64_t snapshots_rejected = 0;   // older than the buffered incrementals
+  std::uint64_t abandoned = 0;       // gave up: timeout, buffer cap or shutdown
+  std::size_t   max_buffered = 0;
+  std::int64_t  recovery_ns = 0, max_recovery_ns = 0;   // begin() -> book live again
+  std::int64_t  snapshot_wait_ns = 0;                   // begin() -> snapshot applied
+
+  double mean_recovery_ns() const { return recoveries ? double(recovery_ns) / double(recoveries) : 0.0; }
+};
+
+// Snapshot + incremental recovery of the strategy's L1 book. After begin(),
+// incoming messages are buffered instead of traded on; each step() either
+// waits for the snapshot or, once it has one, loads it into the strategy
+// and hands back at most `max_replay` buffered messages to apply without
+// decisions. The caller never spends more than one batch per step.
+// A recovery that outlives `timeout_ns` or would buffer more than
+// `max_buffered` messages is abandoned: the buffer is dropped and the
+// feed resumes after the newest buffered seq (an L1 quote carries the
+// whole top, so the book is whole again at the next quote; the caller
+// loads that quote as the snapshot, see abandoned()).
+class BookRecovery {
+ public:
+  BookRecovery(SnapshotSource& src, std::int64_t timeout_ns, std::size_t max_buffered)
+      : src(src), timeout_ns(timeout_ns), max_buf(max_buffered) {}
+
+  bool active() const { return on; }
+  void begin(std::int64_t now_ns);
+  void buffer(const FeedMsg* m, std::size_t n);
+
+  // messages to replay now (contiguous after the snapshot); empty while waiting
+  std::span<const FeedMsg> step(QueueOfiStrategy& strat, std::size_t max_replay);
+  // after the caller applied the span from step(); ends recovery once caught up
+  void replayed(std::size_t n, std::int64_t now_ns);
+  void abandon();   // stop recovering now; next_seq() is where the feed resumes
+  bool abandoned() const { return gave_up; }   // the last episode ended without a snapshot
+
+  std::uint64_t next_seq() const { return expect; }   // first live seq after recovery
+  const RecoveryStats& stats() const { return st; }
+
+ private:
+  SnapshotSource& src;
+  std::int64_t timeout_ns;
+  std::size_t max_buf;
+  bool on = false;
+  bool have_snap = false;
+  bool gave_up = false;
+  std::int64_t t_begin = 0;
+  std::uint64_t expect = 0;
+  std::vector<FeedMsg> buf;
+  std::size_t head = 0;
+  std::uint64_t last_seq = 0;   // newest seq buffered this episode
+  RecoveryStats st{};
+
+  void restart();
+};
@@ -0,0 +1,11 @@
+#pragma once
+#include <cstdint>
+#include "common/Types.hpp"
+
+// One market-data record as the feed handler hands it to the engine.
+struct FeedMsg {
+  Event         ev{};
+  std::int64_t  recv_ns  = 0;   // TscClock::now_ns() at enqueue
+  std::uint64_t seq      = 0;   // feed sequence number (0 = unsequenced, no gap checks)
+  std::int64_t  sched_ns = 0;   // when the feed was due to deliver it (0 = recv_ns)
+};
@@ -0,0 +1,145 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+#include "common/HdrHistogram.hpp"
+#include "common/SpscRing.hpp"
+#include "common/Types.hpp"
+#include "live/BookRecovery.hpp"
+#include "live/FeedMsg.hpp"
+#include "order/OrderEntry.hpp"
+#include "strategy/QueueOfi.hpp"
+#include "telemetry/ShmTelemetry.hpp"
+
+// Optional latency capture for benchmarks: quote -> decision and quote ->
+// simulated order send (a decision that changed the position). Intervals
+// measured from sched_ns include any time the message spent waiting to be
+// enqueued, so they are free of coordinated omission; the *_naive ones
+// start at recv_ns, as a feed-side timestamp would.
+struct LatencyProbe {
+  HdrHistogram decide, send;
+  HdrHistogram decide_naive, send_naive;
+  std::uint64_t warmup_seq = 0;   // messages with seq <= this are not recorded
+};
+
+struct LiveOptions {
+  std::size_t ring_capacity  = 1u << 16;
+  std::size_t conflate_enter = 4096;   // backlog (records) that switches to conflated mode
+  std::size_t conflate_exit  = 256;    // backlog that switches back (hysteresis)
+  std::size_t max_batch      = 4096;   // records taken from the ring per poll
+  bool recover_on_start      = false;  // joined mid-session: rebuild the book before trading
+  std::int64_t recovery_timeout_ns = 2'000'000'000LL;   // give up on a snapshot after this
+  std::size_t  recovery_max_buffer = 1u << 20;          // ... or once this many messages wait
+};
+
+struct LiveStats {
+  std::uint64_t events = 0, quotes = 0, trades = 0, gated_quotes = 0;
+  std::uint64_t decisions = 0, signals = 0, fills = 0;
+  std::uint64_t seq_gaps = 0, stale_msgs = 0;   // sequence breaks / duplicates skipped
+  std::uint64_t conflation_episodes = 0;
+  std::uint64_t conflated_quotes = 0;   // gated quotes folded into OFI without their own decision
+  std::int64_t  conflated_ns = 0;       // wall time spent in conflated mode
+  std::size_t   max_depth = 0;
+  std::int64_t  max_behind_ns = 0;      // now - recv_ns of the oldest record processed
+  double        sum_behind_ns = 0.0;    // per processed batch, for the mean
+  std::uint64_t batches = 0;
+  std::array<std::uint64_t, 64> behind_log2{};   // batches by floor(log2(behind_ns))
+  double        pnl = 0.0;
+
+  double mean_behind_ns() const { return batches ? sum_behind_ns / double(batches) : 0.0; }
+  // upper edge of the log2 bucket holding quantile q (within 2x), capped at the max
+  std::int64_t behind_quantile_ns(double q) const {
+    const double want = q * double(batches);
+    double seen = 0.0;
+    for (std::size_t b = 0; b < behind_log2.size(); ++b) {
+      seen += double(behind_log2[b]);
+      if (batches && seen >= want)
+        return std::min<std::int64_t>(max_behind_ns, (std::int64_t{2} << b) - 1);
+    }
+    return max_behind_ns;
+  }
+};
+
+// Consumer side of the live path. The feed thread pushes FeedMsg into
+// ring(); poll() drains it. While the backlog stays above conflate_enter
+// the engine stops deciding on every quote: each drained batch folds all
+// gated quotes into OFI/L1 state (exactly, quote by quote) and runs one
+// decision on the latest book. Below conflate_exit it goes back to
+// per-quote decisions.
+class LiveEngine {
+ public:
+  explicit LiveEngine(const OfiParams& P, LiveOptions opt = {});
+
+  SpscRing<FeedMsg>& ring() { return feed; }
+
+  std::size_t poll();                        // records processed (0 if the ring was empty)
+  void idle();                               // advance strategy timers on the TSC clock
+  void run(const std::atomic<bool>& stop);   // poll until stop is set and the ring is drained
+  void flatten();                            // close any open position at the last quote
+
+  // publish counters into a telemetry slot at most once per period_ns
+  void attach_telemetry(TelemetryPublisher* pub, std::int64_t period_ns = 100'000'000) {
+    tlm = pub;
+    tlm_period_ns = period_ns;
+  }
+  void publish_telemetry(std::int64_t now_ns);
+
+  void attach_probe(LatencyProbe* p) { probe = p; }
+
+  // every position change is handed to `sink` (e.g. a PositionRouter) as it happens
+  void attach_orders(OrderSink* sink) { orders = sink; }
+
+  // Rebuild the book from `src` on sequence gaps (and on the first message
+  // if recover_on_start). Without it a gap is counted and skipped over.
+  void attach_recovery(SnapshotSource& src) {
+    recovery.emplace(src, opt.recovery_timeout_ns, opt.recovery_max_buffer);
+  }
+  bool recovering() const { return recovery && recovery->active(); }
+  const RecoveryStats* recovery_stats() const { return recovery ? &recovery->stats() : nullptr; }
+
+  bool conflating() const { return conflate; }
+  const LiveStats& stats() const { return st; }
+  const QueueOfiStrategy& strategy() const { return strat; }
+
+ private:
+  LiveOptions opt;
+  QueueOfiStrategy strat;
+  SpscRing<FeedMsg> feed;
+  LiveStats st{};
+
+  bool         conflate = false;
+  std::int64_t conflate_since_ns = 0;
+  QuoteL1      last_quote{};
+  bool         have_quote = false;
+  TsNanos      last_ev_ts = 0;       // exchange time of the last record ...
+  std::int64_t last_recv_ns = 0;     // ... and when it was received
+
+  TelemetryPublisher* tlm = nullptr;
+  std::int64_t tlm_period_ns = 0;
+  std::int64_t tlm_last_ns = 0;
+
+  std::uint64_t next_seq = 0;        // expected feed seq (0 = nothing seen yet)
+  std::optional<BookRecovery> recovery;
+  bool reload_book = false;          // recovery abandoned: the next quote is the snapshot
+
+  LatencyProbe* probe = nullptr;
+  OrderSink* orders = nullptr;
+  int routed_lots = 0;               // signed position the sink was last told about
+  std::vector<const FeedMsg*> folded_msgs;   // conflated batch, for the probe
+
+  void record_latency(const FeedMsg& m, std::int64_t decided_ns, std::int64_t sent_ns, bool sent);
+
+  void process(const FeedMsg* m, std::size_t n);
+  std::size_t drive_recovery();
+  void end_recovery();
+  void replay_passive(const FeedMsg& m);
+  void process_each(const FeedMsg* m, std::size_t n);
+  void process_conflated(const FeedMsg* m, std::size_t n);
+  void route(TsNanos ts);
+  void book_fill(double realized, TsNanos ts, int closed_side);
+  void book_timer(TsNanos ts);
+};
@@ -0,0 +1,112 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+#include "common/Clock.hpp"
+#include "common/SpscRing.hpp"
+
+// Asynchronous binary logger for hot paths.
+//
+// A call site writes one fixed 64-byte record (format id, TSC stamp, up to
+// six raw 8-byte args) into its thread's SPSC ring and returns; nothing is
+// formatted on the caller's thread. A background thread drains all rings
+// into a binary file, and `binlog_decode` renders it later using the
+// format table stored in the file header. If a ring is full the record is
+// dropped and counted rather than blocking the caller.
+
+// id, format ("{}" per argument)
+#define OFI_BINLOG_FORMATS(X)                                                   \
+  X(Signal,      "signal ts={} side={} ofi={} imb={}")                          \
+  X(Fill,        "fill ts={} pnl={} side={}")                                   \
+  X(TimerExit,   "timer_exit ts={} pnl={}")                                     \
+  X(Conflate,    "conflate on={} depth={}")                                     \
+  X(DayDone,     "day_done trades={} pnl={}")
+
+enum class LogFmt : std::uint16_t {
+#define OFI_BINLOG_ENUM(id, fmt) id,
+  OFI_BINLOG_FORMATS(OFI_BINLOG_ENUM)
+#undef OFI_BINLOG_ENUM
+  Count
+};
+
+enum class LogArg : std::uint8_t { I64 = 0, U64 = 1, F64 = 2 };
+
+struct alignas(64) LogRecord {
+  std::uint64_t tsc = 0;
+  std::uint16_t fmt = 0;
+  std::uint8_t  nargs = 0;
+  std::uint8_t  thread = 0;
+  std::uint32_t types = 0;       // 2 bits per arg (LogArg)
+  std::uint64_t args[6] = {};
+};
+static_assert(sizeof(LogRecord) == 64, "one record per cache line");
+
+class BinLog {
+ public:
+  static constexpr std::size_t kRingRecords = 1u << 14;   // per thread
+
+  // open `path` and start the writer thread; false if the file can't be opened
+  static bool start(const std::string& path);
+  // drain every ring, close the file, join the writer
+  static void stop();
+
+  static bool enabled() { return on.load(std::memory_order_relaxed); }
+  static std::uint64_t dropped() { return n_dropped.load(std::memory_order_relaxed); }
+  static std::uint64_t written() { return n_written.load(std::memory_order_relaxed); }
+
+  static const char* format_of(LogFmt f);
+  static void stats_add_written(std::size_t n);   // writer thread
+
+  template <class... A>
+  static void log(LogFmt f, A... a) {
+    static_assert(sizeof...(A) <= 6, "at most 6 args per record");
+    if (!enabled()) return;
+    SpscRing<LogRecord>* r = ring();
+    if (!r) return;
+
+    LogRecord rec;
+    rec.tsc    = TscClock::ticks();
+    rec.fmt    = static_cast<std::uint16_t>(f);
+    rec.nargs  = static_cast<std::uint8_t>(sizeof...(A));
+    rec.thread = thread_no;
+    std::size_t k = 0;
+    (pack(rec, k++, a), ...);
+    if (!r->try_push(rec)) n_dropped.fetch_add(1, std::memory_order_relaxed);
+  }
+
+ private:
+  static inline std::atomic<bool> on{false};
+  static inline std::atomic<std::uint64_t> n_dropped{0}, n_written{0};
+  static inline thread_local SpscRing<LogRecord>* tl_ring = nullptr;
+  static inline thread_local std::uint8_t thread_no = 0;
+
+  static SpscRing<LogRecord>* ring() { return tl_ring ? tl_ring : register_thread(); }
+  static SpscRing<LogRecord>* register_thread();   // slow path, once per thread
+
+  template <class T>
+  static void pack(LogRecord& rec, std::size_t k, T v) {
+    LogArg t;
+    std::uint64_t w;
+    if constexpr (std::is_floating_point_v<T>) {
+      const double d = static_cast<double>(v);
+      std::memcpy(&w, &d, sizeof w);
+      t = LogArg::F64;
+    } else if constexpr (std::is_enum_v<T>) {
+      w = static_cast<std::uint64_t>(static_cast<std::int64_t>(v));
+      t = LogArg::I64;
+    } else if constexpr (std::is_signed_v<T>) {
+      w = static_cast<std::uint64_t>(static_cast<std::int64_t>(v));
+      t = LogArg::I64;
+    } else {
+      w = static_cast<std::uint64_t>(v);
+      t = LogArg::U64;
+    }
+    rec.args[k] = w;
+    rec.types |= static_cast<std::uint32_t>(t) << (2 * k);
+  }
+};
+
+#define OFI_LOG(fmt_id, ...) BinLog::log(LogFmt::fmt_id, __VA_ARGS__)
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+struct CmaEsOptions {
+  std::size_t   popsize = 0;       // 0 = 4 + 3 ln(n)
+  double        sigma0  = 0.3;     // initial step, in units of the [0,1] box
+  double        tol_x   = 1e-4;    // stop once every axis' step is below this
+  std::uint64_t seed    = 1;
+};
+
+// (mu/mu_w, lambda)-CMA-ES, minimizing over the unit box [0,1]^n. Callers
+// map the box onto their own parameter ranges. Ask/tell: ask() draws a
+// population (reflected back into the box), the caller scores every
+// candidate however it likes — in parallel, say — and tell() updates the
+// mean, step size and covariance. The dimension is small (a handful of
+// strategy knobs), so the covariance is re-decomposed every generation.
+class CmaEs {
+ public:
+  CmaEs(std::vector<double> x0, CmaEsOptions opt = {});
+
+  std::size_t dim() const { return n; }
+  std::size_t popsize() const { return lambda; }
+
+  const std::vector<std::vector<double>>& ask();
+  void tell(const std::vector<double>& fitness);   // one per candidate from ask(), lower is better
+
+  bool converged() const;
+  std::size_t generation() const { return gen; }
+  std::size_t evaluations() const { return evals; }
+  double step() const { return sigma; }
+
+  const std::vector<double>& mean() const { return m; }
+  const std::vector<double>& best_x() const { return bx; }
+  double best_f() const { return bf; }
+
+ private:
+  std::size_t n, lambda, mu;
+  std::vector<double> w;
+  double mueff, cc, cs, c1, cmu, damps, chi_n;
+
+  std::vector<double> m, ps, pc;
+  std::vector<double> C, B, D;    // covariance, its eigenvectors (columns) and sqrt eigenvalues
+  double sigma;
+  double tol_x;
+
+  std::vector<std::vector<double>> xs, ys;   // candidates and their steps (x - m) / sigma
+  std::vector<double> bx;
+  double bf;
+  std::size_t gen = 0, evals = 0;
+  std::mt19937_64 rng;
+  std::normal_distribution<double> gauss{0.0, 1.0};
+
+  void decompose();
+};
@@ -0,0 +1,99 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+// Non-dominated set under K objectives, all maximized (negate the ones to
+// minimize). Workers insert() results as they finish; the set stays sorted
+// by the first objective (descending), so a newcomer is only checked
+// against the points ahead of it for being dominated, and only against the
+// points behind it for dominating them.
+template <std::size_t K, class Payload>
+class ParetoFront {
+ public:
+  using Objectives = std::array<double, K>;
+  struct Entry {
+    Objectives f{};
+    Payload    p{};
+  };
+
+  // a >= b everywhere and > somewhere
+  static bool dominates(const Objectives& a, const Objectives& b) {
+    bool strict = false;
+    for (std::size_t k = 0; k < K; ++k) {
+      if (a[k] < b[k]) return false;
+      strict |= a[k] > b[k];
+    }
+    return strict;
+  }
+
+  // false if f is dominated by (or equal to) a point already on the front
+  bool insert(const Objectives& f, const Payload& p) {
+    std::lock_guard<std::mutex> lk(mu);
+    ++n_inserted;
+    const auto ahead_end = std::partition_point(pts.begin(), pts.end(),
+                                                [&](const Entry& e) { return e.f[0] >= f[0]; });
+    for (auto it = pts.begin(); it != ahead_end; ++it)
+      if (it->f == f || dominates(it->f, f)) { ++n_rejected; return false; }
+
+    const auto behind = std::partition_point(pts.begin(), ahead_end,
+                                             [&](const Entry& e) { return e.f[0] > f[0]; });
+    const auto kept_end = std::remove_if(behind, pts.end(), [&](const Entry& e) { return dominates(f, e.f); });
+    n_evicted += static_cast<std::uint64_t>(pts.end() - kept_end);
+    pts.erase(kept_end, pts.end());
+    // ties on f[0] are mutually non-dominated here; keep arrival order among them
+    const auto at = std::partition_point(pts.begin(), pts.end(),
+                                         [&](const Entry& e) { return e.f[0] >= f[0]; });
+    pts.insert(at, Entry{f, p});
+    return true;
+  }
+
+  std::vector<Entry> snapshot() const {
+    std::lock_guard<std::mutex> lk(mu);
+    return pts;
+  }
+  std::size_t size() const {
+    std::lock_guard<std::mutex> lk(mu);
+    return pts.size();
+  }
+
+  // Knee: the point closest to the ideal one once each objective is
+  // scaled to [0, 1] over the front (the best compromise, with no weights
+  // to pick).
+  std::optional<Entry> knee() const {
+    std::lock_guard<std::mutex> lk(mu);
+    if (pts.empty()) return std::nullopt;
+    Objectives lo, hi;
+    lo.fill(std::numeric_limits<double>::infinity());
+    hi.fill(-std::numeric_limits<double>::infinity());
+    for (const Entry& e : pts)
+      for (std::size_t k = 0; k < K; ++k) { lo[k] = std::min(lo[k], e.f[k]); hi[k] = std::max(hi[k], e.f[k]); }
+    const Entry* best = &pts.front();
+    double best_d = std::numeric_limits<double>::infinity();
+    for (const Entry& e : pts) {
+      double d = 0.0;
+      for (std::size_t k = 0; k < K; ++k) {
+        const double span = hi[k] - lo[k];
+        const double gap = span > 0.0 ? (hi[k] - e.f[k]) / span : 0.0;
+        d += gap * gap;
+      }
+      if (d < best_d) { best_d = d; best = &e; }
+    }
+    return *best;
+  }
+
+  std::uint64_t inserted() const { std::lock_guard<std::mutex> lk(mu); return n_inserted; }
+  std::uint64_t rejected() const { std::lock_guard<std::mutex> lk(mu); return n_rejected; }
+  std::uint64_t evicted()  const { std::lock_guard<std::mutex> lk(mu); return n_evicted; }
+
+ private:
+  mutable std::mutex mu;
+  std::vector<Entry> pts;   // sorted by f[0], descending
+  std::uint64_t n_inserted = 0, n_rejected = 0, n_evicted = 0;
+};
@@ -0,0 +1,31 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+struct CvOptions {
+  std::size_t groups      = 6;   // contiguous day groups
+  std::size_t test_groups = 2;   // groups held out per split
+  std::size_t embargo     = 1;   // train days dropped on each side of a test group
+};
+
+// One train/test split over day indices [0, n_days), both ascending.
+struct CvSplit {
+  std::vector<std::size_t> test_groups;
+  std::vector<std::size_t> train, test;
+};
+
+// Combinatorial purged cross-validation: the days are cut into `groups`
+// contiguous groups and every choice of `test_groups` of them is one split.
+// Train days within `embargo` days of any test day are purged, so nothing
+// that straddles a boundary (an overnight position, a regime that leaks
+// into the next session) is seen on both sides.
+std::vector<CvSplit> cpcv_splits(std::size_t n_days, const CvOptions& o);
+
+// group index of each day for the same cut
+std::vector<std::size_t> cv_groups_of(std::size_t n_days, std::size_t groups);
+
+// Backtest paths through the splits: every group is tested in
+// C(groups-1, test_groups-1) splits; path p takes, for each group, the
+// p-th of them. Each path is a full out-of-sample pass over all days.
+// Returns path -> group -> split index.
+std::vector<std::vector<std::size_t>> cpcv_paths(const std::vector<CvSplit>& splits, std::size_t groups);
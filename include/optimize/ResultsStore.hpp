@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <cstdio>
+#include <string>
+
+#include "common/SessionBuckets.hpp"
+#include "strategy/QueueOfi.hpp"
+
+// Optimizer results as long-format CSV, one row per (candidate, scope,
+// bucket): scope "all" is the whole run, "tod" an intraday bucket (label =
+// UTC start), "dow" a weekday. Appends to an existing file, so several
+// sweeps can be compared (or a trading window picked) without re-running.
+//
+// run,candidate,theta_ofi,theta_imb,slip,max_hold_s,cooldown_ms,min_bid_sz,
+// min_ask_sz,scope,bucket,trades,pnl,mean,sd,win_pct,sharpe
+class ResultsStore {
+ public:
+  ResultsStore() = default;
+  ~ResultsStore() { close(); }
+  ResultsStore(const ResultsStore&) = delete;
+  ResultsStore& operator=(const ResultsStore&) = delete;
+
+  bool open(const std::string& path);   // header only if the file is new or empty
+  void close();
+  bool is_open() const { return f != nullptr; }
+
+  void add(const std::string& run, std::size_t candidate, const OfiParams& P,
+           const char* scope, const std::string& bucket, const OnlineStats& s);
+  // "all" row plus every non-empty tod / dow bucket
+  void add_all(const std::string& run, std::size_t candidate, const OfiParams& P, const SessionBuckets& b);
+
+  std::size_t rows() const { return n_rows; }
+
+ private:
+  std::FILE* f = nullptr;
+  std::size_t n_rows = 0;
+};
@@ -0,0 +1,81 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include "common/SpscRing.hpp"
+#include "order/Sbe.hpp"
+
+// Exchange gateway stand-in: turns each inbound order frame into one
+// ExecReport. Limit orders are acknowledged (New), market orders fill in
+// full at their price field, cancels and replaces are confirmed. No book,
+// no state beyond the exec id counter; it exists to exercise the encoder
+// and transports end to end.
+class GatewaySim {
+ public:
+  // ack for `in` written to `out` (kSbeMaxFrame bytes); 0 if `in` is not a known frame
+  std::size_t handle(const std::uint8_t* in, std::size_t len, std::uint8_t* out, std::int64_t now_ns);
+
+ private:
+  std::uint64_t next_exec_id = 1;
+};
+
+// One frame on a transport: length + bytes, one cache line.
+struct SbeFrame {
+  std::uint8_t len = 0;
+  std::uint8_t data[kSbeMaxFrame - 1] = {};
+};
+
+// In-process transport: send() runs the gateway inline and queues its ack.
+class LoopbackTransport {
+ public:
+  explicit LoopbackTransport(std::size_t ack_capacity = 4096) : acks(ack_capacity) {}
+
+  bool send(const std::uint8_t* buf, std::size_t len);
+  std::size_t recv(std::uint8_t* buf, std::size_t cap);   // one frame, 0 if none
+
+ private:
+  GatewaySim gw;
+  SpscRing<SbeFrame> acks;
+};
+
+// Unix-domain SOCK_SEQPACKET client: one send() per frame, boundaries kept.
+class UnixSocketTransport {
+ public:
+  UnixSocketTransport() = default;
+  ~UnixSocketTransport() { close(); }
+  UnixSocketTransport(const UnixSocketTransport&) = delete;
+  UnixSocketTransport& operator=(const UnixSocketTransport&) = delete;
+
+  bool connect(const std::string& path);
+  void close();
+
+  bool send(const std::uint8_t* buf, std::size_t len);     // non-blocking; false if it would block
+  std::size_t recv(std::uint8_t* buf, std::size_t cap);   // non-blocking; 0 if nothing queued
+
+ private:
+  int fd = -1;
+};
+
+// GatewaySim served on a Unix socket by a background thread.
+class UnixGatewayServer {
+ public:
+  UnixGatewayServer() = default;
+  ~UnixGatewayServer() { stop(); }
+  UnixGatewayServer(const UnixGatewayServer&) = delete;
+  UnixGatewayServer& operator=(const UnixGatewayServer&) = delete;
+
+  bool start(const std::string& path);
+  void stop();
+
+ private:
+  std::string path;
+  int listen_fd = -1;
+  std::atomic<bool> running{false};
+  std::thread th;
+
+  void serve();
+};
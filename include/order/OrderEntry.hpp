@@ -0,0 +1,112 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "common/Types.hpp"
+#include "order/Sbe.hpp"
+
+struct OrderEntryStats {
+  std::uint64_t sent = 0, send_failed = 0, acks = 0, fills = 0, rejects = 0;
+};
+
+// Order-entry session over a transport with
+//   bool send(const std::uint8_t*, std::size_t) and
+//   std::size_t recv(std::uint8_t*, std::size_t)
+// (LoopbackTransport, UnixSocketTransport). Frames are encoded into one
+// pre-allocated, cache-aligned buffer and handed to the transport; no
+// call allocates. Each call returns the new cl_ord_id, or 0 if the
+// transport refused the frame.
+template <class Transport>
+class OrderEntry {
+ public:
+  OrderEntry(Transport& t, std::uint32_t instrument_id) : tx(t), instrument(instrument_id) {}
+
+  std::uint64_t new_order(OrdSide side, std::uint32_t qty, double px, OrdType type, TsNanos ts) {
+    const std::uint64_t id = next_id++;
+    NewOrderEncoder m(out.data());
+    m.cl_ord_id(id).send_ts(ts).price(sbe_price(px)).instrument(instrument)
+     .qty(qty).side(side).ord_type(type);
+    return send(m.size(), id);
+  }
+
+  std::uint64_t cancel(std::uint64_t orig_id, OrdSide side, TsNanos ts) {
+    const std::uint64_t id = next_id++;
+    CancelEncoder m(out.data());
+    m.cl_ord_id(id).orig_cl_ord_id(orig_id).send_ts(ts).instrument(instrument).side(side);
+    return send(m.size(), id);
+  }
+
+  std::uint64_t replace(std::uint64_t orig_id, OrdSide side, std::uint32_t qty, double px, TsNanos ts) {
+    const std::uint64_t id = next_id++;
+    ReplaceEncoder m(out.data());
+    m.cl_ord_id(id).orig_cl_ord_id(orig_id).send_ts(ts).price(sbe_price(px))
+     .instrument(instrument).qty(qty).side(side);
+    return send(m.size(), id);
+  }
+
+  // drain execution reports: on_exec(const ExecReportDecoder&) per frame
+  template <class F>
+  std::size_t poll(F&& on_exec, std::size_t max = 64) {
+    std::size_t n = 0;
+    SbeHeader h;
+    while (n < max) {
+      const std::size_t len = tx.recv(in.data(), in.size());
+      if (len == 0) break;
+      if (!sbe_peek_header(in.data(), len, h) || h.template_id != ExecReportLayout::kTemplateId) continue;
+      const ExecReportDecoder er(in.data());
+      ++st.acks;
+      if (er.exec_type() == ExecType::Trade)    ++st.fills;
+      if (er.exec_type() == ExecType::Rejected) ++st.rejects;
+      on_exec(er);
+      ++n;
+    }
+    return n;
+  }
+
+  const OrderEntryStats& stats() const { return st; }
+
+ private:
+  Transport& tx;
+  std::uint32_t instrument;
+  std::uint64_t next_id = 1;
+  alignas(64) std::array<std::uint8_t, kSbeMaxFrame> out{};
+  alignas(64) std::array<std::uint8_t, kSbeMaxFrame> in{};
+  OrderEntryStats st{};
+
+  std::uint64_t send(std::size_t len, std::uint64_t id) {
+    if (tx.send(out.data(), len)) { ++st.sent; return id; }
+    ++st.send_failed;
+    return 0;
+  }
+};
+
+// Receives the strategy's position changes from the live engine, as
+// signed lots (Position::lots()).
+class OrderSink {
+ public:
+  virtual ~OrderSink() = default;
+  virtual void on_position(TsNanos ts, int from_lots, int to_lots, const QuoteL1& book) = 0;
+};
+
+// Turns a position change into one marketable order for the difference
+// (a 1-lot flip sends 2 lots, a partial exit only what was taken), priced
+// at the touch it would cross. The strategy books its own fills, so acks
+// are only drained here to keep the transport from backing up.
+template <class Transport>
+class PositionRouter : public OrderSink {
+ public:
+  explicit PositionRouter(OrderEntry<Transport>& oe) : oe(oe) {}
+
+  void on_position(TsNanos ts, int from_lots, int to_lots, const QuoteL1& book) override {
+    const int delta = to_lots - from_lots;
+    if (delta == 0) return;
+    const OrdSide side = delta > 0 ? OrdSide::Buy : OrdSide::Sell;
+    const double px = delta > 0 ? book.ask_px : book.bid_px;
+    oe.new_order(side, static_cast<std::uint32_t>(delta > 0 ? delta : -delta), px, OrdType::Market, ts);
+    oe.poll([](const ExecReportDecoder&) {});
+  }
+
+ private:
+  OrderEntry<Transport>& oe;
+};
@@ -0,0 +1,142 @@
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// SBE-style binary order-entry messages. Every frame is an 8-byte message
+// header followed by a fixed root block; fields sit at offsets fixed at
+// compile time (listed explicitly, as an SBE schema does, and checked for
+// overlap below), little-endian, no varlen data. Encoders and decoders are
+// flyweights over a caller-owned buffer: wrap, set/get, done; nothing
+// allocates.
+
+static_assert(std::endian::native == std::endian::little, "SBE frames are little-endian");
+
+inline constexpr std::uint16_t kSbeSchemaId = 0x4f46;   // "OF"
+inline constexpr std::uint16_t kSbeVersion  = 1;
+inline constexpr std::size_t   kSbeHeaderLen = 8;
+inline constexpr std::size_t   kSbeMaxFrame  = 64;
+
+struct SbeHeader {
+  std::uint16_t block_length = 0;
+  std::uint16_t template_id  = 0;
+  std::uint16_t schema_id    = 0;
+  std::uint16_t version      = 0;
+};
+static_assert(sizeof(SbeHeader) == kSbeHeaderLen);
+
+enum class OrdSide : std::uint8_t { Buy = 1, Sell = 2 };
+enum class OrdType : std::uint8_t { Limit = 1, Market = 2 };
+enum class ExecType : std::uint8_t { New = 0, Canceled = 4, Replaced = 5, Rejected = 8, Trade = 15 };
+
+// name, type, offset within the root block
+#define OFI_SBE_NEW_ORDER(X)                \
+  X(cl_ord_id,   std::uint64_t,  0)         \
+  X(send_ts,     std::int64_t,   8)         \
+  X(price,       std::int64_t,  16)         \
+  X(instrument,  std::uint32_t, 24)         \
+  X(qty,         std::uint32_t, 28)         \
+  X(side,        OrdSide,       32)         \
+  X(ord_type,    OrdType,       33)
+
+#define OFI_SBE_CANCEL(X)                   \
+  X(cl_ord_id,      std::uint64_t,  0)      \
+  X(orig_cl_ord_id, std::uint64_t,  8)      \
+  X(send_ts,        std::int64_t,  16)      \
+  X(instrument,     std::uint32_t, 24)      \
+  X(side,           OrdSide,       28)
+
+#define OFI_SBE_REPLACE(X)                  \
+  X(cl_ord_id,      std::uint64_t,  0)      \
+  X(orig_cl_ord_id, std::uint64_t,  8)      \
+  X(send_ts,        std::int64_t,  16)      \
+  X(price,          std::int64_t,  24)      \
+  X(instrument,     std::uint32_t, 32)      \
+  X(qty,            std::uint32_t, 36)      \
+  X(side,           OrdSide,       40)
+
+#define OFI_SBE_EXEC_REPORT(X)              \
+  X(cl_ord_id,   std::uint64_t,  0)         \
+  X(exec_id,     std::uint64_t,  8)         \
+  X(transact_ts, std::int64_t,  16)         \
+  X(price,       std::int64_t,  24)         \
+  X(qty,         std::uint32_t, 32)         \
+  X(leaves_qty,  std::uint32_t, 36)         \
+  X(exec_type,   ExecType,      40)         \
+  X(side,        OrdSide,       41)
+
+struct SbeFieldSpan { std::size_t off, size; };
+
+// fields listed in offset order must not overlap
+template <std::size_t N>
+constexpr bool sbe_non_overlapping(const SbeFieldSpan (&f)[N]) {
+  for (std::size_t i = 1; i < N; ++i)
+    if (f[i - 1].off + f[i - 1].size > f[i].off) return false;
+  return true;
+}
+template <std::size_t N>
+constexpr std::size_t sbe_block_end(const SbeFieldSpan (&f)[N]) {
+  return f[N - 1].off + f[N - 1].size;
+}
+
+#define OFI_SBE_SPAN(name, type, off) SbeFieldSpan{off, sizeof(type)},
+#define OFI_SBE_SET(name, type, off)                                    \
+  auto& name(type v) {                                                  \
+    std::memcpy(p + kSbeHeaderLen + (off), &v, sizeof(type));           \
+    return *this;                                                       \
+  }
+#define OFI_SBE_GET(name, type, off)                                    \
+  type name() const {                                                   \
+    type v;                                                             \
+    std::memcpy(&v, p + kSbeHeaderLen + (off), sizeof(type));           \
+    return v;                                                           \
+  }
+
+// Name##Encoder / Name##Decoder flyweights for one message type
+#define OFI_SBE_MESSAGE(Name, TemplateId, FIELDS)                                  \
+  struct Name##Layout {                                                            \
+    static constexpr SbeFieldSpan fields[] = {FIELDS(OFI_SBE_SPAN)};               \
+    static_assert(sbe_non_overlapping(fields), #Name " fields overlap");           \
+    static constexpr std::uint16_t kTemplateId  = TemplateId;                      \
+    static constexpr std::uint16_t kBlockLength =                                  \
+        static_cast<std::uint16_t>((sbe_block_end(fields) + 7) & ~std::size_t{7}); \
+    static constexpr std::size_t kFrameLen = kSbeHeaderLen + kBlockLength;         \
+    static_assert(kFrameLen <= kSbeMaxFrame, #Name " exceeds kSbeMaxFrame");       \
+  };                                                                               \
+  class Name##Encoder : public Name##Layout {                                      \
+   public:                                                                         \
+    explicit Name##Encoder(std::uint8_t* buf) : p(buf) {                           \
+      const SbeHeader h{kBlockLength, kTemplateId, kSbeSchemaId, kSbeVersion};     \
+      std::memcpy(p, &h, sizeof(h));                                               \
+    }                                                                              \
+    FIELDS(OFI_SBE_SET)                                                            \
+    std::size_t size() const { return kFrameLen; }                                 \
+   private:                                                                        \
+    std::uint8_t* p;                                                               \
+  };                                                                               \
+  class Name##Decoder : public Name##Layout {                                      \
+   public:                                                                         \
+    explicit Name##Decoder(const std::uint8_t* buf) : p(buf) {}                    \
+    FIELDS(OFI_SBE_GET)                                                            \
+   private:                                                                        \
+    const std::uint8_t* p;                                                         \
+  };
+
+OFI_SBE_MESSAGE(NewOrder,   1,  OFI_SBE_NEW_ORDER)
+OFI_SBE_MESSAGE(Cancel,     2,  OFI_SBE_CANCEL)
+OFI_SBE_MESSAGE(Replace,    3,  OFI_SBE_REPLACE)
+OFI_SBE_MESSAGE(ExecReport, 10, OFI_SBE_EXEC_REPORT)
+
+// header of a received frame; false if it is short or not ours
+inline bool sbe_peek_header(const std::uint8_t* buf, std::size_t len, SbeHeader& h) {
+  if (len < kSbeHeaderLen) return false;
+  std::memcpy(&h, buf, sizeof(h));
+  return h.schema_id == kSbeSchemaId && len >= kSbeHeaderLen + h.block_length;
+}
+
+// prices travel as 1e-9 fixed point, like DBN
+inline std::int64_t sbe_price(double px) {
+  return static_cast<std::int64_t>(px * 1e9 + (px >= 0 ? 0.5 : -0.5));
+}
+inline double sbe_price_to_double(std::int64_t px) { return static_cast<double>(px) * 1e-9; }
@@ -0,0 +1,54 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+// Bounded MPMC queue between pipeline stages on different threads.
+// push() blocks while full (backpressure), pop() blocks while empty.
+// close() wakes everyone: pushes then fail, pops drain what is left.
+template <class T>
+class Channel {
+ public:
+  explicit Channel(std::size_t capacity) : cap(capacity ? capacity : 1) {}
+
+  bool push(T v) {
+    std::unique_lock<std::mutex> lk(mu);
+    not_full.wait(lk, [&] { return closed || q.size() < cap; });
+    if (closed) return false;
+    q.push_back(std::move(v));
+    lk.unlock();
+    not_empty.notify_one();
+    return true;
+  }
+
+  std::optional<T> pop() {
+    std::unique_lock<std::mutex> lk(mu);
+    not_empty.wait(lk, [&] { return closed || !q.empty(); });
+    if (q.empty()) return std::nullopt;
+    T v = std::move(q.front());
+    q.pop_front();
+    lk.unlock();
+    not_full.notify_one();
+    return v;
+  }
+
+  void close() {
+    {
+      std::lock_guard<std::mutex> lk(mu);
+      closed = true;
+    }
+    not_full.notify_all();
+    not_empty.notify_all();
+  }
+
+  std::size_t capacity() const { return cap; }
+
+ private:
+  const std::size_t cap;
+  std::deque<T> q;
+  std::mutex mu;
+  std::condition_variable not_full, not_empty;
+  bool closed = false;
+};
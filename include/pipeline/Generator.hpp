@@ -0,0 +1,93 @@
+#pragma once
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+// Minimal synchronous generator (C++20 has no std::generator yet).
+// Values are yielded by reference: the consumer sees the producer's object
+// in place and must be done with it before pulling the next one, so stages
+// can hand whole chunks downstream without copying.
+template <class T>
+class Generator {
+ public:
+  using value_type = std::remove_cvref_t<T>;
+
+  struct promise_type {
+    value_type* current = nullptr;
+    std::exception_ptr error;
+
+    Generator get_return_object() {
+      return Generator{std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+
+    std::suspend_always yield_value(value_type& v) noexcept {
+      current = std::addressof(v);
+      return {};
+    }
+    // temporaries in a co_yield expression live until the consumer resumes us
+    std::suspend_always yield_value(value_type&& v) noexcept {
+      current = std::addressof(v);
+      return {};
+    }
+
+    void return_void() noexcept {}
+    void unhandled_exception() { error = std::current_exception(); }
+
+    template <class U>
+    std::suspend_never await_transform(U&&) = delete;  // generators don't co_await
+  };
+
+  Generator() = default;
+  Generator(Generator&& o) noexcept : h(std::exchange(o.h, {})) {}
+  Generator& operator=(Generator&& o) noexcept {
+    if (this != &o) { reset(); h = std::exchange(o.h, {}); }
+    return *this;
+  }
+  Generator(const Generator&) = delete;
+  Generator& operator=(const Generator&) = delete;
+  ~Generator() { reset(); }
+
+  // next item, or nullptr when the producer finished
+  value_type* next() {
+    if (!h || h.done()) return nullptr;
+    h.resume();
+    if (h.promise().error) std::rethrow_exception(std::exchange(h.promise().error, {}));
+    return h.done() ? nullptr : h.promise().current;
+  }
+
+  class iterator {
+   public:
+    using iterator_category = std::input_iterator_tag;
+    using difference_type   = std::ptrdiff_t;
+    using value_type        = Generator::value_type;
+
+    iterator() = default;
+    explicit iterator(Generator* g) : gen(g), cur(g->next()) {}
+
+    value_type& operator*() const { return *cur; }
+    value_type* operator->() const { return cur; }
+    iterator& operator++() { cur = gen->next(); return *this; }
+    void operator++(int) { ++*this; }
+    bool operator==(std::default_sentinel_t) const { return cur == nullptr; }
+
+   private:
+    Generator*  gen = nullptr;
+    value_type* cur = nullptr;
+  };
+
+  iterator begin() { return iterator{this}; }
+  std::default_sentinel_t end() { return {}; }
+
+ private:
+  std::coroutine_handle<promise_type> h{};
+
+  explicit Generator(std::coroutine_handle<promise_type> hh) : h(hh) {}
+  void reset() {
+    if (h) { h.destroy(); h = {}; }
+  }
+};
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "common/Types.hpp"
+#include "data/DbnReader.hpp"
+#include "pipeline/Channel.hpp"
+#include "pipeline/Generator.hpp"
+
+// Composable decode -> merge stages. Each stage is a
+// Generator that pulls chunks from the one upstream and yields its own
+// chunk by reference; nothing is materialized for a whole day. Wrap any
+// stage in threaded_stage() to run everything upstream of it on its own
+// thread, decoupled by a bounded channel.
+
+using EventChunk = std::vector<Event>;
+
+constexpr std::size_t kDefaultChunk = 8192;
+
+// records of one schema from one file (an empty path yields nothing)
+Generator<DayEvents> decode_stage(std::string path,
+                                  std::string schema_name,
+                                  std::optional<std::uint32_t> instrument_filter = std::nullopt,
+                                  bool rth_only = false,
+                                  std::size_t chunk = kDefaultChunk);
+
+// time-ordered merge of a quote stream and a trade stream (quotes win ties)
+Generator<EventChunk> merge_stage(Generator<DayEvents> quotes,
+                                  Generator<DayEvents> trades,
+                                  std::size_t chunk = kDefaultChunk);
+
+// decode both files of a day and merge them
+Generator<EventChunk> day_stage(const std::string& mbp_path,
+                                const std::string& trd_path,
+                                std::optional<std::uint32_t> instrument_filter = std::nullopt,
+                                bool rth_only = false,
+                                std::size_t chunk = kDefaultChunk);
+
+// Runs `upstream` on a worker thread; at most `capacity` chunks are
+// buffered before the worker blocks. Items are moved across.
+template <class T>
+Generator<T> threaded_stage(Generator<T> upstream, std::size_t capacity = 4) {
+  Channel<T> ch(capacity);
+  std::exception_ptr err;
+
+  struct Worker {
+    Channel<T>& ch;
+    std::thread th;
+    ~Worker() { ch.close(); if (th.joinable()) th.join(); }  // also on early consumer exit
+  };
+  Worker w{ch, std::thread([&ch, &err, up = std::move(upstream)]() mutable {
+    try {
+      for (auto& item : up) if (!ch.push(std::move(item))) break;
+    } catch (...) {
+      err = std::current_exception();
+    }
+    ch.close();
+  })};
+
+  while (auto item = ch.pop()) co_yield *item;
+  if (err) std::rethrow_exception(err);
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <queue>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/Types.hpp"
+#include "plugin/StrategyAbi.h"
+
+struct PluginStats {
+  std::uint64_t events = 0, batches = 0, timers = 0;
+  std::uint64_t fills = 0, wins = 0;
+  double        pnl = 0.0;
+  std::int64_t  busy_ns = 0;   // time inside the plugin's calls
+
+  double ns_per_event() const { return events ? double(busy_ns) / double(events) : 0.0; }
+};
+
+// One dlopen'ed strategy instance and its timers.
+class StrategyPlugin {
+ public:
+  // spec is "path.so" or "path.so:config"; nullptr with `err` set on failure
+  static std::unique_ptr<StrategyPlugin> open(const std::string& spec, std::string& err);
+  ~StrategyPlugin();
+  StrategyPlugin(const StrategyPlugin&) = delete;
+  StrategyPlugin& operator=(const StrategyPlugin&) = delete;
+
+  void on_batch(std::span<const Event> ev);
+  void fire_timers(TsNanos now);     // every timer with deadline <= now
+  void finish(TsNanos now);          // idempotent
+  TsNanos next_deadline() const;     // INT64_MAX if none
+
+  const std::string& name() const { return plugin_name; }
+  const std::string& path() const { return so_path; }
+  const PluginStats& stats() const { return st; }
+
+ private:
+  StrategyPlugin() = default;
+
+  using Timer = std::pair<TsNanos, std::uint64_t>;   // deadline, cookie
+  void* dl = nullptr;
+  const OfiStrategyApi* api = nullptr;
+  void* self = nullptr;
+  OfiHost host{};
+  std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers;
+  std::string plugin_name, so_path;
+  PluginStats st{};
+
+  static void report_fill(void* ctx, std::int64_t ts, double pnl);
+  static void schedule(void* ctx, std::int64_t deadline_ns, std::uint64_t cookie);
+};
+
+// Drives several plugins over one decoded day in a single pass. Events go
+// out in batches of up to `batch`, cut early at the next pending timer so
+// timers scheduled before a batch fire at their deadline; a timer scheduled
+// inside a batch fires before the next one.
+class PluginHost {
+ public:
+  bool load(const std::string& spec, std::string& err);
+  void run(std::span<const Event> ev, std::size_t batch = 256);
+  void finish(TsNanos now);
+
+  const std::vector<std::unique_ptr<StrategyPlugin>>& plugins() const { return loaded; }
+
+ private:
+  std::vector<std::unique_ptr<StrategyPlugin>> loaded;
+};
@@ -0,0 +1,68 @@
+#pragma once
+/* Strategy plugin ABI (C). A plugin is a shared object exporting
+ *
+ *   const OfiStrategyApi* ofi_strategy_entry(void);
+ *
+ * The host decodes and merges a day once and hands every loaded plugin the
+ * same event batches in one pass. Everything crossing the boundary is POD;
+ * the only calls back into the host go through OfiHost. Bump
+ * OFI_STRATEGY_ABI_VERSION on any layout or signature change; the host
+ * refuses plugins built against another version. */
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define OFI_STRATEGY_ABI_VERSION 1u
+
+enum { OFI_EV_QUOTE = 0, OFI_EV_TRADE = 1 };
+enum { OFI_AGG_UNKNOWN = 0, OFI_AGG_BUY = 1, OFI_AGG_SELL = 2 };
+
+typedef struct OfiQuote {
+  int64_t ts;
+  double  bid_px, ask_px;
+  int32_t bid_sz, ask_sz;
+} OfiQuote;
+
+typedef struct OfiTrade {
+  int64_t ts;
+  double  px;
+  int32_t sz;
+  uint8_t aggressor;   /* OFI_AGG_* */
+} OfiTrade;
+
+/* quote or trade, by type; same layout as the host's Event */
+typedef struct OfiEvent {
+  uint8_t  type;       /* OFI_EV_* */
+  int64_t  ts;
+  OfiQuote q;
+  OfiTrade t;
+} OfiEvent;
+
+typedef struct OfiHost {
+  void* ctx;
+  /* a realized round trip (pnl in currency) */
+  void (*report_fill)(void* ctx, int64_t ts, double pnl);
+  /* on_timer(self, deadline, cookie) is called once event time reaches
+   * deadline; timers fire between batches, never inside one */
+  void (*schedule)(void* ctx, int64_t deadline_ns, uint64_t cookie);
+} OfiHost;
+
+typedef struct OfiStrategyApi {
+  uint32_t    abi_version;   /* OFI_STRATEGY_ABI_VERSION */
+  const char* name;
+  /* config is the text after ':' in --plugin=path.so:config (may be ""); NULL on failure */
+  void* (*init)(const OfiHost* host, const char* config);
+  void  (*on_event_batch)(void* self, const OfiEvent* ev, size_t n);
+  void  (*on_timer)(void* self, int64_t now_ns, uint64_t cookie);
+  /* flatten, report the last fills and free self */
+  void  (*finish)(void* self, int64_t now_ns);
+} OfiStrategyApi;
+
+typedef const OfiStrategyApi* (*OfiStrategyEntryFn)(void);
+
+#ifdef __cplusplus
+}
+#endif
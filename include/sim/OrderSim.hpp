@@ -0,0 +1,137 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "common/Types.hpp"
+#include "sim/OrderTable.hpp"
+
+struct OrderSimParams {
+  std::int64_t to_exchange_ns = 150'000;   // order action -> matching engine
+  std::int64_t to_client_ns   = 150'000;   // exchange event -> our ack / fill
+  double       cancel_ahead   = 0.5;       // share of unexplained size drops taken from ahead of us
+  bool         post_only      = true;      // reject (rather than fill) a resting order that would cross
+};
+
+enum class SimExec : std::uint8_t { New, Replaced, Canceled, Fill, Rejected };
+
+struct SimOrder;
+using SimHandle = OrderTable<SimOrder>::Handle;
+
+// What the client sees, `to_client_ns` after it happened at the exchange.
+struct SimExecReport {
+  SimHandle h{};
+  SimExec   type = SimExec::New;
+  int       side = 0;       // +1 buy, -1 sell
+  double    px = 0.0;       // order price (fill price for Fill)
+  QtyI      qty = 0;        // filled this report (Fill) / order qty (acks)
+  QtyI      leaves = 0;
+  TsNanos   exch_ts = 0, client_ts = 0;
+};
+
+struct OrderSimStats {
+  std::uint64_t submits = 0, replaces = 0, cancels = 0;   // actions sent
+  std::uint64_t fills = 0, filled_qty = 0, taker_fills = 0;
+  std::uint64_t rejects = 0;
+  std::uint64_t too_late = 0;          // cancel/replace reached an order already filled
+  std::uint64_t priority_resets = 0;   // replaces that sent the order to the back
+  std::size_t   max_live = 0;
+};
+
+// Exchange-side state of one order.
+struct SimOrder {
+  enum State : std::uint8_t { InFlight, Live, Done };
+  enum Action : std::uint8_t { None, Replace, Cancel };
+
+  State  state = InFlight;
+  int    side = 0;
+  double px = 0.0;
+  QtyI   leaves = 0;
+
+  // L1 queue position (see OrderSim)
+  double ahead = 0.0;
+  double traded = 0.0;
+  QtyI   level_sz = 0;
+  bool   at_touch = false;
+  bool   queue_known = false;
+  bool   improving = false;      // priced inside the displayed touch: alone at the front
+  bool   may_take = false;       // marketable: crosses even when post_only
+
+  // one action at a time may be on the wire
+  Action action = None;
+  double new_px = 0.0;
+  QtyI   new_qty = 0;
+
+  std::uint32_t live_pos = 0;    // index in OrderSim::live
+};
+
+// Resting limit orders against an L1 feed, with wire latency both ways.
+// submit/cancel/replace reach the matching engine `to_exchange_ns` later;
+// every ack and fill reaches the client `to_client_ns` after it happened.
+// Latencies are constant, so actions and reports arrive in the order they
+// were sent: two FIFOs, no timer structure needed.
+//
+// Queue position is modelled as in L1QueueOrder, generalized to size:
+// joining at the touch puts everything displayed ahead of us; trades at
+// our price from the other side work it off, and volume past it fills us
+// (partially if need be); unexplained size drops are cancels, cancel_ahead
+// of them in front. A price inside the spread is alone at the front (the
+// feed does not show our order, so the displayed touch stays behind it).
+// A replace that raises size or moves the price goes to the back of the
+// queue; one that only lowers size keeps priority.
+class OrderSim {
+ public:
+  explicit OrderSim(OrderSimParams p = {}, std::size_t reserve = 4096);
+
+  // client side; each returns false / a null handle if the action is refused
+  // locally (unknown order, or another action still on the wire)
+  // `may_take` marks a marketable order: if it crosses on arrival it takes
+  // its full size at the opposite touch regardless of post_only
+  SimHandle submit(int side, double px, QtyI qty, TsNanos now, bool may_take = false);
+  bool cancel(SimHandle h, TsNanos now);
+  bool replace(SimHandle h, double px, QtyI qty, TsNanos now);
+
+  // exchange side, in event-time order
+  void on_quote(const QuoteL1& q);
+  void on_trade(const Trade& t);
+
+  // deliver every report with client_ts <= now (after applying actions due by now)
+  template <class F>
+  void advance(TsNanos now, F&& on_report) {
+    arrive_until(now);
+    while (rep_head < reports.size() && reports[rep_head].client_ts <= now) on_report(reports[rep_head++]);
+    if (rep_head == reports.size()) { reports.clear(); rep_head = 0; }
+  }
+
+  bool busy(SimHandle h) const;                 // an action is still on the wire
+  const SimOrder* find(SimHandle h) const { return table.get(h); }
+  std::size_t live_orders() const { return live.size(); }
+  const OrderSimStats& stats() const { return st; }
+  std::size_t table_capacity() const { return table.capacity(); }
+
+ private:
+  struct InFlightAction {
+    SimHandle h;
+    TsNanos   arrive_ts;
+  };
+
+  OrderSimParams P;
+  OrderTable<SimOrder> table;
+  std::vector<SimHandle> live;              // orders resting at the exchange
+  std::vector<InFlightAction> wire;         // FIFO, consumed from wire_head
+  std::size_t wire_head = 0;
+  std::vector<SimExecReport> reports;       // FIFO, consumed from rep_head
+  std::size_t rep_head = 0;
+  QuoteL1 book{};
+  bool    have_book = false;
+  OrderSimStats st{};
+
+  void arrive_until(TsNanos ts);
+  void arrive(SimHandle h, SimOrder& o, TsNanos ts);
+  void join_queue(SimOrder& o);
+  void report(SimHandle h, const SimOrder& o, SimExec type, QtyI qty, TsNanos ts, double px);
+  void fill(SimHandle h, SimOrder& o, QtyI qty, double px, TsNanos ts);
+  void add_live(SimHandle h, SimOrder& o);
+  void remove_live(SimOrder& o);
+  bool crosses(const SimOrder& o) const;
+};
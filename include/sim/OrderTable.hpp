@@ -0,0 +1,69 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Pooled, handle-indexed table. Slots are recycled through a free list and
+// addressed by generation-checked handles, so a handle to an order that is
+// already gone is detected instead of aliasing whatever reused its slot.
+// After warm-up (or with enough reserved) alloc/release never allocate.
+template <class T>
+class OrderTable {
+ public:
+  struct Handle {
+    std::uint32_t idx = 0;
+    std::uint32_t gen = 0;   // 0 = null
+    explicit operator bool() const { return gen != 0; }
+    bool operator==(const Handle&) const = default;
+  };
+
+  explicit OrderTable(std::size_t reserve = 1024) { slots.reserve(reserve); }
+
+  Handle alloc() {
+    std::uint32_t i;
+    if (free_head != kNil) {
+      i = free_head;
+      free_head = slots[i].next_free;
+    } else {
+      i = static_cast<std::uint32_t>(slots.size());
+      slots.emplace_back();
+    }
+    Slot& s = slots[i];
+    s.v = T{};
+    s.next_free = kInUse;
+    ++n_live;
+    return {i, s.gen};
+  }
+
+  // nullptr if h is null, released, or from an earlier generation
+  T* get(Handle h) {
+    if (!h || h.idx >= slots.size()) return nullptr;
+    Slot& s = slots[h.idx];
+    return s.gen == h.gen && s.next_free == kInUse ? &s.v : nullptr;
+  }
+  const T* get(Handle h) const { return const_cast<OrderTable*>(this)->get(h); }
+
+  void release(Handle h) {
+    if (!get(h)) return;
+    Slot& s = slots[h.idx];
+    if (++s.gen == 0) s.gen = 1;
+    s.next_free = free_head;
+    free_head = h.idx;
+    --n_live;
+  }
+
+  std::size_t live() const { return n_live; }
+  std::size_t capacity() const { return slots.size(); }
+
+ private:
+  static constexpr std::uint32_t kNil   = 0xffffffffu;
+  static constexpr std::uint32_t kInUse = 0xfffffffeu;
+  struct Slot {
+    T v{};
+    std::uint32_t gen = 1;
+    std::uint32_t next_free = kNil;
+  };
+  std::vector<Slot> slots;
+  std::uint32_t free_head = kNil;
+  std::size_t n_live = 0;
+};
@@ -0,0 +1,145 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "common/L1Ofi.hpp"
+#include "common/Rls.hpp"
+#include "common/Types.hpp"
+
+struct AlphaParams {
+  double       tick_size  = 0.25;
+  double       lambda     = 0.9995;          // RLS forgetting per sample
+  std::int64_t horizon_ns = 100'000'000LL;   // predict the mid move this far ahead
+  std::int64_t sample_ns  = 5'000'000LL;     // at most one training sample per interval
+  std::int64_t fast_ns    = 50'000'000LL;    // OFI time constants
+  std::int64_t slow_ns    = 500'000'000LL;
+  std::int64_t flow_ns    = 250'000'000LL;   // signed trade flow time constant
+};
+
+struct AlphaStats {
+  std::uint64_t samples = 0, dropped = 0;
+  double sse = 0.0, sst = 0.0, sum_y = 0.0;   // a-priori errors and target spread
+
+  // out-of-sample R^2 of the one-step-ahead predictions
+  double r2() const {
+    if (samples < 2) return 0.0;
+    const double var = sst - sum_y * sum_y / double(samples);
+    return var > 0.0 ? 1.0 - sse / var : 0.0;
+  }
+};
+
+// Online linear model of the mid move over the next horizon_ns (in ticks).
+// Features, all O(1) per event and roughly unit scale:
+//   1 (bias), OFI over two time constants and signed trade flow (each over
+//   the average touch size), normalized L1 imbalance, microprice skew.
+// Every sample_ns a (features, mid) pair is queued; once horizon_ns has
+// passed its realized move becomes the target of one RLS update. The
+// prediction is always made with the current weights, so it is out of
+// sample by construction.
+class AlphaModel {
+ public:
+  static constexpr std::size_t kFeatures = 6;
+  using Features = std::array<double, kFeatures>;
+
+  explicit AlphaModel(const AlphaParams& p = {}) : P(p), rls(p.lambda) {}
+
+  void on_quote(const QuoteL1& q) {
+    if (q.bid_px <= 0.0 || q.ask_px <= q.bid_px) return;
+    const double mid = 0.5 * (q.bid_px + q.ask_px);
+    if (have_prev) {
+      const double dt = double(q.ts - last_ts);
+      const double e = l1_ofi(prev, q);
+      decay(dt);
+      ofi_fast += e;
+      ofi_slow += e;
+    }
+    depth = have_prev ? 0.99 * depth + 0.01 * 0.5 * double(q.bid_sz + q.ask_sz)
+                      : 0.5 * double(q.bid_sz + q.ask_sz);
+    prev = q;
+    last_ts = q.ts;
+    have_prev = true;
+
+    const double tot = std::max(1.0, double(q.bid_sz + q.ask_sz));
+    const double micro = (q.ask_px * double(q.bid_sz) + q.bid_px * double(q.ask_sz)) / tot;
+    const double scale = 1.0 / std::max(1.0, depth);
+    x = {1.0, ofi_fast * scale, ofi_slow * scale, flow * scale,
+         double(q.bid_sz - q.ask_sz) / tot, (micro - mid) / P.tick_size};
+
+    train(q.ts, mid);
+    if (q.ts - last_sample_ts >= P.sample_ns) enqueue(q.ts, mid);
+  }
+
+  void on_trade(const Trade& t) {
+    if (!have_prev) return;
+    decay(double(t.ts - last_ts));
+    last_ts = std::max(last_ts, t.ts);
+    if (t.side == Aggressor::Buy)       flow += double(t.sz);
+    else if (t.side == Aggressor::Sell) flow -= double(t.sz);
+  }
+
+  // book discontinuity: flow and pending samples across it are meaningless
+  void load_snapshot(const QuoteL1& q) {
+    have_prev = false;
+    ofi_fast = ofi_slow = flow = 0.0;
+    head = tail = 0;
+    last_sample_ts = 0;
+    on_quote(q);
+  }
+
+  double predict() const { return rls.predict(x); }   // ticks over horizon_ns
+  const Features& features() const { return x; }
+  const Features& weights() const { return rls.weights(); }
+  const AlphaStats& stats() const { return st; }
+  std::uint64_t updates() const { return rls.updates(); }
+
+ private:
+  struct Sample {
+    TsNanos  ts = 0;
+    double   mid = 0.0;
+    Features x{};
+  };
+  static constexpr std::size_t kRing = 256;   // power of two
+
+  AlphaParams P;
+  Rls<kFeatures> rls;
+  Features x{};
+  AlphaStats st{};
+
+  QuoteL1 prev{};
+  bool    have_prev = false;
+  TsNanos last_ts = 0, last_sample_ts = 0;
+  double  ofi_fast = 0.0, ofi_slow = 0.0, flow = 0.0, depth = 1.0;
+
+  std::array<Sample, kRing> ring{};
+  std::size_t head = 0, tail = 0;   // pending samples are [head, tail)
+
+  void decay(double dt) {
+    if (dt <= 0.0) return;
+    ofi_fast *= std::exp(-dt / double(P.fast_ns));
+    ofi_slow *= std::exp(-dt / double(P.slow_ns));
+    flow     *= std::exp(-dt / double(P.flow_ns));
+  }
+
+  void train(TsNanos now, double mid) {
+    while (head != tail && ring[head & (kRing - 1)].ts + P.horizon_ns <= now) {
+      const Sample& s = ring[head & (kRing - 1)];
+      const double y = (mid - s.mid) / P.tick_size;
+      const double err = rls.update(s.x, y);
+      ++st.samples;
+      st.sse += err * err;
+      st.sst += y * y;
+      st.sum_y += y;
+      ++head;
+    }
+  }
+
+  void enqueue(TsNanos now, double mid) {
+    if (tail - head == kRing) { ++head; ++st.dropped; }   // horizon too long for the ring: oldest goes
+    ring[tail & (kRing - 1)] = Sample{now, mid, x};
+    ++tail;
+    last_sample_ts = now;
+  }
+};
@@ -0,0 +1,75 @@
+#pragma once
+#include <cstdint>
+
+#include "common/Types.hpp"
+#include "sim/OrderSim.hpp"
+#include "strategy/QueueOfi.hpp"
+
+struct MakerParams {
+  QtyI lots    = 1;
+  bool improve = true;   // quote one tick inside when the spread is wider than a tick
+  OrderSimParams sim{};
+};
+
+struct MakerStats {
+  std::uint64_t entries = 0, exits = 0, take_exits = 0;
+  std::uint64_t repegs = 0, entry_cancels = 0;
+  std::uint64_t round_trips = 0;
+};
+
+// Maker-style variant of the OFI strategy on top of OrderSim. The OFI
+// signal (QueueOfiStrategy::on_quote, its gates and debounce) picks the
+// side; the entry rests on our touch, or a tick inside it, and is re-pegged
+// with a replace whenever the touch moves away (losing its place). An
+// opposite signal or queue_max_wait_ns without a fill cancels it. Once in
+// position a passive exit rests on the other touch; at max_hold_ns or on an
+// opposite signal it is cancelled and the position is taken out at the
+// touch. Everything the strategy knows about its orders comes from the
+// delayed reports, and it sends nothing new on an order until its last
+// action is acknowledged.
+class MakerOfi {
+ public:
+  MakerOfi(const OfiParams& p, const MakerParams& m);
+
+  // one market event; returns PnL realized by fills reported by e.ts
+  double on_event(const Event& e);
+  // end of day: take out any open position at the touch of q; working
+  // orders are left to die with the session
+  double flatten(const QuoteL1& q);
+
+  int position() const { return pos; }
+  const OrderSimStats& sim_stats() const { return sim.stats(); }
+  const MakerStats& stats() const { return ms; }
+  const CounterSet& signal_counters() const { return sig.counters(); }   // gates / debounce of the signal
+  std::size_t table_capacity() const { return sim.table_capacity(); }
+
+ private:
+  enum Role : std::uint8_t { Entry, Exit };
+
+  OfiParams   P;
+  MakerParams M;
+  QueueOfiStrategy sig;   // signals only; never trades itself
+  OrderSim    sim;
+  MakerStats  ms{};
+
+  // our one working order, as known from the reports
+  SimHandle working{};
+  Role      role = Entry;
+  int       working_side = 0;
+  double    working_px = 0.0;
+  QtyI      working_leaves = 0;
+  bool      working_take = false;
+  bool      acked = false;
+  bool      pending = false;      // an action is unacknowledged
+  TsNanos   working_ts = 0;
+
+  int     pos = 0;          // signed lots
+  double  entry_px = 0.0;
+  TsNanos entry_ts = 0;
+
+  double on_report(const SimExecReport& r);
+  void decide(const QuoteL1& q, int s);
+  double passive_px(const QuoteL1& q, int side) const;
+  void send(const QuoteL1& q, Role r, int side, double px, QtyI qty, bool take);
+  void repeg(const QuoteL1& q, int side);
+};
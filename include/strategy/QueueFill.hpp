@@ -0,0 +1,93 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "common/Types.hpp"
+
+struct QueueFillStats {
+  std::uint64_t placed = 0;
+  std::uint64_t filled = 0;          // queue ahead worked off by trades
+  std::uint64_t traded_through = 0;  // ... or the level itself went (counted in filled too)
+  std::uint64_t expired = 0;         // queue_max_wait_ns passed unfilled
+  std::uint64_t cancelled = 0;       // replaced by another signal / snapshot
+
+  double fill_rate() const { return placed ? 100.0 * double(filled) / double(placed) : 0.0; }
+};
+
+// One passive 1-lot order at the L1 touch, tracked without order-by-order
+// data. It joins the back of the queue: everything displayed at its price
+// when placed is ahead of it. Trades at that price (from the other side)
+// work the queue off; size decrements the trades do not explain are
+// cancels, and a `cancel_ahead` share of them is assumed to come from in
+// front of us. The order fills once a trade reaches past the queue ahead,
+// or when the level trades through. Every update is O(1).
+class L1QueueOrder {
+ public:
+  bool active() const { return dir != 0; }
+  int side() const { return dir; }            // +1 resting bid, -1 resting offer
+  double price() const { return px; }
+  double queue_ahead() const { return ahead; }
+  bool traded_through() const { return thru; }   // how the last fill happened
+
+  void place(int side, const QuoteL1& q) {
+    dir = side;
+    px = side > 0 ? q.bid_px : q.ask_px;
+    level_sz = side > 0 ? q.bid_sz : q.ask_sz;
+    ahead = double(level_sz);
+    traded = 0.0;
+    at_touch = true;
+    thru = false;
+  }
+  void cancel() { dir = 0; }
+
+  // true if this print filled the order
+  bool on_trade(const Trade& t) {
+    if (!dir) return false;
+    if (through(t.px)) return thru = true;
+    if (!same(t.px)) return false;
+    // a resting bid is hit by sellers, an offer lifted by buyers; unknown prints count
+    const Aggressor hits = dir > 0 ? Aggressor::Sell : Aggressor::Buy;
+    if (t.side != hits && t.side != Aggressor::Unknown) return false;
+    traded += double(t.sz);
+    ahead -= double(t.sz);
+    return ahead < 0.0;
+  }
+
+  // true if the book update implies a fill (our level traded through)
+  bool on_quote(const QuoteL1& q, double cancel_ahead) {
+    if (!dir) return false;
+    const double touch = dir > 0 ? q.bid_px : q.ask_px;
+    const QtyI   sz    = dir > 0 ? q.bid_sz : q.ask_sz;
+    if (touch <= 0.0) return false;   // side missing from the book
+    if (through(touch)) return thru = true;
+    if (!same(touch)) {   // someone improved the price: we rest behind the new touch
+      at_touch = false;
+      traded = 0.0;
+      return false;
+    }
+    if (!at_touch) {      // back at our price; nothing in front can exceed what is shown
+      at_touch = true;
+      ahead = std::min(ahead, double(sz));
+    } else if (sz < level_sz) {
+      const double unexplained = std::max(0.0, double(level_sz - sz) - traded);
+      ahead = std::max(0.0, ahead - cancel_ahead * unexplained);
+    }
+    ahead = std::min(ahead, double(sz));
+    level_sz = sz;
+    traded = 0.0;
+    return false;
+  }
+
+ private:
+  int    dir = 0;
+  double px = 0.0;
+  QtyI   level_sz = 0;     // displayed size at px as of the last quote
+  double ahead = 0.0;      // displayed size still in front of us
+  double traded = 0.0;     // volume at px since the last quote (explains part of the next decrement)
+  bool   at_touch = true;
+  bool   thru = false;
+
+  bool same(double p) const { return std::fabs(p - px) <= 1e-9; }
+  bool through(double p) const { return dir > 0 ? p < px - 1e-9 : p > px + 1e-9; }
+};
@@ -1,13 +1,23 @@
 #pragma once
+#include <cstddef>
 #include <cstdint>
 #include <deque>
 #include <optional>
+#include <span>
+#include "common/Counters.hpp"
+#include "common/TimingWheel.hpp"
+#include "book/DepthBook.hpp"
 #include "common/Types.hpp"
+#include "strategy/AlphaModel.hpp"
+#include "strategy/QueueFill.hpp"
 
 struct Position {
   int side = 0;
   double entry_px = 0.0;
   TsNanos entry_ts = 0;
+  QtyI qty = 0;   // lots held
+
+  int lots() const { return side * qty; }   // signed: long > 0, short < 0
 };
 
 struct OfiParams {
@@ -17,6 +27,7 @@ struct OfiParams {
   double tick_value = 12.5;
   int    slip_ticks = 1;
   std::int64_t max_hold_ns = 2'000'000'000LL;
+  QtyI   lots = 1;              // entry size; fills walk the depth book when one is attached
 
   // microstructure / debounce
   int   min_spread_ticks = 1;
@@ -29,13 +40,71 @@ struct OfiParams {
   // NEW: small & defensible assumptions
   bool          fill_at_touch_when_spread1 = true;     // maker-style touch fill when spread==1
   std::int64_t  trade_confirm_ns           = 100'000'000LL; // require confirming trade within 100ms
+
+  std::int64_t  timer_tick_ns = 1'000;   // resolution of hold / cooldown / confirmation timers
+
+  // L1 queue-position fills for entries (instead of filling at once): the
+  // entry rests at the touch behind the displayed size and fills when the
+  // queue ahead is worked off; see L1QueueOrder. The queue model is one
+  // lot, so this needs lots == 1
+  bool          queue_fill          = false;
+  double        queue_cancel_ahead  = 0.5;              // share of unexplained size drops ahead of us
+  std::int64_t  queue_max_wait_ns   = 1'000'000'000LL;  // unfilled entries are cancelled after this
+
+  // online RLS alpha (AlphaModel) in place of the three thresholds: go with
+  // the predicted mid move over alpha_horizon_ns once it beats the cost
+  bool          alpha_rls           = false;
+  double        alpha_lambda        = 0.9995;
+  std::int64_t  alpha_horizon_ns    = 100'000'000LL;
+  double        alpha_cost_ticks    = 0.5;               // required |predicted move|
+  std::uint64_t alpha_warmup        = 500;               // training samples before trading
+};
+
+// realized PnL of one round trip (only non-zero realizations are reported)
+struct Fill {
+  TsNanos ts  = 0;
+  double  pnl = 0.0;
+};
+
+// What a stretch of events changed, for skip_quiet(). Flags are per
+// stretch: state the stretch did not touch is left as it stands.
+struct QuietStretch {
+  TsNanos end_ts = 0;        // last event in the stretch
+  bool    fed = false;       // some quote in it passed the gates ...
+  QuoteL1 last_fed{};        // ... the last one
+  double  ofi = 0.0;         // OFI after it
+  bool    quoted = false;    // prevailing book (mark) at the end
+  QuoteL1 last_quote{};
+  bool    traded = false;    // last print, for trade confirmation
+  TsNanos trade_ts = 0;
+  int     trade_dir = 0;
+};
+
+struct BatchResult {
+  std::size_t consumed = 0;  // events/quotes taken from the input span
+  std::size_t fills    = 0;  // entries written to the output span
 };
 
 class QueueOfiStrategy {
  public:
-  explicit QueueOfiStrategy(const OfiParams& p): P(p) {}
+  explicit QueueOfiStrategy(const OfiParams& p)
+      : P(p), wheel(p.timer_tick_ns), alpha(alpha_params(p)) {}
+
+  std::optional<int> on_quote(const QuoteL1& q);   // absorb_quote + decide
+
+  // Split form of on_quote for conflation: absorb_quote folds a quote into
+  // OFI and L1 state exactly, decide() runs the entry rule + persistence once.
+  void absorb_quote(const QuoteL1& q);
+  std::optional<int> decide();
+
+  // Book recovery: replace the L1 state with a snapshot. OFI restarts from
+  // it (flow across a gap is unknown) and the persistence count is cleared.
+  void load_snapshot(const QuoteL1& q);
 
-  std::optional<int> on_quote(const QuoteL1& q);
+  // RTH / spread / min-size gates the replay loops apply before on_quote;
+  // admit() is the same check with the verdict tallied into counters()
+  bool passes_gates(const QuoteL1& q) const;
+  bool admit(const QuoteL1& q);
   void on_trade(const Trade& t);   // now used for confirmation
 
   double mid() const { return 0.5 * (last_bid_px + last_ask_px); }
@@ -43,8 +112,51 @@ class QueueOfiStrategy {
   double imbalance_ticks() const;
   double ofi() const { return ofi_l1; }
 
-  double act_and_fill(TsNanos ts, double mid_px, std::optional<int> sig);
+  double act_and_fill(TsNanos ts, double mid_px, std::optional<int> sig);  // advance(ts) first
+
+  // Strategy clock, driven by event time in replay and the TSC clock live.
+  // Fires hold-expiry exits (priced off the last mark()), flip-cooldown
+  // ends and trade-confirmation expiries due by `now`; returns the PnL
+  // realized by those exits. Call it for every event, gated or not.
+  double advance(TsNanos now);
+  void mark(const QuoteL1& q) {   // prevailing book
+    mark_q = q;
+    have_mark = true;
+    if (entry_order.active() && entry_order.on_quote(q, P.queue_cancel_ahead)) fill_entry(q.ts);
+  }
+  bool in_cooldown() const { return cooldown_active; }
   const Position& pos() const { return position; }
+  const L1QueueOrder& pending_entry() const { return entry_order; }   // queue_fill only
+  const QueueFillStats& queue_stats() const { return qstats; }
+
+  // Aggressive fills walk `b` (kept current by the caller) instead of
+  // filling P.lots at mid +/- slip: VWAP prices, and partial fills when the
+  // visible depth runs out. An exit left short is finished by the next
+  // signal or, for hold expiry, by the first advance() after the book
+  // has changed (the same book has nothing left to give).
+  void attach_depth(const DepthBook* b) { depth = b; }
+  const DepthFillStats& depth_stats() const { return dstats; }
+  const AlphaModel& alpha_model() const { return alpha; }   // alpha_rls only
+  const OfiParams& params() const { return P; }
+
+  // gate-rejection funnel and fill counts of this instance (see common/Counters.hpp)
+  const CounterSet& counters() const { return ctr; }
+  CounterSet& counters() { return ctr; }
+
+  // Batch replay with the standard quote gates (RTH, spread, min sizes):
+  // every event advances the timers, quotes mark the book, trades feed
+  // confirmation, gated quotes run on_quote + act_and_fill. `fills` needs
+  // at least 2 slots (one event realizes at most two exits); stops early
+  // when fewer than 2 are left, so call again with the rest.
+  BatchResult on_events(std::span<const Event> ev, std::span<Fill> fills);
+
+  // Flat with no resting entry: only book/OFI state and timers evolve, so
+  // a stretch that cannot raise a signal can be skipped with skip_quiet(),
+  // which leaves the strategy exactly as replaying the stretch would.
+  bool idle() const { return position.side == 0 && !entry_order.active(); }
+  void skip_quiet(const QuietStretch& s);
+  // quotes-only on_events for zone-map replay; same 2-slot minimum on `fills`
+  BatchResult on_quotes(std::span<const QuoteL1> qs, std::span<Fill> fills);
 
  private:
   OfiParams P;
@@ -54,8 +166,11 @@ class QueueOfiStrategy {
   QtyI   last_bid_sz = 0,   last_ask_sz = 0;
   bool   have_prev = false;
 
-  // Signals
-  double ofi_l1 = 0.0;
+  // Signals (per instance: combos/days replayed side by side must not share state)
+  double ofi_l1  = 0.0;
+  double ofi_ewm = 0.0;
+  int    last_raw_sig   = 0;   // persistence
+  int    same_dir_count = 0;
 
   // Trade confirmation
   TsNanos last_trade_ts = 0;
@@ -63,8 +178,51 @@ class QueueOfiStrategy {
 
   // Position
   Position position{};
+  TsNanos  last_flip_ts = 0;
+
+  // Timers
+  enum TimerKind : std::uint32_t { HoldExpiry = 1, CooldownEnd = 2, ConfirmExpiry = 3, EntryExpiry = 4 };
+  TimingWheel          wheel;
+  TimingWheel::TimerId hold_timer{}, cooldown_timer{}, confirm_timer{}, entry_timer{};
+  bool    cooldown_active = false;
+  QuoteL1 mark_q{};
+  bool    have_mark = false;
+
+  void step_absorb(const QuoteL1& q);
+  std::optional<int> step_decide();
+  std::optional<int> step_quote(const QuoteL1& q);
+  double step_fill(TsNanos ts, double mid_px, std::optional<int> sig);
+
+  double slip_for(double bid_px, double ask_px, QtyI bid_sz, QtyI ask_sz) const;
+  QtyI   take(int side, QtyI qty, double mid_px, double slip, double& px);
+  double exit_on_timer(TsNanos ts);
+  void   start_cooldown(TsNanos ts);
+
+  AlphaModel alpha;
+  static AlphaParams alpha_params(const OfiParams& p) {
+    AlphaParams a;
+    a.tick_size  = p.tick_size;
+    a.lambda     = p.alpha_lambda;
+    a.horizon_ns = p.alpha_horizon_ns;
+    return a;
+  }
+
+  const DepthBook* depth = nullptr;
+  DepthFillStats   dstats{};
+  bool    exit_retry = false;   // hold exit ran the book dry; retry once it moves
+  TsNanos exit_book_ts = 0;     // depth->time() of the book it ran dry
+
+  // queue_fill: resting entry order
+  L1QueueOrder   entry_order;
+  QueueFillStats qstats{};
+  void place_entry(int side, TsNanos ts);
+  void cancel_entry();
+  void fill_entry(TsNanos ts);
 
   void update_ofi_l1(const QuoteL1& q);
   bool price_moved(const QuoteL1& q) const;
-  int  desired_position() const; // +1 / -1 / 0
+  int  desired_position() const; // raw +1 / -1 / 0, before trade confirmation
+  int  confirmed(int raw) const;  // raw, or 0 without the required trade confirmation
+
+  CounterSet ctr;
 };
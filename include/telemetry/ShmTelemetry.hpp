@@ -0,0 +1,141 @@
+#pragma once
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Shared-memory telemetry for long-running processes (live engine,
+// optimizer). Each process claims one slot in a POSIX shm segment and
+// publishes a snapshot of its counters under a per-slot seqlock; the
+// `ofi_monitor` tool maps the segment read-only and renders the slots.
+// Publishing is a handful of relaxed stores bracketed by two sequence
+// bumps: no syscalls, no locks, and a reader can never stall the writer.
+
+// name, type
+#define OFI_TELEMETRY_FIELDS(X)  \
+  X(events,      std::uint64_t)  \
+  X(signals,     std::uint64_t)  \
+  X(fills,       std::uint64_t)  \
+  X(ring_depth,  std::uint64_t)  \
+  X(max_depth,   std::uint64_t)  \
+  X(conflating,  std::uint64_t)  \
+  X(lat_p50_ns,  std::uint64_t)  \
+  X(lat_p99_ns,  std::uint64_t)  \
+  X(lat_max_ns,  std::uint64_t)  \
+  X(pnl,         double)         \
+  X(done,        std::uint64_t)  \
+  X(total,       std::uint64_t)
+
+// One snapshot as the publisher fills it in and the monitor reads it back.
+struct TelemetryValues {
+#define OFI_TELEMETRY_MEMBER(name, type) type name{};
+  OFI_TELEMETRY_FIELDS(OFI_TELEMETRY_MEMBER)
+#undef OFI_TELEMETRY_MEMBER
+  std::int64_t heartbeat_ns = 0;   // TscClock::now_ns() at publish
+};
+
+enum class TelemetryField : std::uint32_t {
+#define OFI_TELEMETRY_ENUM(name, type) name,
+  OFI_TELEMETRY_FIELDS(OFI_TELEMETRY_ENUM)
+#undef OFI_TELEMETRY_ENUM
+  Count
+};
+
+inline constexpr const char*   kTelemetrySegment = "/ofi_telemetry";
+inline constexpr std::uint64_t kTelemetryMagic   = 0x4f46495f544c4d31ull;   // "OFI_TLM1"
+inline constexpr std::uint32_t kTelemetryVersion = 1;
+inline constexpr std::uint32_t kTelemetrySlots   = 16;
+inline constexpr std::uint32_t kTelemetryFields  = static_cast<std::uint32_t>(TelemetryField::Count);
+
+// Slot layout in the segment. Everything a reader touches is an atomic so
+// the seqlock is race-free under the C++ memory model; doubles travel as bits.
+struct alignas(64) TelemetrySlot {
+  std::atomic<std::uint32_t> seq{0};         // odd while a write is in progress
+  std::atomic<std::int32_t>  owner_pid{0};   // 0 = free
+  char                       name[48]{};     // written once, before owner_pid is published
+  std::atomic<std::int64_t>  heartbeat_ns{0};
+  std::atomic<std::uint64_t> v[kTelemetryFields]{};
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "shared slots need lock-free atomics");
+
+struct TelemetrySegment {
+  std::atomic<std::uint64_t> magic{0};
+  std::uint32_t version = 0;
+  std::uint32_t nslots  = 0;
+  std::uint32_t nfields = 0;
+  alignas(64) TelemetrySlot slots[kTelemetrySlots];
+};
+
+inline void telemetry_store(TelemetrySlot& s, const TelemetryValues& x) {
+  const std::uint32_t q = s.seq.load(std::memory_order_relaxed);
+  s.seq.store(q + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  std::uint32_t k = 0;
+#define OFI_TELEMETRY_STORE(name, type) \
+  s.v[k++].store(std::bit_cast<std::uint64_t>(x.name), std::memory_order_relaxed);
+  OFI_TELEMETRY_FIELDS(OFI_TELEMETRY_STORE)
+#undef OFI_TELEMETRY_STORE
+  s.heartbeat_ns.store(x.heartbeat_ns, std::memory_order_relaxed);
+  s.seq.store(q + 2, std::memory_order_release);
+}
+
+// consistent snapshot of a slot; false if the writer kept it busy
+inline bool telemetry_load(const TelemetrySlot& s, TelemetryValues& out, int max_tries = 64) {
+  for (int t = 0; t < max_tries; ++t) {
+    const std::uint32_t q0 = s.seq.load(std::memory_order_acquire);
+    if (q0 & 1u) continue;
+    TelemetryValues x;
+    std::uint32_t k = 0;
+#define OFI_TELEMETRY_LOAD(name, type) \
+    x.name = std::bit_cast<type>(s.v[k++].load(std::memory_order_relaxed));
+    OFI_TELEMETRY_FIELDS(OFI_TELEMETRY_LOAD)
+#undef OFI_TELEMETRY_LOAD
+    x.heartbeat_ns = s.heartbeat_ns.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (s.seq.load(std::memory_order_relaxed) == q0) { out = x; return true; }
+  }
+  return false;
+}
+
+// Writer side: maps the segment (creating it if needed) and claims a slot.
+// Slots left behind by dead processes are reclaimed.
+class TelemetryPublisher {
+ public:
+  TelemetryPublisher() = default;
+  ~TelemetryPublisher() { close(); }
+  TelemetryPublisher(const TelemetryPublisher&) = delete;
+  TelemetryPublisher& operator=(const TelemetryPublisher&) = delete;
+
+  // false if shared memory is unavailable or every slot is taken
+  bool open(const std::string& label, const std::string& segment = kTelemetrySegment);
+  void close();   // frees the slot
+
+  bool attached() const { return slot != nullptr; }
+  void publish(const TelemetryValues& x) {
+    if (slot) telemetry_store(*slot, x);
+  }
+
+ private:
+  TelemetrySegment* seg = nullptr;
+  TelemetrySlot*    slot = nullptr;
+};
+
+// Reader side for the monitor: read-only mapping of an existing segment.
+class TelemetryReader {
+ public:
+  TelemetryReader() = default;
+  ~TelemetryReader();
+  TelemetryReader(const TelemetryReader&) = delete;
+  TelemetryReader& operator=(const TelemetryReader&) = delete;
+
+  bool open(const std::string& segment = kTelemetrySegment);
+  const TelemetrySegment* segment() const { return seg; }
+
+ private:
+  const TelemetrySegment* seg = nullptr;
+};
+
+// true if `pid` names a live process
+bool telemetry_pid_alive(std::int32_t pid);
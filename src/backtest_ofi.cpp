@@ -7,56 +7,105 @@
 #include <vector>
 #include <cmath>
 
+#include "common/Counters.hpp"
+#include "common/Rth.hpp"
+#include "common/SessionBuckets.hpp"
 #include "common/Types.hpp"
+#include "data/DbnDepth.hpp"
+#include "data/DayMerge.hpp"
 #include "data/DbnReader.hpp"
+#include "data/TradeSign.hpp"
+#include "log/BinLog.hpp"
+#include "strategy/MakerOfi.hpp"
 #include "strategy/QueueOfi.hpp"
 
-// --- merge, same as in smoke.cpp ---
-static std::vector<Event> merge_streams(const std::vector<QuoteL1>& qs,
-                                        const std::vector<Trade>& ts) {
-  std::vector<Event> ev;
-  ev.reserve(qs.size() + ts.size());
-  size_t i = 0, j = 0;
-  while (i < qs.size() || j < ts.size()) {
-    bool take_q = (j == ts.size()) || (i < qs.size() && qs[i].ts <= ts[j].ts);
-    if (take_q) { Event e; e.type = EvType::Quote; e.ts = qs[i].ts; e.q = qs[i]; ev.push_back(e); ++i; }
-    else        { Event e; e.type = EvType::Trade; e.ts = ts[j].ts; e.t = ts[j]; ev.push_back(e); ++j; }
-  }
-  return ev;
-}
-
-static double sharpe_annualized(const std::vector<double>& rets) {
-  if (rets.size() < 2) return 0.0;
-  double mean = std::accumulate(rets.begin(), rets.end(), 0.0) / rets.size();
-  double var = 0.0;
-  for (double r : rets) var += (r - mean) * (r - mean);
-  var /= (rets.size() - 1);
-  double sd = std::sqrt(std::max(1e-12, var));
-  const double trades_per_year = 60.0 * 252.0;
-  return (mean / sd) * std::sqrt(trades_per_year);
-}
-
-// RTH for Oct 2023 (EDT=UTC-4): 09:30–16:00 ET => 13:30–20:00 UTC
-static inline bool is_rth_utc(TsNanos ts_ns) {
-  const long long sec = ts_ns / 1'000'000'000LL;
-  const long long sec_in_day = sec % 86400LL;
-  return (sec_in_day >= 48600LL) && (sec_in_day < 72000LL);
-}
-
 int main(int argc, char** argv) {
-  std::string ymd = (argc > 1) ? argv[1] : "20231002";
+  std::string ymd = "20231002";
+  std::string log_path;   // --log=FILE: binary signal/fill log (render with binlog_decode)
+  std::int64_t bucket_min = 30;   // --bucket-min=N: width of the time-of-day breakdown
+  // --queue-fill: entries rest in the L1 queue instead of filling at once
+  bool queue_fill = false;
+  double cancel_ahead = 0.5;
+  std::int64_t queue_wait_ms = 1000;
+  // --maker: resting entries/exits through OrderSim (cancel/replace, ack latency)
+  bool maker = false;
+  bool maker_improve = true;
+  std::int64_t latency_us = 150;
+  // --lots=N sizes entries; --depth walks MBP-10 levels for aggressive fills
+  QtyI lots = 1;
+  bool use_depth = false;
+  // --alpha-rls: enter on the online RLS prediction instead of the thresholds
+  bool alpha_rls = false;
+  double alpha_cost = 0.5, alpha_lambda = 0.9995;
+  std::int64_t alpha_horizon_ms = 100;
+  // --raw-side keeps Unknown prints as the feed sent them
+  bool raw_side = false;
+  for (int i = 1; i < argc; ++i) {
+    const std::string a = argv[i];
+    if (a.rfind("--log=", 0) == 0)               log_path = a.substr(6);
+    else if (a.rfind("--bucket-min=", 0) == 0)   bucket_min = std::stoll(a.substr(13));
+    else if (a == "--queue-fill")                queue_fill = true;
+    else if (a.rfind("--cancel-ahead=", 0) == 0) cancel_ahead = std::stod(a.substr(15));
+    else if (a.rfind("--queue-wait-ms=", 0) == 0) queue_wait_ms = std::stoll(a.substr(16));
+    else if (a == "--maker")                     maker = true;
+    else if (a == "--no-improve")                maker_improve = false;
+    else if (a.rfind("--latency-us=", 0) == 0)   latency_us = std::stoll(a.substr(13));
+    else if (a.rfind("--lots=", 0) == 0)         lots = static_cast<QtyI>(std::stoi(a.substr(7)));
+    else if (a == "--depth")                     use_depth = true;
+    else if (a == "--alpha-rls")                 alpha_rls = true;
+    else if (a == "--raw-side")                  raw_side = true;
+    else if (a.rfind("--alpha-cost=", 0) == 0)   alpha_cost = std::stod(a.substr(13));
+    else if (a.rfind("--alpha-lambda=", 0) == 0) alpha_lambda = std::stod(a.substr(15));
+    else if (a.rfind("--alpha-horizon-ms=", 0) == 0) alpha_horizon_ms = std::stoll(a.substr(19));
+    else if (a.size() == 8 && std::all_of(a.begin(), a.end(), [](char c) { return c >= '0' && c <= '9'; }))
+                                                 ymd = a;
+    else {
+      std::cerr << "Unknown argument: " << a << "\n"
+                << "Usage: backtest_ofi [YYYYMMDD] [--log=FILE] [--bucket-min=N] [--queue-fill] [--cancel-ahead=F]\n"
+                   "                    [--queue-wait-ms=N] [--maker] [--no-improve] [--latency-us=N] [--lots=N]\n"
+                   "                    [--depth] [--alpha-rls] [--alpha-cost=F] [--alpha-lambda=F]\n"
+                   "                    [--alpha-horizon-ms=N] [--raw-side]\n";
+      return 1;
+    }
+  }
+  if (queue_fill && lots > 1) {
+    std::cerr << "--queue-fill models a single 1-lot order; it cannot be combined with --lots=" << lots << "\n";
+    return 1;
+  }
   const std::string mbp_path = "data/mbp-1/glbx-mdp3-" + ymd + ".mbp-1.dbn.zst";
   const std::string trd_path = "data/trades/glbx-mdp3-" + ymd + ".trades.dbn.zst";
+  const std::string mbp10_path = "data/mbp-10/glbx-mdp3-" + ymd + ".mbp-10.dbn.zst";
 
-  if (!std::filesystem::exists(mbp_path)) {
+  if (use_depth && !std::filesystem::exists(mbp10_path)) {
+    std::cerr << "Missing MBP-10 file: " << mbp10_path << "\n"; return 1;
+  }
+  if (!use_depth && !std::filesystem::exists(mbp_path)) {
     std::cerr << "Missing MBP-1 file: " << mbp_path << "\n"; return 1;
   }
   bool have_trades = std::filesystem::exists(trd_path);
   const std::uint32_t ESZ3_ID = 314863; // ES Dec-2023 in these files
 
-  auto day_q = load_day_from_dbn(mbp_path, "mbp-1", ESZ3_ID);
+  // with --depth the quotes are the MBP-10 tops, so book and signal never disagree
+  std::vector<QuoteL10> depth_day;
+  DayEvents day_q;
+  if (use_depth) {
+    depth_day = load_depth_from_dbn(mbp10_path, ESZ3_ID);
+    day_q.quotes.reserve(depth_day.size());
+    for (const auto& u : depth_day) day_q.quotes.push_back(u.top());
+  } else {
+    day_q = load_day_from_dbn(mbp_path, "mbp-1", ESZ3_ID);
+  }
   DayEvents day_t;
   if (have_trades) day_t = load_day_from_dbn(trd_path, "trades", ESZ3_ID);
+  // sign the prints the feed left Unknown before anything reads them
+  if (!raw_side) {
+    const TradeSignStats ss = infer_aggressors(day_q.quotes, day_t.trades);
+    std::cout << "[sides] prints=" << ss.trades << " feed=" << ss.feed
+              << " by_quote=" << ss.by_quote << " by_tick=" << ss.by_tick
+              << " unresolved=" << ss.unresolved
+              << " inferred%=" << std::fixed << std::setprecision(1) << 100.0 * ss.inferred_frac()
+              << std::defaultfloat << "\n";
+  }
 
   auto ev = merge_streams(day_q.quotes, day_t.trades);
 
@@ -68,6 +117,7 @@ int main(int argc, char** argv) {
   P.theta_imb   = 0.15;    // try 0.10–0.25 later
   P.slip_ticks  = 1;
   P.max_hold_ns = 2'000'000'000LL;   // 2s
+  P.lots        = lots;
 
   // Gates (relaxed):
   P.min_spread_ticks       = 1;               // keep 1-tick spread requirement
@@ -80,44 +130,94 @@ int main(int argc, char** argv) {
   // Assumptions:
   P.fill_at_touch_when_spread1 = true;        // maker-style touch fill
   P.trade_confirm_ns           = 0;           // RELAXED: off for now (was 100ms)
+  P.queue_fill                 = queue_fill;
+  P.queue_cancel_ahead         = cancel_ahead;
+  P.queue_max_wait_ns          = queue_wait_ms * 1'000'000LL;
+  P.alpha_rls                  = alpha_rls;
+  P.alpha_cost_ticks           = alpha_cost;
+  P.alpha_lambda               = alpha_lambda;
+  P.alpha_horizon_ns           = alpha_horizon_ms * 1'000'000LL;
 
-  QueueOfiStrategy strat(P);
+  if (maker) {
+    MakerParams M;
+    M.improve = maker_improve;
+    M.lots = lots;
+    M.sim.to_exchange_ns = M.sim.to_client_ns = latency_us * 1000;
+    M.sim.cancel_ahead = cancel_ahead;
+    MakerOfi mk(P, M);
+    std::vector<double> pnls;
+    double total = 0.0;
+    for (const auto& e : ev) {
+      const double realized = mk.on_event(e);
+      if (realized != 0.0) { pnls.push_back(realized); total += realized; }
+    }
+    // close at end-of-day if still in position, same rule as the taker loop
+    if (mk.position() != 0 && !day_q.quotes.empty()) {
+      const auto& q = day_q.quotes.back();
+      if (!P.rth_only || is_rth_utc(q.ts)) {
+        const double realized = mk.flatten(q);
+        if (realized != 0.0) { pnls.push_back(realized); total += realized; }
+      }
+    }
+    const OrderSimStats& os = mk.sim_stats();
+    const MakerStats& ms = mk.stats();
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Maker fills: " << pnls.size() << "  PnL: $" << total
+              << "  Sharpe~ " << sharpe_annualized(pnls)
+              << "  open_pos=" << mk.position() << "\n";
+    std::cout << "[orders] submits=" << os.submits << " replaces=" << os.replaces
+              << " cancels=" << os.cancels << " fills=" << os.fills
+              << " taker_fills=" << os.taker_fills << " rejects=" << os.rejects
+              << " too_late=" << os.too_late << " priority_resets=" << os.priority_resets
+              << " max_live=" << os.max_live << " table=" << mk.table_capacity() << "\n";
+    std::cout << "[maker] entries=" << ms.entries << " entry_cancels=" << ms.entry_cancels
+              << " repegs=" << ms.repegs << " passive_exits=" << ms.exits
+              << " take_exits=" << ms.take_exits << " round_trips=" << ms.round_trips
+              << " latency_us=" << latency_us << "\n";
+    print_funnel(std::cout, mk.signal_counters());   // gates and debounce only; the maker's fills are above
+    return 0;
+  }
 
-  // ---- Diagnostics ----
-  std::size_t q_total = 0;
-  std::size_t q_rth   = 0;
-  std::size_t q_sp1   = 0;
-  std::size_t q_sizeok= 0;
-  std::size_t sig_nonempty = 0;
-  std::size_t fills = 0;
+  QueueOfiStrategy strat(P);
+  DepthBook book;
+  std::size_t depth_i = 0;
+  if (use_depth) strat.attach_depth(&book);
+  if (!log_path.empty() && !BinLog::start(log_path)) {
+    std::cerr << "Cannot open log file: " << log_path << "\n"; return 1;
+  }
 
   std::vector<double> trade_pnls; trade_pnls.reserve(2048);
   double running_pnl = 0.0;
+  SessionBuckets tod(bucket_min * 60);
 
   for (const auto& e : ev) {
 
+    // timers run on every event, so hold exits fire even while the gates below reject quotes
+    const double timed = strat.advance(e.ts);
+    if (timed != 0.0) {
+      running_pnl += timed; trade_pnls.push_back(timed); tod.add(e.ts, timed);
+      OFI_LOG(TimerExit, e.ts, timed);
+    }
+
     if (e.type == EvType::Trade) strat.on_trade(e.t);
     
     if (e.type == EvType::Quote) {
-      ++q_total;
-
-      if (P.rth_only && !is_rth_utc(e.ts)) continue;
-      ++q_rth;
-
-      // mirror the main structural gates for visibility
-      const bool spread_is_one = std::fabs((e.q.ask_px - e.q.bid_px) - P.tick_size) <= 1e-9;
-      if (!spread_is_one) continue;
-      ++q_sp1;
-
-      if (e.q.bid_sz < P.min_bid_sz || e.q.ask_sz < P.min_ask_sz) continue;
-      ++q_sizeok;
+      if (use_depth) book.apply(depth_day[depth_i++]);   // quotes are depth tops, in order
+      strat.mark(e.q);
+      if (!strat.admit(e.q)) continue;   // RTH / spread / size, tallied in strat.counters()
 
       auto sig = strat.on_quote(e.q);
-      if (sig.has_value()) ++sig_nonempty;
+      if (sig.has_value()) {
+        OFI_LOG(Signal, e.ts, *sig, strat.ofi(), strat.imbalance_ticks());
+      }
 
       const double mid = 0.5 * (e.q.bid_px + e.q.ask_px);
+      const int closed_side = strat.pos().side;   // a fill closes this one, even on a flip
       double realized = strat.act_and_fill(e.ts, mid, sig);
-      if (realized != 0.0) { running_pnl += realized; trade_pnls.push_back(realized); ++fills; }
+      if (realized != 0.0) {
+        running_pnl += realized; trade_pnls.push_back(realized); tod.add(e.ts, realized);
+        OFI_LOG(Fill, e.ts, realized, closed_side);
+      }
     } else {
       // Optional: feed trades if you later re-enable trade_confirm_ns > 0
       // strat.on_trade(e.t);
@@ -129,11 +229,22 @@ int main(int argc, char** argv) {
     const auto& q = day_q.quotes.back();
     if (!P.rth_only || is_rth_utc(q.ts)) {
       const double mid = 0.5 * (q.bid_px + q.ask_px);
+      const int closed_side = strat.pos().side;
       double realized = strat.act_and_fill(q.ts, mid, 0);
-      if (realized != 0.0) { running_pnl += realized; trade_pnls.push_back(realized); ++fills; }
+      if (realized != 0.0) {
+        running_pnl += realized; trade_pnls.push_back(realized); tod.add(q.ts, realized);
+        OFI_LOG(Fill, q.ts, realized, closed_side);
+      }
     }
   }
 
+  OFI_LOG(DayDone, trade_pnls.size(), running_pnl);
+  if (BinLog::enabled()) {
+    BinLog::stop();
+    std::cout << "[log] " << log_path << " records=" << BinLog::written()
+              << " dropped=" << BinLog::dropped() << "\n";
+  }
+
   // stats
   double sharpe = sharpe_annualized(trade_pnls);
   int wins = 0; for (double x : trade_pnls) if (x > 0) ++wins;
@@ -144,14 +255,46 @@ int main(int argc, char** argv) {
             << "  PnL: $" << running_pnl
             << "  Sharpe~ " << sharpe << "\n";
 
-  // diagnostics
-  std::cout << "[diag] quotes_total=" << q_total
-            << " rth=" << q_rth
-            << " spread1=" << q_sp1
-            << " size_ok=" << q_sizeok
-            << " sig_nonempty=" << sig_nonempty
-            << " fills=" << fills
-            << "\n";
+  if (P.queue_fill) {
+    const QueueFillStats& qs = strat.queue_stats();
+    std::cout << "[queue] entries=" << qs.placed
+              << " filled=" << qs.filled
+              << " traded_through=" << qs.traded_through
+              << " expired=" << qs.expired
+              << " cancelled=" << qs.cancelled
+              << " fill%=" << qs.fill_rate()
+              << " cancel_ahead=" << P.queue_cancel_ahead << "\n";
+  }
+
+  if (use_depth) {
+    const DepthFillStats& ds = strat.depth_stats();
+    std::cout << "[depth] lots=" << P.lots
+              << " takes=" << ds.takes
+              << " partial=" << ds.partial
+              << " filled=" << ds.lots_filled << "/" << ds.lots_wanted
+              << " avg_levels=" << ds.avg_levels()
+              << " slip_ticks/lot=" << ds.avg_slip_ticks() << "\n";
+  }
+
+  if (P.alpha_rls) {
+    const AlphaModel& am = strat.alpha_model();
+    const AlphaStats& as = am.stats();
+    std::cout << "[alpha] samples=" << as.samples
+              << " dropped=" << as.dropped
+              << " oos_r2=" << std::setprecision(4) << as.r2()
+              << " w=[";
+    for (std::size_t i = 0; i < AlphaModel::kFeatures; ++i) std::cout << (i ? " " : "") << am.weights()[i];
+    std::cout << "]" << std::setprecision(2)
+              << " horizon_ms=" << alpha_horizon_ms
+              << " cost_ticks=" << P.alpha_cost_ticks << "\n";
+  }
+
+  // time of day and weekday, non-empty buckets only
+  print_buckets(std::cout, tod);
+
+  // diagnostics: the strategy's gate funnel, then what the loaders dropped
+  print_funnel(std::cout, strat.counters());
+  print_load_counters(std::cout, CounterRegistry::total());
 
   return 0;
 }
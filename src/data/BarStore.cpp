@@ -0,0 +1,68 @@
+#include "data/BarStore.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+namespace {
+constexpr std::uint32_t kColumns = 0
+#define OFI_BAR_COUNT(name, type) + 1
+    OFI_BAR_COLUMNS(OFI_BAR_COUNT)
+#undef OFI_BAR_COUNT
+    ;
+constexpr std::uintmax_t kRowBytes = 0
+#define OFI_BAR_WIDTH(name, type) + sizeof(type)
+    OFI_BAR_COLUMNS(OFI_BAR_WIDTH)
+#undef OFI_BAR_WIDTH
+    ;
+}  // namespace
+
+std::string bar_file_path(const std::string& dir, const std::string& ymd, std::int64_t bar_ns) {
+  return dir + "/" + ymd + "." + bar_size_label(bar_ns) + ".bars";
+}
+
+bool write_bars(const std::string& path, const BarColumns& bars) {
+  const std::string tmp = path + ".tmp";
+  std::FILE* f = std::fopen(tmp.c_str(), "wb");
+  if (!f) return false;
+  BarFileHeader h;
+  h.columns = kColumns;
+  h.bar_ns  = bars.bar_ns;
+  h.rows    = bars.size();
+  bool ok = std::fwrite(&h, sizeof(h), 1, f) == 1;
+#define OFI_BAR_WRITE(name, type) \
+  ok = ok && (bars.name.empty() || std::fwrite(bars.name.data(), sizeof(type), bars.name.size(), f) == bars.name.size());
+  OFI_BAR_COLUMNS(OFI_BAR_WRITE)
+#undef OFI_BAR_WRITE
+  ok = (std::fclose(f) == 0) && ok;
+  std::error_code ec;
+  if (ok) std::filesystem::rename(tmp, path, ec);
+  if (!ok || ec) std::filesystem::remove(tmp, ec);
+  return ok && !ec;
+}
+
+bool read_bars(const std::string& path, BarColumns& bars) {
+  std::FILE* f = std::fopen(path.c_str(), "rb");
+  if (!f) return false;
+  BarFileHeader h, want;
+  bool ok = std::fread(&h, sizeof(h), 1, f) == 1 &&
+            std::memcmp(h.magic, want.magic, sizeof(h.magic)) == 0 &&
+            h.version == want.version && h.columns == kColumns;
+  // the header's row count must match what the file actually holds
+  std::error_code ec;
+  const auto size = std::filesystem::file_size(path, ec);
+  ok = ok && !ec && size >= sizeof(h) && (size - sizeof(h)) / kRowBytes == h.rows &&
+       (size - sizeof(h)) % kRowBytes == 0;
+  if (ok) {
+    bars = BarColumns{};
+    bars.bar_ns = h.bar_ns;
+    const std::size_t n = static_cast<std::size_t>(h.rows);
+#define OFI_BAR_READ(name, type) \
+    bars.name.resize(n);         \
+    ok = ok && (n == 0 || std::fread(bars.name.data(), sizeof(type), n, f) == n);
+    OFI_BAR_COLUMNS(OFI_BAR_READ)
+#undef OFI_BAR_READ
+  }
+  std::fclose(f);
+  return ok;
+}
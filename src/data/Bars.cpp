@@ -0,0 +1,187 @@
+#include "data/Bars.hpp"
+#include "common/L1Ofi.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+void BarColumns::push_back(const Bar& b) {
+#define OFI_BAR_PUSH(name, type) name.push_back(b.name);
+  OFI_BAR_COLUMNS(OFI_BAR_PUSH)
+#undef OFI_BAR_PUSH
+}
+
+Bar BarColumns::row(std::size_t i) const {
+  Bar b;
+#define OFI_BAR_ROW(name, type) b.name = name[i];
+  OFI_BAR_COLUMNS(OFI_BAR_ROW)
+#undef OFI_BAR_ROW
+  return b;
+}
+
+void BarColumns::reserve(std::size_t n) {
+#define OFI_BAR_RESERVE(name, type) name.reserve(n);
+  OFI_BAR_COLUMNS(OFI_BAR_RESERVE)
+#undef OFI_BAR_RESERVE
+}
+
+std::size_t BarColumns::bytes() const {
+  std::size_t n = 0;
+#define OFI_BAR_BYTES(name, type) n += name.size() * sizeof(type);
+  OFI_BAR_COLUMNS(OFI_BAR_BYTES)
+#undef OFI_BAR_BYTES
+  return n;
+}
+
+std::int64_t parse_bar_size(const std::string& s) {
+  std::size_t pos = 0;
+  long long n = 0;
+  try { n = std::stoll(s, &pos); } catch (...) { return 0; }
+  if (n <= 0) return 0;
+  const std::string unit = s.substr(pos);
+  if (unit == "ms") return n * 1'000'000LL;
+  if (unit == "s")  return n * 1'000'000'000LL;
+  if (unit == "m")  return n * 60'000'000'000LL;
+  if (unit == "h")  return n * 3'600'000'000'000LL;
+  return 0;
+}
+
+std::string bar_size_label(std::int64_t bar_ns) {
+  if (bar_ns % 3'600'000'000'000LL == 0) return std::to_string(bar_ns / 3'600'000'000'000LL) + "h";
+  if (bar_ns % 60'000'000'000LL == 0)    return std::to_string(bar_ns / 60'000'000'000LL) + "m";
+  if (bar_ns % 1'000'000'000LL == 0)     return std::to_string(bar_ns / 1'000'000'000LL) + "s";
+  return std::to_string(bar_ns / 1'000'000LL) + "ms";
+}
+
+namespace {
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+inline void open_prices(Bar& b, double mid, double micro) {
+  b.mid_o = b.mid_h = b.mid_l = b.mid_c = mid;
+  b.micro_o = b.micro_h = b.micro_l = b.micro_c = micro;
+}
+
+inline void extend_prices(Bar& b, double mid_h, double mid_l, double mid_c,
+                          double micro_h, double micro_l, double micro_c) {
+  b.mid_h = std::max(b.mid_h, mid_h);
+  b.mid_l = std::min(b.mid_l, mid_l);
+  b.mid_c = mid_c;
+  b.micro_h = std::max(b.micro_h, micro_h);
+  b.micro_l = std::min(b.micro_l, micro_l);
+  b.micro_c = micro_c;
+}
+
+// finest resolution, straight from the events
+BarColumns scan(std::span<const Event> ev, std::int64_t bar_ns) {
+  BarColumns out;
+  out.bar_ns = bar_ns;
+  if (!ev.empty()) out.reserve(std::min(ev.size(), std::size_t((ev.back().ts - ev.front().ts) / bar_ns + 2)));
+
+  Bar b;
+  bool open = false;
+  TsNanos cur = 0;
+  double last_mid = kNaN, last_micro = kNaN;
+  QuoteL1 prev{};
+  bool have_prev = false;
+
+  for (const Event& e : ev) {
+    const TsNanos start = e.ts - e.ts % bar_ns;
+    if (!open || start != cur) {
+      if (open) {
+        if (b.quotes == 0) open_prices(b, last_mid, last_micro);   // no quote: previous close
+        out.push_back(b);
+      }
+      b = Bar{};
+      b.ts = start;
+      cur = start;
+      open = true;
+    }
+    if (e.type == EvType::Trade) {
+      ++b.trades;
+      const std::int64_t sz = e.t.sz;
+      b.buy_vol   += e.t.side == Aggressor::Buy  ? sz : 0;
+      b.sell_vol  += e.t.side == Aggressor::Sell ? sz : 0;
+      b.other_vol += e.t.side == Aggressor::Unknown ? sz : 0;
+      continue;
+    }
+
+    const QuoteL1& q = e.q;
+    const double mid = 0.5 * (q.bid_px + q.ask_px);
+    const double bsz = std::max<QtyI>(1, q.bid_sz), asz = std::max<QtyI>(1, q.ask_sz);
+    const double micro = (q.ask_px * bsz + q.bid_px * asz) / (asz + bsz);
+    if (b.quotes++ == 0) open_prices(b, mid, micro);
+    else                 extend_prices(b, mid, mid, mid, micro, micro, micro);
+    last_mid = mid;
+    last_micro = micro;
+
+    // same L1 OFI as QueueOfiStrategy, before its EWMA
+    if (have_prev) b.ofi += l1_ofi(prev, q);
+    prev = q;
+    have_prev = true;
+  }
+  if (open) {
+    if (b.quotes == 0) open_prices(b, last_mid, last_micro);   // no quote: previous close
+    out.push_back(b);
+  }
+  return out;
+}
+
+// coarser bars from finer ones; OHLC only from fine bars that had quotes,
+// so carried prices never widen a range (OFI sums are whole numbers: exact)
+BarColumns rollup(const BarColumns& fine, std::int64_t bar_ns) {
+  BarColumns out;
+  out.bar_ns = bar_ns;
+  if (fine.size()) out.reserve(std::min(fine.size(), std::size_t((fine.ts.back() - fine.ts.front()) / bar_ns + 2)));
+
+  Bar b;
+  bool open = false;
+  TsNanos cur = 0;
+  double last_mid = kNaN, last_micro = kNaN;
+  for (std::size_t i = 0; i < fine.size(); ++i) {
+    const TsNanos start = fine.ts[i] - fine.ts[i] % bar_ns;
+    if (!open || start != cur) {
+      if (open) {
+        if (b.quotes == 0) open_prices(b, last_mid, last_micro);   // no quote: previous close
+        out.push_back(b);
+      }
+      b = Bar{};
+      b.ts = start;
+      cur = start;
+      open = true;
+    }
+    b.buy_vol   += fine.buy_vol[i];
+    b.sell_vol  += fine.sell_vol[i];
+    b.other_vol += fine.other_vol[i];
+    b.trades    += fine.trades[i];
+    b.ofi       += fine.ofi[i];
+    if (fine.quotes[i] == 0) continue;
+    if (b.quotes == 0) {
+      b.mid_o = fine.mid_o[i];     b.mid_h = fine.mid_h[i];     b.mid_l = fine.mid_l[i];
+      b.micro_o = fine.micro_o[i]; b.micro_h = fine.micro_h[i]; b.micro_l = fine.micro_l[i];
+      b.mid_c = fine.mid_c[i];     b.micro_c = fine.micro_c[i];
+    } else {
+      extend_prices(b, fine.mid_h[i], fine.mid_l[i], fine.mid_c[i],
+                    fine.micro_h[i], fine.micro_l[i], fine.micro_c[i]);
+    }
+    b.quotes += fine.quotes[i];
+    last_mid = fine.mid_c[i];
+    last_micro = fine.micro_c[i];
+  }
+  if (open) {
+    if (b.quotes == 0) open_prices(b, last_mid, last_micro);   // no quote: previous close
+    out.push_back(b);
+  }
+  return out;
+}
+}  // namespace
+
+std::vector<BarColumns> build_bars(std::span<const Event> ev, const std::vector<std::int64_t>& bar_ns) {
+  std::vector<BarColumns> out(bar_ns.size());
+  if (bar_ns.empty()) return out;
+  const std::size_t finest = static_cast<std::size_t>(
+      std::min_element(bar_ns.begin(), bar_ns.end()) - bar_ns.begin());
+  out[finest] = scan(ev, bar_ns[finest]);
+  for (std::size_t i = 0; i < bar_ns.size(); ++i)
+    if (i != finest) out[i] = bar_ns[i] == bar_ns[finest] ? out[finest] : rollup(out[finest], bar_ns[i]);
+  return out;
+}
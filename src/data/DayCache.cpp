@@ -0,0 +1,118 @@
+#include "data/DayCache.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+std::shared_ptr<const DayData> DayCache::get(const std::string& ymd, const Loader& loader) {
+  std::promise<std::shared_ptr<const DayData>> prom;
+  {
+    std::unique_lock<std::mutex> lk(mu);
+    auto it = entries.find(ymd);
+    if (it != entries.end()) {
+      ++st.hits;
+      Entry& e = it->second;
+      e.last_use = ++clock;
+      e.h = inflation + e.cost;
+      auto fut = e.day;
+      lk.unlock();       // another thread may still be decoding it
+      return fut.get();
+    }
+    ++st.misses;
+    Entry e;
+    e.day = prom.get_future().share();
+    e.last_use = ++clock;
+    entries.emplace(ymd, std::move(e));
+  }
+
+  const auto t0 = std::chrono::steady_clock::now();
+  std::shared_ptr<const DayData> day;
+  try {
+    day = std::make_shared<const DayData>(loader(ymd));
+  } catch (...) {
+    {
+      std::lock_guard<std::mutex> lk(mu);
+      entries.erase(ymd);
+    }
+    prom.set_exception(std::current_exception());
+    throw;
+  }
+  const auto dt = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now() - t0).count();
+  prom.set_value(day);
+
+  std::lock_guard<std::mutex> lk(mu);
+  const std::size_t b = day->bytes();
+  st.bytes_decoded += b;
+  st.decode_ns += dt;
+
+  auto it = entries.find(ymd);
+  if (it != entries.end()) {
+    Entry& e = it->second;
+    e.bytes = b;
+    e.ready = true;
+    e.cost  = double(dt) / double(std::max<std::size_t>(1, b));
+    e.h     = inflation + e.cost;
+    st.resident_bytes += b;
+    st.peak_bytes = std::max(st.peak_bytes, st.resident_bytes);
+    evict_to_budget_locked(ymd);
+  }
+  return day;
+}
+
+void DayCache::evict_to_budget_locked(const std::string& keep) {
+  while (st.resident_bytes > budget) {
+    auto victim = entries.end();
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+      if (!it->second.ready || it->first == keep) continue;
+      if (victim == entries.end()) { victim = it; continue; }
+      const bool older = (policy == EvictPolicy::Lru)
+                             ? it->second.last_use < victim->second.last_use
+                             : it->second.h < victim->second.h;
+      if (older) victim = it;
+    }
+    if (victim == entries.end()) {
+      // only the day just loaded is left and it alone exceeds the budget
+      auto self = entries.find(keep);
+      if (self != entries.end() && self->second.bytes > budget) {
+        st.resident_bytes -= self->second.bytes;
+        entries.erase(self);
+        ++st.evictions;
+      }
+      return;
+    }
+    if (policy == EvictPolicy::CostAware) inflation = victim->second.h;
+    st.resident_bytes -= victim->second.bytes;
+    entries.erase(victim);
+    ++st.evictions;
+  }
+}
+
+bool DayCache::resident(const std::string& ymd) const {
+  std::lock_guard<std::mutex> lk(mu);
+  return entries.count(ymd) != 0;
+}
+
+std::vector<std::string> DayCache::schedule(const std::vector<std::string>& days) const {
+  std::vector<std::pair<std::uint64_t, std::string>> hot;
+  std::vector<std::string> cold;
+  {
+    std::lock_guard<std::mutex> lk(mu);
+    for (const auto& d : days) {
+      auto it = entries.find(d);
+      if (it != entries.end()) hot.emplace_back(it->second.last_use, d);
+      else                     cold.push_back(d);
+    }
+  }
+  std::sort(hot.begin(), hot.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+  std::vector<std::string> out;
+  out.reserve(days.size());
+  for (auto& [_, d] : hot) out.push_back(std::move(d));
+  for (auto& d : cold)     out.push_back(std::move(d));
+  return out;
+}
+
+DayCacheStats DayCache::stats() const {
+  std::lock_guard<std::mutex> lk(mu);
+  return st;
+}
@@ -0,0 +1,23 @@
+#include "data/DayMerge.hpp"
+#include "data/TradeSign.hpp"
+
+std::vector<Event> merge_streams(std::span<const QuoteL1> qs, std::span<const Trade> ts) {
+  std::vector<Event> ev;
+  ev.reserve(qs.size() + ts.size());
+  std::size_t i = 0, j = 0;
+  while (i < qs.size() || j < ts.size()) {
+    const bool take_q = (j == ts.size()) || (i < qs.size() && qs[i].ts <= ts[j].ts);
+    if (take_q) { Event e; e.type = EvType::Quote; e.ts = qs[i].ts; e.q = qs[i]; ev.push_back(e); ++i; }
+    else        { Event e; e.type = EvType::Trade; e.ts = ts[j].ts; e.t = ts[j]; ev.push_back(e); ++j; }
+  }
+  return ev;
+}
+
+DayData make_day(const DayEvents& quotes, DayEvents& trades) {
+  infer_aggressors(quotes.quotes, trades.trades);
+  DayData d;
+  d.events = merge_streams(quotes.quotes, trades.trades);
+  d.has_quotes = !quotes.quotes.empty();
+  if (d.has_quotes) d.last_quote = quotes.quotes.back();
+  return d;
+}
@@ -0,0 +1,67 @@
+#include "data/SyntheticDay.hpp"
+
+#include <algorithm>
+#include <random>
+
+std::vector<Event> synthetic_day(const SyntheticOptions& o) {
+  std::mt19937_64 rng(o.seed);
+  std::uniform_real_distribution<double> U(0.0, 1.0);
+  std::exponential_distribution<double>  gap(1.0);
+  std::geometric_distribution<int>       dsz(0.3);
+  std::uniform_int_distribution<int>     fresh(5, 60);
+
+  std::vector<Event> out;
+  out.reserve(o.events);
+
+  QuoteL1 q;
+  q.bid_px = o.start_px;
+  q.ask_px = o.start_px + o.tick_size;
+  q.bid_sz = fresh(rng);
+  q.ask_sz = fresh(rng);
+
+  double t = static_cast<double>(o.start_ts);
+  std::size_t burst_left = 0;
+
+  for (std::size_t i = 0; i < o.events; ++i) {
+    if (burst_left == 0 && U(rng) < o.burst_prob)
+      burst_left = 1 + static_cast<std::size_t>(gap(rng) * double(o.burst_len));
+    const double rate = burst_left ? o.rate_per_s * o.burst_mult : o.rate_per_s;
+    if (burst_left) --burst_left;
+    t += gap(rng) * 1e9 / rate;
+    const auto ts = static_cast<TsNanos>(t);
+
+    Event e;
+    e.ts = ts;
+    if (U(rng) < o.trade_frac) {
+      // aggressor hits the touch and depletes it
+      const bool buy = U(rng) < 0.5;
+      e.type = EvType::Trade;
+      e.t.ts   = ts;
+      e.t.px   = buy ? q.ask_px : q.bid_px;
+      e.t.sz   = 1 + dsz(rng);
+      e.t.side = buy ? Aggressor::Buy : Aggressor::Sell;
+      QtyI& sz = buy ? q.ask_sz : q.bid_sz;
+      sz -= std::min(sz, e.t.sz);
+      out.push_back(e);
+      if (sz > 0) continue;
+      // level cleared: the book shifts one tick in the aggressor's direction
+      const double step = buy ? o.tick_size : -o.tick_size;
+      q.bid_px += step;
+      q.ask_px += step;
+      (buy ? q.bid_sz : q.ask_sz) = fresh(rng);
+      (buy ? q.ask_sz : q.bid_sz) = fresh(rng);
+      e = Event{};
+      e.ts = ts;
+    } else {
+      // add or cancel at one side of the touch
+      QtyI& sz = (U(rng) < 0.5) ? q.bid_sz : q.ask_sz;
+      const QtyI d = 1 + dsz(rng);
+      sz = (U(rng) < 0.52) ? sz + d : std::max<QtyI>(1, sz - d);
+    }
+    e.type = EvType::Quote;
+    q.ts = ts;
+    e.q = q;
+    out.push_back(e);
+  }
+  return out;
+}
@@ -0,0 +1,93 @@
+#include "data/TradeSign.hpp"
+#include "common/Counters.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+// +1 buy / -1 sell / 0 at mid
+inline int quote_rule(double px, const QuoteL1& q) {
+  const double mid = 0.5 * (q.bid_px + q.ask_px);
+  return (px > mid) - (px < mid);
+}
+
+inline Aggressor side_of(int s) { return s > 0 ? Aggressor::Buy : Aggressor::Sell; }
+
+// quote-rule sign (0 = at mid or no quote) and running tick -> side + stats
+inline void resolve(Trade& t, int by_quote, int tick, TradeSignStats& st) {
+  ++st.trades;
+  if (t.side != Aggressor::Unknown) { ++st.feed; return; }
+  if (by_quote != 0)  { t.side = side_of(by_quote); ++st.by_quote; }
+  else if (tick != 0) { t.side = side_of(tick);     ++st.by_tick; }
+  else                ++st.unresolved;
+}
+
+void add_counters(const TradeSignStats& st) {
+  CounterSet c;
+  c.add(Ctr::side_feed, st.feed);
+  c.add(Ctr::side_quote, st.by_quote);
+  c.add(Ctr::side_tick, st.by_tick);
+  c.add(Ctr::side_unknown, st.unresolved);
+  CounterRegistry::add(c);
+}
+}  // namespace
+
+TradeSignStats infer_aggressors(std::span<const QuoteL1> quotes, std::span<Trade> trades) {
+  TradeSignStats st;
+  const std::size_t n = trades.size(), nq = quotes.size();
+  if (n == 0) return st;
+
+  // merge-join: qi[k] = 1 + index of the last quote strictly before print k (0 = none).
+  // Quotes outnumber prints ~10:1, so each print gallops from the previous
+  // match and bisects the bracket: O(log gap) quote reads, not a full pass.
+  std::vector<std::uint32_t> qi(n);
+  std::size_t j = 0;
+  for (std::size_t k = 0; k < n; ++k) {
+    const TsNanos t = trades[k].ts;
+    std::size_t step = 1;
+    while (j + step <= nq && quotes[j + step - 1].ts < t) { j += step; step <<= 1; }
+    const auto hi = quotes.begin() + std::min(j + step, nq);
+    j = std::partition_point(quotes.begin() + j, hi, [t](const QuoteL1& q) { return q.ts < t; }) - quotes.begin();
+    qi[k] = static_cast<std::uint32_t>(j);
+  }
+
+  // quote rule over the joined pairs, branch-free
+  std::vector<std::int8_t> sgn(n);
+  for (std::size_t k = 0; k < n; ++k) {
+    const QuoteL1& q = quotes[qi[k] ? qi[k] - 1 : 0];
+    sgn[k] = static_cast<std::int8_t>(qi[k] ? quote_rule(trades[k].px, q) : 0);
+  }
+
+  // tick rule: sign of the last price change, carried over zero ticks
+  int tick = 0;
+  for (std::size_t k = 0; k < n; ++k) {
+    if (k > 0) {
+      const double d = trades[k].px - trades[k - 1].px;
+      tick = d > 0.0 ? 1 : d < 0.0 ? -1 : tick;
+    }
+    resolve(trades[k], sgn[k], tick, st);
+  }
+  add_counters(st);
+  return st;
+}
+
+void TradeSignClassifier::classify(Trade& t) {
+  const QuoteL1* q = have_last && last.ts < t.ts ? &last : have_before ? &before : nullptr;
+  if (have_px) {
+    const double d = t.px - prev_px;
+    tick = d > 0.0 ? 1 : d < 0.0 ? -1 : tick;
+  }
+  prev_px = t.px;
+  have_px = true;
+  resolve(t, q ? quote_rule(t.px, *q) : 0, tick, st);
+}
+
+void TradeSignClassifier::flush_counters() {
+  TradeSignStats d;
+  d.feed       = st.feed - flushed.feed;
+  d.by_quote   = st.by_quote - flushed.by_quote;
+  d.by_tick    = st.by_tick - flushed.by_tick;
+  d.unresolved = st.unresolved - flushed.unresolved;
+  add_counters(d);
+  flushed = st;
+}
@@ -0,0 +1,120 @@
+#include "data/ZoneMap.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+ZoneMap ZoneMap::build(const DayData& day, const ZoneKey& key) {
+  // a strategy instance with these gates computes OFI exactly as the replay will
+  OfiParams P;
+  P.rth_only = key.rth_only;
+  P.min_spread_ticks = key.min_spread_ticks;
+  P.min_bid_sz = key.min_bid_sz;
+  P.min_ask_sz = key.min_ask_sz;
+  P.tick_size = key.tick_size;
+  QueueOfiStrategy s(P);
+
+  ZoneMap zm;
+  zm.n_events = day.events.size();
+  constexpr TsNanos kMinute = 60'000'000'000LL;
+  QuietStretch carry;   // what the current minute changed
+  TsNanos cur = -1;
+  MinuteZone* m = nullptr;
+  // gate rejections so far, to split s's running counters per minute
+  std::uint64_t rth0 = 0, spread0 = 0, size0 = 0;
+  const auto close_minute = [&] {
+    const CounterSet& c = s.counters();
+    m->end = carry;
+    m->gate_rth    = static_cast<std::uint32_t>(c[Ctr::gate_rth] - rth0);
+    m->gate_spread = static_cast<std::uint32_t>(c[Ctr::gate_spread] - spread0);
+    m->gate_size   = static_cast<std::uint32_t>(c[Ctr::gate_size] - size0);
+    rth0 = c[Ctr::gate_rth]; spread0 = c[Ctr::gate_spread]; size0 = c[Ctr::gate_size];
+    carry.fed = carry.quoted = carry.traded = false;
+  };
+  for (std::size_t i = 0; i < day.events.size(); ++i) {
+    const Event& e = day.events[i];
+    const TsNanos minute = e.ts / kMinute;
+    if (!m || minute != cur) {
+      if (m) close_minute();
+      cur = minute;
+      zm.mins.emplace_back();
+      m = &zm.mins.back();
+      m->first = static_cast<std::uint32_t>(i);
+    }
+    m->last = static_cast<std::uint32_t>(i + 1);
+    carry.end_ts = e.ts;
+
+    if (e.type == EvType::Trade) {
+      ++m->trades;
+      carry.traded = true;
+      carry.trade_ts = e.t.ts;
+      carry.trade_dir = e.t.side == Aggressor::Buy ? 1 : e.t.side == Aggressor::Sell ? -1 : 0;
+      continue;
+    }
+    const QuoteL1& q = e.q;
+    ++m->quotes;
+    if (std::fabs((q.ask_px - q.bid_px) - key.tick_size) <= 1e-9) ++m->spread1;
+    carry.quoted = true;
+    carry.last_quote = q;
+    if (!s.admit(q)) continue;
+
+    s.absorb_quote(q);
+    const double ofi = s.ofi(), imb = s.imbalance_ticks();
+    if (m->fed++ == 0) {
+      m->ofi_min = m->ofi_max = ofi;
+      m->imb_min = m->imb_max = imb;
+    } else {
+      m->ofi_min = std::min(m->ofi_min, ofi); m->ofi_max = std::max(m->ofi_max, ofi);
+      m->imb_min = std::min(m->imb_min, imb); m->imb_max = std::max(m->imb_max, imb);
+    }
+    carry.fed = true;
+    carry.last_fed = q;
+    carry.ofi = ofi;
+  }
+  if (m) close_minute();
+  return zm;
+}
+
+bool ZoneMap::may_signal(const OfiParams& P) const {
+  return std::any_of(mins.begin(), mins.end(), [&](const MinuteZone& m) { return m.may_signal(P); });
+}
+
+std::size_t ZoneMap::signal_minutes(const OfiParams& P) const {
+  return static_cast<std::size_t>(
+      std::count_if(mins.begin(), mins.end(), [&](const MinuteZone& m) { return m.may_signal(P); }));
+}
+
+std::shared_ptr<const ZoneMap> ZoneIndex::get(const std::string& ymd, const DayData& day, const OfiParams& P) {
+  const auto k = std::make_pair(ymd, ZoneKey::of(P));
+  {
+    std::lock_guard<std::mutex> lk(mu);
+    auto it = maps.find(k);
+    if (it != maps.end()) return it->second;
+  }
+  // built outside the lock; a concurrent build of the same key just loses the race
+  const auto t0 = std::chrono::steady_clock::now();
+  auto zm = std::make_shared<const ZoneMap>(ZoneMap::build(day, k.second));
+  const auto dt = std::chrono::steady_clock::now() - t0;
+  std::lock_guard<std::mutex> lk(mu);
+  auto [it, inserted] = maps.emplace(k, std::move(zm));
+  if (inserted) {
+    ++st.maps_built;
+    st.build_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(dt).count();
+  }
+  return it->second;
+}
+
+std::shared_ptr<const ZoneMap> ZoneIndex::find(const std::string& ymd, const OfiParams& P) const {
+  std::lock_guard<std::mutex> lk(mu);
+  auto it = maps.find(std::make_pair(ymd, ZoneKey::of(P)));
+  return it == maps.end() ? nullptr : it->second;
+}
+
+bool ZoneIndex::prunable(const std::string& ymd, const std::vector<OfiParams>& cands) const {
+  if (cands.empty()) return false;
+  for (const auto& P : cands) {
+    const auto zm = find(ymd, P);
+    if (!zm || zm->may_signal(P)) return false;
+  }
+  return true;
+}
@@ -1,15 +1,27 @@
 #include "data/DbnReader.hpp"
+#include "data/DbnDepth.hpp"
+#include "data/DbnMemory.hpp"
+#include "data/DbnStream.hpp"
+#include "common/Counters.hpp"
 
+#include <databento/dbn_decoder.hpp>
 #include <databento/dbn_file_store.hpp>
+#include <databento/ireadable.hpp>
+#include <databento/log.hpp>
 #include <databento/record.hpp>
 #include <databento/enums.hpp>
+#include <databento/file_stream.hpp>
 #include <databento/pretty.hpp>
 
+#include <algorithm>
 #include <chrono>
+#include <cstring>
 #include <filesystem>
 #include <type_traits>
 #include <cmath>
 #include <iostream>
+#include <memory>
+#include <stdexcept>
 
 // --- time helpers (existing) ---
 template <class TP>
@@ -121,54 +133,181 @@ DayEvents load_day_from_dbn(const std::string& path, const std::string& schema_n
   return out;
 }
 
+// ---- per-record filter + conversion shared by the file and in-memory loaders ----
+// drop reasons go to `ctr`, which the callers flush to the registry once per load
+static inline void append_record(const databento::Record& rec,
+                                 const std::string& schema_name,
+                                 const std::optional<std::uint32_t>& instrument_filter,
+                                 bool rth_only,
+                                 DayEvents& out,
+                                 CounterSet& ctr) {
+  ctr.add(Ctr::load_records);
+  if (schema_name == "mbp-1") {
+    if (const auto* m = rec.GetIf<databento::Mbp1Msg>()) {
+      if (instrument_filter && m->hd.instrument_id != *instrument_filter) { ctr.add(Ctr::load_instrument); return; }
+
+      const TsNanos ts = get_ts_ns(*m);
+      if (rth_only && !is_rth_es_utc(ts)) { ctr.add(Ctr::load_rth); return; }
+
+      const double bid_px_d = px_to_double(get_bid_px_raw(*m));
+      const double ask_px_d = px_to_double(get_ask_px_raw(*m));
+      if (bid_px_d <= 0.0 || ask_px_d <= 0.0 || bid_px_d >= ask_px_d) { ctr.add(Ctr::load_crossed); return; }
+
+      QuoteL1 q{};
+      q.ts     = ts;
+      q.bid_px = bid_px_d;
+      q.ask_px = ask_px_d;
+      q.bid_sz = get_bid_sz(*m);
+      q.ask_sz = get_ask_sz(*m);
+      out.quotes.push_back(q);
+      ctr.add(Ctr::load_kept);
+    }
+  } else if (schema_name == "trades") {
+    if (const auto* t = rec.GetIf<databento::TradeMsg>()) {
+      if (instrument_filter && t->hd.instrument_id != *instrument_filter) { ctr.add(Ctr::load_instrument); return; }
+
+      const TsNanos ts = get_ts_ns(*t);
+      if (rth_only && !is_rth_es_utc(ts)) { ctr.add(Ctr::load_rth); return; }
+
+      Trade tr{};
+      tr.ts   = ts;
+      tr.px   = px_to_double(get_px_raw(*t));
+      tr.sz   = get_sz(*t);
+      tr.side = get_aggr(*t);
+      out.trades.push_back(tr);
+      ctr.add(Ctr::load_kept);
+    }
+  }
+}
+
+static void flush_load_counters(CounterSet& ctr, bool whole_day) {
+  if (whole_day) ctr.set(Gauge::load_day_kept, static_cast<std::int64_t>(ctr[Ctr::load_kept]));
+  CounterRegistry::add(ctr);
+}
+
 // ---- filtered loader (instrument + RTH) ----
 DayEvents load_day_from_dbn(const std::string& path,
                             const std::string& schema_name,
                             std::optional<std::uint32_t> instrument_filter,
                             bool rth_only) {
   DayEvents out;
+  CounterSet ctr;
   databento::DbnFileStore store{std::filesystem::path{path}};
 
   store.Replay([&](const databento::Record& rec) -> databento::KeepGoing {
-    if (schema_name == "mbp-1") {
-      if (const auto* m = rec.GetIf<databento::Mbp1Msg>()) {
-        if (instrument_filter && m->hd.instrument_id != *instrument_filter)
-          return databento::KeepGoing::Continue;
-
-        const TsNanos ts = get_ts_ns(*m);
-        if (rth_only && !is_rth_es_utc(ts)) return databento::KeepGoing::Continue;
-
-        const double bid_px_d = px_to_double(get_bid_px_raw(*m));
-        const double ask_px_d = px_to_double(get_ask_px_raw(*m));
-        if (bid_px_d <= 0.0 || ask_px_d <= 0.0 || bid_px_d >= ask_px_d)
-          return databento::KeepGoing::Continue;
+    append_record(rec, schema_name, instrument_filter, rth_only, out, ctr);
+    return databento::KeepGoing::Continue;
+  });
 
-        QuoteL1 q{};
-        q.ts     = ts;
-        q.bid_px = bid_px_d;
-        q.ask_px = ask_px_d;
-        q.bid_sz = get_bid_sz(*m);
-        q.ask_sz = get_ask_sz(*m);
-        out.quotes.push_back(q);
-      }
-    } else if (schema_name == "trades") {
-      if (const auto* t = rec.GetIf<databento::TradeMsg>()) {
-        if (instrument_filter && t->hd.instrument_id != *instrument_filter)
-          return databento::KeepGoing::Continue;
+  flush_load_counters(ctr, true);
+  return out;
+}
 
-        const TsNanos ts = get_ts_ns(*t);
-        if (rth_only && !is_rth_es_utc(ts)) return databento::KeepGoing::Continue;
+// ---- MBP-10 depth loader ----
+std::vector<QuoteL10> load_depth_from_dbn(const std::string& path,
+                                          std::optional<std::uint32_t> instrument_filter,
+                                          bool rth_only) {
+  std::vector<QuoteL10> out;
+  databento::DbnFileStore store{std::filesystem::path{path}};
+  store.Replay([&](const databento::Record& rec) -> databento::KeepGoing {
+    const auto* m = rec.GetIf<databento::Mbp10Msg>();
+    if (!m) return databento::KeepGoing::Continue;
+    if (instrument_filter && m->hd.instrument_id != *instrument_filter) return databento::KeepGoing::Continue;
+    const TsNanos ts = get_ts_ns(*m);
+    if (rth_only && !is_rth_es_utc(ts)) return databento::KeepGoing::Continue;
 
-        Trade tr{};
-        tr.ts   = ts;
-        tr.px   = px_to_double(get_px_raw(*t));
-        tr.sz   = get_sz(*t);
-        tr.side = get_aggr(*t);
-        out.trades.push_back(tr);
-      }
+    QuoteL10 u{};
+    u.ts = ts;
+    for (std::size_t i = 0; i < kDepthLevels; ++i) {
+      const auto& l = m->levels[i];
+      u.bid[i] = BookLevel{px_to_double(l.bid_px), static_cast<QtyI>(l.bid_sz)};
+      u.ask[i] = BookLevel{px_to_double(l.ask_px), static_cast<QtyI>(l.ask_sz)};
+      // missing levels carry the undefined price (INT64_MAX raw, ~9.2e9 scaled): treat as empty
+      if (u.bid[i].px <= 0.0 || u.bid[i].px > 1e9) u.bid[i] = {};
+      if (u.ask[i].px <= 0.0 || u.ask[i].px > 1e9) u.ask[i] = {};
     }
+    if (u.bid[0].px <= 0.0 || u.ask[0].px <= 0.0 || u.bid[0].px >= u.ask[0].px) return databento::KeepGoing::Continue;
+    out.push_back(u);
     return databento::KeepGoing::Continue;
   });
+  return out;
+}
+
+// ---- in-memory loader: the file image was already read (e.g. by DayPrefetcher) ----
+namespace {
+class SpanReadable : public databento::IReadable {
+ public:
+  explicit SpanReadable(std::span<const std::byte> b) : buf(b) {}
 
+  void ReadExact(std::byte* dst, std::size_t length) override {
+    if (length > buf.size() - pos) throw std::runtime_error("dbn buffer: unexpected end of data");
+    std::memcpy(dst, buf.data() + pos, length);
+    pos += length;
+  }
+  std::size_t ReadSome(std::byte* dst, std::size_t max_length) override {
+    const std::size_t n = std::min(max_length, buf.size() - pos);
+    std::memcpy(dst, buf.data() + pos, n);
+    pos += n;
+    return n;
+  }
+
+ private:
+  std::span<const std::byte> buf;
+  std::size_t pos = 0;
+};
+}  // namespace
+
+DayEvents load_day_from_buffer(std::span<const std::byte> bytes,
+                               const std::string& schema_name,
+                               std::optional<std::uint32_t> instrument_filter,
+                               bool rth_only) {
+  DayEvents out;
+  if (bytes.empty()) return out;
+
+  // zstd frames are detected and unwrapped by the decoder itself
+  databento::DbnDecoder decoder{databento::ILogReceiver::Default(),
+                                std::make_unique<SpanReadable>(bytes)};
+  decoder.DecodeMetadata();
+  CounterSet ctr;
+  while (const databento::Record* rec = decoder.DecodeRecord())
+    append_record(*rec, schema_name, instrument_filter, rth_only, out, ctr);
+  flush_load_counters(ctr, true);
   return out;
 }
+
+// ---- chunked loader for streaming pipelines ----
+struct DbnChunkReader::Impl {
+  databento::DbnDecoder decoder;
+  std::string schema_name;
+  std::optional<std::uint32_t> instrument_filter;
+  bool rth_only;
+  bool done = false;
+
+  Impl(const std::string& path, std::string schema, std::optional<std::uint32_t> filter, bool rth)
+      : decoder{databento::ILogReceiver::Default(),
+                std::make_unique<databento::InFileStream>(std::filesystem::path{path})},
+        schema_name(std::move(schema)), instrument_filter(filter), rth_only(rth) {
+    decoder.DecodeMetadata();
+  }
+};
+
+DbnChunkReader::DbnChunkReader(const std::string& path,
+                               const std::string& schema_name,
+                               std::optional<std::uint32_t> instrument_filter,
+                               bool rth_only)
+    : impl(std::make_unique<Impl>(path, schema_name, instrument_filter, rth_only)) {}
+
+DbnChunkReader::~DbnChunkReader() = default;
+
+bool DbnChunkReader::next(DayEvents& out, std::size_t max_records) {
+  out.quotes.clear();
+  out.trades.clear();
+  CounterSet ctr;
+  while (!impl->done && out.quotes.size() + out.trades.size() < max_records) {
+    const databento::Record* rec = impl->decoder.DecodeRecord();
+    if (!rec) { impl->done = true; break; }
+    append_record(*rec, impl->schema_name, impl->instrument_filter, impl->rth_only, out, ctr);
+  }
+  flush_load_counters(ctr, false);
+  return !out.quotes.empty() || !out.trades.empty();
+}
@@ -0,0 +1,293 @@
+#include "io/DayPrefetcher.hpp"
+#include "common/ThreadPool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <memory>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#ifdef OFI_HAVE_IO_URING
+#include <liburing.h>
+#endif
+
+DayPrefetcher::DayPrefetcher(std::vector<std::string> paths_, PrefetchOptions opt_)
+    : paths(std::move(paths_)), opt(opt_), slots(std::max<std::size_t>(1, opt_.depth)) {
+  opt.depth       = slots.size();
+  opt.chunk_bytes = std::max<std::size_t>(opt.chunk_bytes, 64u << 10);
+
+#ifdef OFI_HAVE_IO_URING
+  if (opt.use_io_uring && !paths.empty()) {
+    // slots only need to hold the largest queued file (larger ones go to a
+    // heap buffer anyway), and registration pins them against
+    // RLIMIT_MEMLOCK: check that before allocating, not after
+    std::size_t largest = 0;
+    for (const auto& p : paths) {
+      struct stat sb{};
+      if (::stat(p.c_str(), &sb) == 0) largest = std::max(largest, static_cast<std::size_t>(sb.st_size));
+    }
+    const std::size_t slot_bytes = std::min(opt.slot_bytes, largest);
+    rlimit lim{};
+    const bool pinnable = ::geteuid() == 0 ||
+        (::getrlimit(RLIMIT_MEMLOCK, &lim) == 0 &&
+         (lim.rlim_cur == RLIM_INFINITY || slot_bytes * slots.size() <= lim.rlim_cur));
+
+    auto* r = (slot_bytes > 0 && pinnable) ? new io_uring{} : nullptr;
+    if (r && io_uring_queue_init(64, r, 0) == 0) {
+      std::vector<iovec> iov(slots.size());
+      for (std::size_t k = 0; k < slots.size(); ++k) {
+        slots[k].fixed       = std::make_unique_for_overwrite<std::byte[]>(slot_bytes);
+        slots[k].fixed_bytes = slot_bytes;
+        iov[k].iov_base = slots[k].fixed.get();
+        iov[k].iov_len  = slot_bytes;
+      }
+      if (io_uring_register_buffers(r, iov.data(), static_cast<unsigned>(iov.size())) == 0) {
+        ring = r;
+        uring_active = true;
+      } else {
+        io_uring_queue_exit(r);  // e.g. RLIMIT_MEMLOCK too low
+      }
+    }
+    if (!uring_active) {
+      delete r;
+      for (auto& s : slots) { s.fixed.reset(); s.fixed_bytes = 0; }
+    }
+  }
+#endif
+
+  if (uring_active) reader = std::thread([this] { run_uring(); });
+  else              reader = std::thread([this] { run_pool(); });
+}
+
+DayPrefetcher::~DayPrefetcher() {
+  {
+    std::lock_guard<std::mutex> lk(mu);
+    stopping = true;
+  }
+  cv_slot.notify_all();
+  cv_ready.notify_all();
+  reader.join();
+#ifdef OFI_HAVE_IO_URING
+  if (ring) {
+    auto* r = static_cast<io_uring*>(ring);
+    io_uring_unregister_buffers(r);
+    io_uring_queue_exit(r);
+    delete r;
+  }
+#endif
+}
+
+const char* DayPrefetcher::backend() const { return uring_active ? "io_uring" : "thread-pool"; }
+
+PrefetchStats DayPrefetcher::stats() const {
+  std::lock_guard<std::mutex> lk(mu);
+  return st;
+}
+
+std::span<const std::byte> DayPrefetcher::acquire(std::size_t i) {
+  if (i >= paths.size()) return {};
+  Slot& s = slots[i % slots.size()];
+
+  const auto t0 = std::chrono::steady_clock::now();
+  std::unique_lock<std::mutex> lk(mu);
+  cv_ready.wait(lk, [&] {
+    return stopping || (s.file == i && (s.state == SlotState::Ready || s.state == SlotState::Failed));
+  });
+  st.stall_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     std::chrono::steady_clock::now() - t0).count();
+  if (s.state != SlotState::Ready) return {};
+  return {s.data, s.bytes};
+}
+
+void DayPrefetcher::release(std::size_t i) {
+  if (i >= paths.size()) return;
+  Slot& s = slots[i % slots.size()];
+  {
+    std::lock_guard<std::mutex> lk(mu);
+    if (s.file != i || s.state == SlotState::Loading || s.state == SlotState::Free) return;
+    s.state = SlotState::Free;
+    std::vector<std::byte>{}.swap(s.overflow);
+  }
+  cv_slot.notify_one();
+}
+
+// called on the reader thread with the slot already marked Loading
+bool DayPrefetcher::open_slot(Slot& s, std::size_t file) {
+  s.file  = file;
+  s.bytes = 0;
+  s.io_error.store(false, std::memory_order_relaxed);
+
+  s.fd = ::open(paths[file].c_str(), O_RDONLY | O_CLOEXEC);
+  if (s.fd < 0) return false;
+
+  struct stat sb{};
+  if (::fstat(s.fd, &sb) != 0) { ::close(s.fd); s.fd = -1; return false; }
+  s.bytes = static_cast<std::size_t>(sb.st_size);
+#ifdef POSIX_FADV_SEQUENTIAL
+  ::posix_fadvise(s.fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+  if (uring_active && s.bytes <= s.fixed_bytes) {
+    s.data = s.fixed.get();
+  } else {
+    s.overflow.resize(s.bytes);
+    s.data = s.overflow.data();
+  }
+  return true;
+}
+
+void DayPrefetcher::finish_slot(Slot& s) {
+  if (s.fd >= 0) { ::close(s.fd); s.fd = -1; }
+  {
+    std::lock_guard<std::mutex> lk(mu);
+    const bool ok = !s.io_error.load(std::memory_order_relaxed);
+    s.state = ok ? SlotState::Ready : SlotState::Failed;
+    ++st.files;
+    if (ok) st.bytes_read += s.bytes;
+    else    ++st.failed;
+  }
+  cv_ready.notify_all();
+}
+
+// ---------- fallback: chunked pread() on a small pool ----------
+void DayPrefetcher::run_pool() {
+  ThreadPool pool(opt.fallback_threads);
+
+  for (;;) {
+    std::size_t file;
+    {
+      std::unique_lock<std::mutex> lk(mu);
+      cv_slot.wait(lk, [&] {
+        return stopping || (next_issue < paths.size() &&
+                            slots[next_issue % slots.size()].state == SlotState::Free);
+      });
+      if (stopping || next_issue >= paths.size()) return;
+      file = next_issue++;
+      slots[file % slots.size()].state = SlotState::Loading;
+    }
+
+    Slot& s = slots[file % slots.size()];
+    if (!open_slot(s, file)) { s.io_error.store(true); finish_slot(s); continue; }
+    if (s.bytes == 0)        { finish_slot(s); continue; }
+
+    const std::size_t n_chunks = (s.bytes + opt.chunk_bytes - 1) / opt.chunk_bytes;
+    s.chunks_left.store(n_chunks, std::memory_order_relaxed);
+    for (std::size_t c = 0; c < n_chunks; ++c) {
+      pool.submit([this, &s, c] {
+        const std::size_t off = c * opt.chunk_bytes;
+        const std::size_t len = std::min(opt.chunk_bytes, s.bytes - off);
+        std::size_t done = 0;
+        while (done < len) {
+          const ssize_t r = ::pread(s.fd, s.data + off + done, len - done,
+                                    static_cast<off_t>(off + done));
+          if (r <= 0) { s.io_error.store(true, std::memory_order_relaxed); break; }
+          done += static_cast<std::size_t>(r);
+        }
+        if (s.chunks_left.fetch_sub(1, std::memory_order_acq_rel) == 1) finish_slot(s);
+      });
+    }
+  }
+}
+
+// ---------- io_uring: many chunked reads in flight across files ----------
+void DayPrefetcher::run_uring() {
+#ifdef OFI_HAVE_IO_URING
+  auto* r = static_cast<io_uring*>(ring);
+
+  struct Pending { std::uint32_t slot, chunk; };
+  std::deque<Pending> pending;  // reads not yet in the SQ
+  std::size_t in_flight = 0;
+
+  auto queue_read = [&](const Pending& p) -> bool {
+    io_uring_sqe* sqe = io_uring_get_sqe(r);
+    if (!sqe) return false;
+    Slot& s = slots[p.slot];
+    const std::size_t off  = std::size_t{p.chunk} * opt.chunk_bytes + s.chunk_done[p.chunk];
+    const std::size_t end  = std::min(std::size_t{p.chunk + 1} * opt.chunk_bytes, s.bytes);
+    const unsigned    len  = static_cast<unsigned>(end - off);
+    if (s.data == s.fixed.get())
+      io_uring_prep_read_fixed(sqe, s.fd, s.data + off, len, off, static_cast<int>(p.slot));
+    else
+      io_uring_prep_read(sqe, s.fd, s.data + off, len, off);
+    io_uring_sqe_set_data64(sqe, (std::uint64_t{p.chunk} << 32) | p.slot);
+    ++in_flight;
+    return true;
+  };
+
+  for (;;) {
+    // claim every free slot for the next files in order
+    {
+      std::unique_lock<std::mutex> lk(mu);
+      if (in_flight == 0 && pending.empty()) {
+        cv_slot.wait(lk, [&] {
+          return stopping || (next_issue < paths.size() &&
+                              slots[next_issue % slots.size()].state == SlotState::Free);
+        });
+      }
+      if (stopping) break;
+      while (next_issue < paths.size() &&
+             slots[next_issue % slots.size()].state == SlotState::Free) {
+        const std::size_t file = next_issue++;
+        const auto k = static_cast<std::uint32_t>(file % slots.size());
+        slots[k].state = SlotState::Loading;
+        lk.unlock();
+
+        Slot& s = slots[k];
+        if (!open_slot(s, file)) { s.io_error.store(true); finish_slot(s); }
+        else if (s.bytes == 0)   { finish_slot(s); }
+        else {
+          const std::size_t n_chunks = (s.bytes + opt.chunk_bytes - 1) / opt.chunk_bytes;
+          s.chunks_left.store(n_chunks, std::memory_order_relaxed);
+          s.chunk_done.assign(n_chunks, 0);
+          for (std::size_t c = 0; c < n_chunks; ++c)
+            pending.push_back({k, static_cast<std::uint32_t>(c)});
+        }
+        lk.lock();
+      }
+      if (next_issue >= paths.size() && in_flight == 0 && pending.empty()) break;
+    }
+
+    while (!pending.empty() && queue_read(pending.front())) pending.pop_front();
+    if (in_flight == 0) continue;
+    io_uring_submit_and_wait(r, 1);
+
+    unsigned head;
+    unsigned seen = 0;
+    io_uring_cqe* cqe;
+    io_uring_for_each_cqe(r, head, cqe) {
+      ++seen;
+      --in_flight;
+      const std::uint64_t ud = io_uring_cqe_get_data64(cqe);
+      const auto k = static_cast<std::uint32_t>(ud & 0xffffffffu);
+      const auto c = static_cast<std::uint32_t>(ud >> 32);
+      Slot& s = slots[k];
+
+      if (cqe->res <= 0) {
+        s.io_error.store(true, std::memory_order_relaxed);
+      } else {
+        s.chunk_done[c] += static_cast<std::uint32_t>(cqe->res);
+        const std::size_t want = std::min(opt.chunk_bytes, s.bytes - std::size_t{c} * opt.chunk_bytes);
+        if (s.chunk_done[c] < want) { pending.push_back({k, c}); continue; }  // short read
+      }
+      if (s.chunks_left.fetch_sub(1, std::memory_order_relaxed) == 1) finish_slot(s);
+    }
+    io_uring_cq_advance(r, seen);
+  }
+
+  // drain anything still in flight so buffers outlive the kernel's writes
+  while (in_flight > 0) {
+    io_uring_cqe* cqe;
+    if (io_uring_wait_cqe(r, &cqe) != 0) break;
+    io_uring_cqe_seen(r, cqe);
+    --in_flight;
+  }
+  for (auto& s : slots) if (s.fd >= 0) { ::close(s.fd); s.fd = -1; }
+#else
+  run_pool();
+#endif
+}
@@ -0,0 +1,220 @@
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/Clock.hpp"
+#include "common/HdrHistogram.hpp"
+#include "common/Types.hpp"
+#include "data/SyntheticDay.hpp"
+#include "live/LiveEngine.hpp"
+#include "pipeline/Stages.hpp"
+#include "strategy/QueueOfi.hpp"
+
+// End-to-end latency of the live path under paced load. A feed thread
+// replays a synthetic or recorded day into the engine's ring on a fixed
+// schedule, compressed by each --rates multiple; the engine runs on the
+// main thread with a LatencyProbe attached. Latency is measured from each
+// message's scheduled send time, so a stalled consumer (or a full ring)
+// shows up in the percentiles instead of silently delaying the feed
+// (coordinated omission). The naive column measures from the actual
+// enqueue instead, for comparison.
+
+struct RateResult {
+  double mult = 0.0;
+  double offered_per_s = 0.0;
+  double achieved_per_s = 0.0;
+  std::uint64_t producer_stalls = 0;
+  std::unique_ptr<LatencyProbe> probe;
+  LiveStats st{};
+};
+
+static RateResult run_rate(const std::vector<Event>& events, double mult, const OfiParams& P,
+                           const LiveOptions& lo, std::uint64_t warmup) {
+  RateResult r;
+  r.mult = mult;
+  r.probe = std::make_unique<LatencyProbe>();
+  r.probe->warmup_seq = warmup;
+
+  LiveEngine engine(P, lo);
+  engine.attach_probe(r.probe.get());
+  std::atomic<bool> feed_done{false};
+  std::atomic<std::int64_t> wall0{0};
+
+  const TsNanos ts0 = events.front().ts;
+  std::thread feeder([&] {
+    auto& ring = engine.ring();
+    const std::int64_t start = TscClock::now_ns() + 1'000'000;   // 1 ms head start for the engine
+    wall0.store(start, std::memory_order_release);
+    std::uint64_t seq = 0, stalls = 0;
+    for (const auto& e : events) {
+      const std::int64_t due = start + static_cast<std::int64_t>(double(e.ts - ts0) / mult);
+      while (TscClock::now_ns() < due) {}
+      FeedMsg m{e, 0, ++seq, due};
+      for (;;) {
+        m.recv_ns = TscClock::now_ns();
+        if (ring.try_push(m)) break;
+        ++stalls;
+      }
+    }
+    r.producer_stalls = stalls;
+    feed_done.store(true, std::memory_order_release);
+  });
+
+  engine.run(feed_done);
+  const std::int64_t end = TscClock::now_ns();
+  feeder.join();
+  engine.flatten();
+
+  const double span_s = double(events.back().ts - ts0) / mult / 1e9;
+  const double wall_s = double(end - wall0.load(std::memory_order_acquire)) / 1e9;
+  r.offered_per_s  = span_s > 0.0 ? double(events.size()) / span_s : 0.0;
+  r.achieved_per_s = wall_s > 0.0 ? double(events.size()) / wall_s : 0.0;
+  r.st = engine.stats();
+  return r;
+}
+
+static std::vector<double> parse_rates(const std::string& s) {
+  std::vector<double> v;
+  std::stringstream ss(s);
+  std::string tok;
+  while (std::getline(ss, tok, ',')) if (!tok.empty()) v.push_back(std::stod(tok));
+  return v;
+}
+
+int main(int argc, char** argv) {
+  std::string source = "synthetic";
+  std::string ymd = "20231002";
+  std::vector<double> rates = {1.0, 10.0, 100.0};
+  SyntheticOptions so;
+  std::size_t max_events = 1'000'000;
+  std::uint64_t warmup = 10'000;
+  double slo_us = 100.0;          // p99 quote->decision budget that defines saturation
+  std::string hgrm_prefix;
+  LiveOptions lo;
+  for (int i = 1; i < argc; ++i) {
+    const std::string a = argv[i];
+    if      (a == "--source=synthetic")         source = "synthetic";
+    else if (a == "--source=dbn")               source = "dbn";
+    else if (a.rfind("--ymd=", 0) == 0)         ymd = a.substr(6);
+    else if (a.rfind("--rates=", 0) == 0)       rates = parse_rates(a.substr(8));
+    else if (a.rfind("--peak-rate=", 0) == 0)   so.rate_per_s = std::stod(a.substr(12));
+    else if (a.rfind("--events=", 0) == 0)      max_events = std::stoull(a.substr(9));
+    else if (a.rfind("--warmup=", 0) == 0)      warmup = std::stoull(a.substr(9));
+    else if (a.rfind("--slo-us=", 0) == 0)      slo_us = std::stod(a.substr(9));
+    else if (a.rfind("--hgrm=", 0) == 0)        hgrm_prefix = a.substr(7);
+    else if (a.rfind("--enter=", 0) == 0)       lo.conflate_enter = std::stoull(a.substr(8));
+    else if (a.rfind("--exit=", 0) == 0)        lo.conflate_exit  = std::stoull(a.substr(7));
+    else {
+      std::cerr << "Usage: latency_bench [--source=synthetic|dbn] [--ymd=YYYYMMDD] [--rates=1,10,100]\n"
+                   "                     [--peak-rate=MSG_PER_S] [--events=N] [--warmup=N] [--slo-us=X]\n"
+                   "                     [--hgrm=PREFIX] [--enter=N] [--exit=N]\n";
+      return 1;
+    }
+  }
+  if (rates.empty()) { std::cerr << "No rates given\n"; return 1; }
+  std::sort(rates.begin(), rates.end());
+
+  // 1x = synthetic feed at --peak-rate (ES-peak-like, with bursts), or the recorded pace for DBN
+  std::vector<Event> events;
+  if (source == "synthetic") {
+    so.events = max_events;
+    events = synthetic_day(so);
+  } else {
+    const std::string mbp_path = "data/mbp-1/glbx-mdp3-" + ymd + ".mbp-1.dbn.zst";
+    const std::string trd_path = "data/trades/glbx-mdp3-" + ymd + ".trades.dbn.zst";
+    if (!std::filesystem::exists(mbp_path)) {
+      std::cerr << "Missing MBP-1 file: " << mbp_path << "\n"; return 1;
+    }
+    const std::uint32_t ESZ3_ID = 314863;
+    for (auto& chunk : day_stage(mbp_path, std::filesystem::exists(trd_path) ? trd_path : std::string{},
+                                 ESZ3_ID, /*rth_only=*/true)) {
+      const std::size_t take = std::min(chunk.size(), max_events - events.size());
+      events.insert(events.end(), chunk.begin(), chunk.begin() + static_cast<std::ptrdiff_t>(take));
+      if (events.size() >= max_events) break;
+    }
+  }
+  if (events.size() <= warmup) {
+    std::cerr << "Need more than --warmup=" << warmup << " events (have " << events.size() << ")\n";
+    return 1;
+  }
+
+  // same parameters as backtest_ofi / live_replay
+  OfiParams P;
+  P.tick_size   = 0.25;
+  P.tick_value  = 12.5;
+  P.theta_ofi   = 5.0;
+  P.theta_imb   = 0.15;
+  P.slip_ticks  = 1;
+  P.max_hold_ns = 2'000'000'000LL;
+  P.min_spread_ticks       = 1;
+  P.min_bid_sz             = 2;
+  P.min_ask_sz             = 2;
+  P.persist_updates        = 3;
+  P.min_flip_cooldown_ns   = 120'000'000LL;
+  P.rth_only               = true;
+  P.fill_at_touch_when_spread1 = true;
+  P.trade_confirm_ns           = 0;
+
+  std::cout << "[bench] source=" << source << " events=" << events.size()
+            << " warmup=" << warmup << " slo_p99_us=" << slo_us << "\n";
+  std::cout << std::fixed << std::setprecision(1);
+  std::cout << std::setw(6) << "rate" << std::setw(12) << "offered/s" << std::setw(12) << "achieved/s"
+            << "  decide_us p50/p99/p99.9/max     send_us p50/p99/max   naive_p99"
+            << "  conflated%  max_depth  stalls\n";
+
+  std::vector<RateResult> results;
+  for (double mult : rates) {
+    RateResult r = run_rate(events, mult, P, lo, warmup);
+    const LatencyProbe& pr = *r.probe;
+    const auto us = [](std::int64_t ns) { return double(ns) / 1e3; };
+    const double conflated_pct = r.st.gated_quotes ? 100.0 * double(r.st.conflated_quotes) / double(r.st.gated_quotes) : 0.0;
+
+    std::ostringstream dec, snd;
+    dec << std::fixed << std::setprecision(1) << us(pr.decide.percentile(50)) << "/" << us(pr.decide.percentile(99))
+        << "/" << us(pr.decide.percentile(99.9)) << "/" << us(pr.decide.max());
+    snd << std::fixed << std::setprecision(1) << us(pr.send.percentile(50)) << "/" << us(pr.send.percentile(99))
+        << "/" << us(pr.send.max());
+    std::cout << std::setw(5) << mult << "x" << std::setw(12) << r.offered_per_s << std::setw(12) << r.achieved_per_s
+              << "  " << std::left << std::setw(30) << dec.str() << " " << std::setw(21) << snd.str() << std::right
+              << std::setw(10) << us(pr.decide_naive.percentile(99))
+              << std::setw(12) << conflated_pct << std::setw(11) << r.st.max_depth
+              << std::setw(8) << r.producer_stalls << "\n";
+
+    if (!hgrm_prefix.empty()) {
+      std::ostringstream tag;
+      tag << hgrm_prefix << "_" << mult << "x";
+      { std::ofstream f(tag.str() + "_decide.hgrm");       pr.decide.write_hgrm(f); }
+      { std::ofstream f(tag.str() + "_send.hgrm");         pr.send.write_hgrm(f); }
+      { std::ofstream f(tag.str() + "_decide_naive.hgrm"); pr.decide_naive.write_hgrm(f); }
+    }
+    results.push_back(std::move(r));
+  }
+
+  // saturation: first rate that misses the p99 budget or cannot keep up with the offered load
+  const RateResult* first_bad = nullptr;
+  const RateResult* last_good = nullptr;
+  for (const auto& r : results) {
+    const bool slow = double(r.probe->decide.percentile(99)) / 1e3 > slo_us;
+    const bool behind = r.achieved_per_s < 0.95 * r.offered_per_s;
+    if (slow || behind) { first_bad = &r; break; }
+    last_good = &r;
+  }
+  if (!first_bad) {
+    std::cout << "[saturation] none up to " << results.back().mult << "x ("
+              << results.back().offered_per_s << " msg/s)\n";
+  } else {
+    std::cout << "[saturation] between " << (last_good ? last_good->mult : 0.0) << "x and "
+              << first_bad->mult << "x (" << first_bad->offered_per_s << " msg/s offered, "
+              << first_bad->achieved_per_s << " achieved, decide p99 "
+              << double(first_bad->probe->decide.percentile(99)) / 1e3 << " us)\n";
+  }
+  return 0;
+}
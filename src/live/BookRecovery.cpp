@@ -0,0 +1,167 @@
+#include "live/BookRecovery.hpp"
+#include "common/Clock.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+static constexpr char kSnapMagic[8] = {'O', 'F', 'I', 'S', 'N', 'A', 'P', '1'};
+
+bool SnapshotWriter::open(const std::string& path) {
+  close();
+  f = std::fopen(path.c_str(), "wb");
+  if (!f) return false;
+  std::fwrite(kSnapMagic, 1, sizeof(kSnapMagic), f);
+  std::fflush(f);
+  return true;
+}
+
+void SnapshotWriter::append(const BookSnapshot& s) {
+  if (!f) return;
+  std::fwrite(&s, sizeof(s), 1, f);
+  std::fflush(f);
+}
+
+void SnapshotWriter::close() {
+  if (f) std::fclose(f);
+  f = nullptr;
+}
+
+std::optional<BookSnapshot> FileSnapshotSource::read_latest(const std::string& path) {
+  std::FILE* f = std::fopen(path.c_str(), "rb");
+  if (!f) return std::nullopt;
+  char magic[8];
+  std::optional<BookSnapshot> out;
+  if (std::fread(magic, 1, sizeof(magic), f) == sizeof(magic) &&
+      std::memcmp(magic, kSnapMagic, sizeof(magic)) == 0 &&
+      std::fseek(f, 0, SEEK_END) == 0) {
+    const long end = std::ftell(f);
+    const long n = (end - long(sizeof(kSnapMagic))) / long(sizeof(BookSnapshot));   // whole records only
+    BookSnapshot s;
+    if (n > 0 &&
+        std::fseek(f, long(sizeof(kSnapMagic)) + (n - 1) * long(sizeof(BookSnapshot)), SEEK_SET) == 0 &&
+        std::fread(&s, sizeof(s), 1, f) == 1)
+      out = s;
+  }
+  std::fclose(f);
+  return out;
+}
+
+void FileSnapshotSource::request() {
+  if (pending.valid()) return;   // a read is already in flight
+  pending = std::async(std::launch::async, [p = path] { return read_latest(p); });
+}
+
+std::optional<BookSnapshot> FileSnapshotSource::poll() {
+  if (!pending.valid() ||
+      pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    return std::nullopt;
+  auto s = pending.get();
+  if (!s) request();   // nothing written yet: keep a read in flight
+  return s;
+}
+
+void ChannelSnapshotSource::publish(const BookSnapshot& s) {
+  std::lock_guard<std::mutex> lk(mu);
+  latest = s;
+}
+
+std::optional<BookSnapshot> ChannelSnapshotSource::poll() {
+  std::unique_lock<std::mutex> lk(mu, std::try_to_lock);
+  if (!lk.owns_lock()) return std::nullopt;
+  return latest;
+}
+
+void BookRecovery::begin(std::int64_t now_ns) {
+  if (on) return;
+  on = true;
+  have_snap = false;
+  gave_up = false;
+  t_begin = now_ns;
+  buf.clear();
+  head = 0;
+  last_seq = 0;
+  expect = 0;
+  src.request();
+}
+
+void BookRecovery::buffer(const FeedMsg* m, std::size_t n) {
+  if (!on || n == 0) return;
+  // replayed entries are dead weight: drop them before growing
+  if (head > 0 && head >= buf.size() / 2) {
+    buf.erase(buf.begin(), buf.begin() + static_cast<std::ptrdiff_t>(head));
+    head = 0;
+  }
+  buf.insert(buf.end(), m, m + n);
+  st.buffered += n;
+  for (std::size_t i = 0; i < n; ++i) last_seq = std::max(last_seq, m[i].seq);
+  st.max_buffered = std::max(st.max_buffered, buf.size() - head);
+  if (buf.size() - head > max_buf) abandon();
+}
+
+void BookRecovery::abandon() {
+  if (!on) return;
+  on = false;
+  gave_up = true;
+  ++st.abandoned;
+  if (last_seq) expect = last_seq + 1;
+  buf.clear();
+  head = 0;
+}
+
+void BookRecovery::restart() {
+  ++st.restarts;
+  have_snap = false;
+  src.request();
+}
+
+std::span<const FeedMsg> BookRecovery::step(QueueOfiStrategy& strat, std::size_t max_replay) {
+  if (!on) return {};
+  if (timeout_ns > 0 && TscClock::now_ns() - t_begin > timeout_ns) { abandon(); return {}; }
+
+  if (!have_snap) {
+    const auto snap = src.poll();
+    if (!snap) return {};
+    std::size_t k = head;
+    while (k < buf.size() && buf[k].seq <= snap->seq) ++k;
+    if (k < buf.size() && buf[k].seq != snap->seq + 1) {
+      // the snapshot predates what we buffered: a newer one is needed
+      ++st.snapshots_rejected;
+      src.request();
+      return {};
+    }
+    st.stale += k - head;
+    head = k;
+    strat.load_snapshot(snap->q);
+    expect = snap->seq + 1;
+    have_snap = true;
+    st.snapshot_wait_ns += TscClock::now_ns() - t_begin;
+  }
+
+  // contiguous run after the snapshot, one batch at most
+  std::size_t n = 0;
+  const std::size_t avail = std::min(buf.size() - head, max_replay);
+  while (n < avail && buf[head + n].seq == expect + n) ++n;
+  if (n == 0 && head < buf.size()) {
+    if (buf[head].seq < expect) { ++head; ++st.stale; return {}; }   // duplicate
+    restart();   // another gap inside the buffer
+    return {};
+  }
+  return {buf.data() + head, n};
+}
+
+void BookRecovery::replayed(std::size_t n, std::int64_t now_ns) {
+  head += n;
+  expect += n;
+  st.replayed += n;
+  if (!have_snap || head < buf.size()) return;
+
+  // caught up: the book is live again
+  on = false;
+  buf.clear();
+  head = 0;
+  ++st.recoveries;
+  const std::int64_t dt = now_ns - t_begin;
+  st.recovery_ns += dt;
+  st.max_recovery_ns = std::max(st.max_recovery_ns, dt);
+}
@@ -0,0 +1,275 @@
+#include "live/LiveEngine.hpp"
+#include "common/Clock.hpp"
+#include "log/BinLog.hpp"
+
+#include <algorithm>
+#include <bit>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+static inline void cpu_relax() { _mm_pause(); }
+#else
+static inline void cpu_relax() {}
+#endif
+
+LiveEngine::LiveEngine(const OfiParams& P, LiveOptions opt_)
+    : opt(opt_), strat(P), feed(opt_.ring_capacity) {}
+
+std::size_t LiveEngine::poll() {
+  const std::size_t depth = feed.depth();
+  // an empty queue still closes an open episode, so idle time is not
+  // counted as conflated
+  if (depth == 0 && !conflate) return 0;
+
+  const std::int64_t now = TscClock::now_ns();
+  if (conflate && depth <= opt.conflate_exit) {
+    conflate = false;
+    st.conflated_ns += now - conflate_since_ns;
+    OFI_LOG(Conflate, 0, depth);
+  } else if (!conflate && depth >= opt.conflate_enter) {
+    conflate = true;
+    conflate_since_ns = now;
+    ++st.conflation_episodes;
+    OFI_LOG(Conflate, 1, depth);
+  }
+  if (depth == 0) return 0;
+  st.max_depth = std::max(st.max_depth, depth);
+
+  const FeedMsg* m = nullptr;
+  const std::size_t n = feed.peek(m, opt.max_batch);
+  if (n == 0) return 0;
+
+  const std::int64_t behind = now - m[0].recv_ns;
+  st.max_behind_ns = std::max(st.max_behind_ns, behind);
+  st.sum_behind_ns += static_cast<double>(behind);
+  ++st.behind_log2[behind > 0 ? std::bit_width(static_cast<std::uint64_t>(behind)) - 1 : 0];
+  ++st.batches;
+
+  // contiguous runs go to the strategy; a gap hands the rest to recovery
+  std::size_t k = 0;
+  while (k < n) {
+    if (recovering()) {
+      recovery->buffer(m + k, n - k);
+      if (!recovering()) end_recovery();   // buffer cap hit
+      break;
+    }
+    std::size_t j = k;
+    while (j < n && (m[j].seq == 0 || next_seq == 0 || m[j].seq == next_seq)) {
+      if (next_seq == 0 && recovery && opt.recover_on_start && m[j].seq != 0) break;
+      if (m[j].seq) next_seq = m[j].seq + 1;
+      ++j;
+    }
+    if (j > k) process(m + k, j - k);
+    if (j == n) break;
+    if (next_seq != 0 && m[j].seq < next_seq) { ++st.stale_msgs; k = j + 1; continue; }
+    if (next_seq != 0) ++st.seq_gaps;
+    if (recovery) recovery->begin(now);
+    else          next_seq = m[j].seq;   // no snapshot source: carry on from here
+    k = j;
+  }
+  if (recovering()) drive_recovery();
+
+  last_ev_ts   = m[n - 1].ev.ts;
+  last_recv_ns = m[n - 1].recv_ns;
+
+  feed.consume(n);
+  st.events += n;
+  if (tlm && now - tlm_last_ns >= tlm_period_ns) publish_telemetry(now);
+  return n;
+}
+
+void LiveEngine::process(const FeedMsg* m, std::size_t n) {
+  if (conflate) process_conflated(m, n);
+  else          process_each(m, n);
+}
+
+// one bounded recovery step: at most max_batch buffered messages replayed
+std::size_t LiveEngine::drive_recovery() {
+  const auto rep = recovery->step(strat, opt.max_batch);
+  for (const FeedMsg& r : rep) replay_passive(r);
+  recovery->replayed(rep.size(), TscClock::now_ns());
+  if (!recovery->active()) end_recovery();
+  return rep.size();
+}
+
+// state-only replay over a snapshot: timers, book and OFI move, no decisions
+void LiveEngine::replay_passive(const FeedMsg& r) {
+  const Event& e = r.ev;
+  book_timer(e.ts);
+  if (e.type == EvType::Trade) { strat.on_trade(e.t); return; }
+  last_quote = e.q;
+  have_quote = true;
+  strat.mark(e.q);
+  if (strat.passes_gates(e.q)) strat.absorb_quote(e.q);
+}
+
+// resume the live feed where recovery left it; an abandoned recovery never
+// loaded a snapshot, so the next live quote is loaded as one and OFI does
+// not take a delta across the gap
+void LiveEngine::end_recovery() {
+  next_seq = recovery->next_seq();
+  if (recovery->abandoned()) reload_book = true;
+}
+
+void LiveEngine::publish_telemetry(std::int64_t now_ns) {
+  if (!tlm) return;
+  tlm_last_ns = now_ns;
+  TelemetryValues x;
+  x.events     = st.events;
+  x.signals    = st.signals;
+  x.fills      = st.fills;
+  x.ring_depth = feed.depth();
+  x.max_depth  = st.max_depth;
+  x.conflating = conflate ? 1 : 0;
+  x.lat_p50_ns = static_cast<std::uint64_t>(st.behind_quantile_ns(0.50));
+  x.lat_p99_ns = static_cast<std::uint64_t>(st.behind_quantile_ns(0.99));
+  x.lat_max_ns = static_cast<std::uint64_t>(st.max_behind_ns);
+  x.pnl        = st.pnl;
+  x.heartbeat_ns = now_ns;
+  tlm->publish(x);
+}
+
+// no data: keep the strategy clock moving on the TSC so exits and
+// cooldowns fire on time during quiet periods
+void LiveEngine::idle() {
+  const std::int64_t now = TscClock::now_ns();
+  if (tlm && now - tlm_last_ns >= tlm_period_ns) publish_telemetry(now);
+  if (recovering()) drive_recovery();   // the snapshot may land while the feed is quiet
+  if (last_recv_ns == 0) return;
+  const TsNanos est_now = last_ev_ts + (now - last_recv_ns);
+  book_timer(est_now);
+}
+
+void LiveEngine::run(const std::atomic<bool>& stop) {
+  for (;;) {
+    if (poll() != 0) continue;
+    if (stop.load(std::memory_order_acquire) && feed.depth() == 0) {
+      // finish a replay that is making progress; a recovery still waiting
+      // on a snapshot at end of feed is given up rather than waited out
+      if (recovering() && drive_recovery() != 0) continue;
+      if (recovering()) { recovery->abandon(); end_recovery(); }
+      break;
+    }
+    idle();
+    cpu_relax();
+  }
+  if (conflate) {
+    conflate = false;
+    st.conflated_ns += TscClock::now_ns() - conflate_since_ns;
+  }
+}
+
+void LiveEngine::route(TsNanos ts) {
+  if (orders && strat.pos().lots() != routed_lots) {
+    orders->on_position(ts, routed_lots, strat.pos().lots(), last_quote);
+    routed_lots = strat.pos().lots();
+  }
+}
+
+// closed_side is the position before the fill, so exits and flips log the side closed
+void LiveEngine::book_fill(double realized, TsNanos ts, int closed_side) {
+  route(ts);
+  if (realized == 0.0) return;
+  st.pnl += realized;
+  ++st.fills;
+  OFI_LOG(Fill, ts, realized, closed_side);
+}
+
+// hold exits and other timer work; logged as TimerExit, as in the backtest
+void LiveEngine::book_timer(TsNanos ts) {
+  const double realized = strat.advance(ts);
+  route(ts);
+  if (realized == 0.0) return;
+  st.pnl += realized;
+  ++st.fills;
+  OFI_LOG(TimerExit, ts, realized);
+}
+
+// normal mode: every gated quote gets its own decision
+void LiveEngine::process_each(const FeedMsg* m, std::size_t n) {
+  for (std::size_t k = 0; k < n; ++k) {
+    const Event& e = m[k].ev;
+    book_timer(e.ts);
+    if (e.type == EvType::Trade) { ++st.trades; strat.on_trade(e.t); continue; }
+
+    ++st.quotes;
+    last_quote = e.q;
+    have_quote = true;
+    if (reload_book) { strat.load_snapshot(e.q); reload_book = false; continue; }
+    strat.mark(e.q);
+    if (!strat.admit(e.q)) continue;
+    ++st.gated_quotes;
+
+    const auto sig = strat.on_quote(e.q);
+    const std::int64_t decided = probe ? TscClock::now_ns() : 0;
+    ++st.decisions;
+    if (sig.has_value()) {
+      ++st.signals;
+      OFI_LOG(Signal, e.ts, *sig, strat.ofi(), strat.imbalance_ticks());
+    }
+    const int side0 = strat.pos().side, lots0 = strat.pos().lots();
+    book_fill(strat.act_and_fill(e.ts, 0.5 * (e.q.bid_px + e.q.ask_px), sig), e.ts, side0);
+    if (probe) record_latency(m[k], decided, TscClock::now_ns(), strat.pos().lots() != lots0);
+  }
+}
+
+void LiveEngine::record_latency(const FeedMsg& m, std::int64_t decided_ns, std::int64_t sent_ns, bool sent) {
+  if (m.seq <= probe->warmup_seq) return;
+  const std::int64_t sched = m.sched_ns ? m.sched_ns : m.recv_ns;
+  probe->decide.record(decided_ns - sched);
+  probe->decide_naive.record(decided_ns - m.recv_ns);
+  if (!sent) return;
+  probe->send.record(sent_ns - sched);
+  probe->send_naive.record(sent_ns - m.recv_ns);
+}
+
+// conflated mode: OFI accumulates over every gated quote, one decision on the latest book
+void LiveEngine::process_conflated(const FeedMsg* m, std::size_t n) {
+  const Event* latest = nullptr;
+  std::uint64_t folded = 0;
+
+  for (std::size_t k = 0; k < n; ++k) {
+    const Event& e = m[k].ev;
+    book_timer(e.ts);
+    if (e.type == EvType::Trade) { ++st.trades; strat.on_trade(e.t); continue; }
+
+    ++st.quotes;
+    last_quote = e.q;
+    have_quote = true;
+    if (reload_book) { strat.load_snapshot(e.q); reload_book = false; continue; }
+    strat.mark(e.q);
+    if (!strat.admit(e.q)) continue;
+    ++st.gated_quotes;
+
+    strat.absorb_quote(e.q);
+    latest = &e;
+    ++folded;
+    if (probe) folded_msgs.push_back(&m[k]);
+  }
+  if (!latest) return;
+
+  st.conflated_quotes += folded - 1;
+  const auto sig = strat.decide();
+  const std::int64_t decided = probe ? TscClock::now_ns() : 0;
+  ++st.decisions;
+  if (sig.has_value()) {
+    ++st.signals;
+    OFI_LOG(Signal, latest->ts, *sig, strat.ofi(), strat.imbalance_ticks());
+  }
+  const int side0 = strat.pos().side, lots0 = strat.pos().lots();
+  book_fill(strat.act_and_fill(latest->ts, 0.5 * (latest->q.bid_px + latest->q.ask_px), sig), latest->ts, side0);
+  if (!probe) return;
+
+  // every folded quote was reflected in this one decision
+  const std::int64_t sent = TscClock::now_ns();
+  const bool changed = strat.pos().lots() != lots0;
+  for (const FeedMsg* f : folded_msgs) record_latency(*f, decided, sent, changed);
+  folded_msgs.clear();
+}
+
+void LiveEngine::flatten() {
+  if (strat.pos().side == 0 || !have_quote) return;
+  const int closed_side = strat.pos().side;
+  book_fill(strat.act_and_fill(last_quote.ts, 0.5 * (last_quote.bid_px + last_quote.ask_px), 0),
+            last_quote.ts, closed_side);
+}
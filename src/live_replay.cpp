@@ -0,0 +1,188 @@
+#include <atomic>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "common/Clock.hpp"
+#include "common/Counters.hpp"
+#include "common/Types.hpp"
+#include "live/BookRecovery.hpp"
+#include "live/LiveEngine.hpp"
+#include "log/BinLog.hpp"
+#include "order/Gateway.hpp"
+#include "order/OrderEntry.hpp"
+#include "pipeline/Stages.hpp"
+#include "strategy/QueueOfi.hpp"
+#include "telemetry/ShmTelemetry.hpp"
+
+// Replays a day through the live path: a feed thread paces the recorded
+// events into the SPSC ring at --speed× real time (0 = as fast as
+// possible) while the engine consumes on the main thread.
+int main(int argc, char** argv) {
+  std::string ymd = "20231002";
+  double speed = 1.0;
+  LiveOptions lo;
+  std::string log_path;
+  bool telemetry = false;   // publish counters to shared memory for ofi_monitor
+  bool orders = false;      // route position changes as SBE orders to the loopback gateway
+  // recovery drills: lose every Nth message / join after N messages; the
+  // feed publishes a book snapshot every --snapshot-every messages to a
+  // channel stand-in, or appends it to --snapshot-file
+  std::uint64_t drop_every = 0, start_at = 0, snapshot_every = 5000;
+  std::string snapshot_file;
+  for (int i = 1; i < argc; ++i) {
+    const std::string a = argv[i];
+    if      (a.rfind("--speed=", 0) == 0) speed = std::stod(a.substr(8));
+    else if (a.rfind("--enter=", 0) == 0) lo.conflate_enter = std::stoull(a.substr(8));
+    else if (a.rfind("--exit=", 0) == 0)  lo.conflate_exit  = std::stoull(a.substr(7));
+    else if (a.rfind("--log=", 0) == 0)   log_path = a.substr(6);
+    else if (a == "--telemetry")          telemetry = true;
+    else if (a == "--orders=loopback")    orders = true;
+    else if (a.rfind("--drop-every=", 0) == 0)     drop_every = std::stoull(a.substr(13));
+    else if (a.rfind("--start-at=", 0) == 0)       start_at = std::stoull(a.substr(11));
+    else if (a.rfind("--snapshot-every=", 0) == 0) snapshot_every = std::stoull(a.substr(17));
+    else if (a.rfind("--snapshot-file=", 0) == 0)  snapshot_file = a.substr(16);
+    else if (a.rfind("--", 0) != 0)       ymd = a;
+    else {
+      std::cerr << "Usage: live_replay [YYYYMMDD] [--speed=X] [--enter=N] [--exit=N] [--log=FILE] [--telemetry]\n"
+                   "                   [--orders=loopback] [--drop-every=N] [--start-at=N] [--snapshot-every=N] [--snapshot-file=PATH]\n";
+      return 1;
+    }
+  }
+
+  const std::string mbp_path = "data/mbp-1/glbx-mdp3-" + ymd + ".mbp-1.dbn.zst";
+  const std::string trd_path = "data/trades/glbx-mdp3-" + ymd + ".trades.dbn.zst";
+  if (!std::filesystem::exists(mbp_path)) {
+    std::cerr << "Missing MBP-1 file: " << mbp_path << "\n"; return 1;
+  }
+  const std::uint32_t ESZ3_ID = 314863;
+
+  // same parameters as backtest_ofi
+  OfiParams P;
+  P.tick_size   = 0.25;
+  P.tick_value  = 12.5;
+  P.theta_ofi   = 5.0;
+  P.theta_imb   = 0.15;
+  P.slip_ticks  = 1;
+  P.max_hold_ns = 2'000'000'000LL;
+  P.min_spread_ticks       = 1;
+  P.min_bid_sz             = 2;
+  P.min_ask_sz             = 2;
+  P.persist_updates        = 3;
+  P.min_flip_cooldown_ns   = 120'000'000LL;
+  P.rth_only               = true;
+  P.fill_at_touch_when_spread1 = true;
+  P.trade_confirm_ns           = 0;
+
+  if (!log_path.empty() && !BinLog::start(log_path)) {
+    std::cerr << "Cannot open log file: " << log_path << "\n"; return 1;
+  }
+
+  lo.recover_on_start = start_at > 0;
+  LiveEngine engine(P, lo);
+
+  const bool drills = drop_every > 0 || start_at > 0 || !snapshot_file.empty();
+  ChannelSnapshotSource snap_channel;
+  FileSnapshotSource    snap_file_src(snapshot_file);
+  SnapshotWriter        snap_writer;
+  if (!snapshot_file.empty() && !snap_writer.open(snapshot_file)) {
+    std::cerr << "Cannot open snapshot file: " << snapshot_file << "\n"; return 1;
+  }
+  if (drills) {
+    if (snapshot_file.empty()) engine.attach_recovery(snap_channel);
+    else                       engine.attach_recovery(snap_file_src);
+  }
+  TelemetryPublisher tlm;
+  if (telemetry) {
+    if (tlm.open("live_replay " + ymd)) engine.attach_telemetry(&tlm);
+    else std::cerr << "Telemetry unavailable; continuing without it\n";
+  }
+  LoopbackTransport order_tx;
+  OrderEntry<LoopbackTransport> order_entry(order_tx, ESZ3_ID);
+  PositionRouter<LoopbackTransport> router(order_entry);
+  if (orders) engine.attach_orders(&router);
+  std::atomic<bool> feed_done{false};
+  std::uint64_t producer_stalls = 0;
+
+  std::thread feeder([&] {
+    auto events = day_stage(mbp_path, std::filesystem::exists(trd_path) ? trd_path : std::string{},
+                            ESZ3_ID, P.rth_only);
+    auto& ring = engine.ring();
+    std::uint64_t seq = 0;
+    QuoteL1 book{};
+    TsNanos first_ts = -1;
+    std::int64_t wall0 = 0;
+
+    for (const auto& chunk : events)
+    for (const auto& e : chunk) {
+      if (first_ts < 0) { first_ts = e.ts; wall0 = TscClock::now_ns(); }
+      if (speed > 0.0) {
+        const std::int64_t due = wall0 + static_cast<std::int64_t>((e.ts - first_ts) / speed);
+        while (TscClock::now_ns() < due) {}
+      }
+      ++seq;
+      if (e.type == EvType::Quote) book = e.q;
+      if (drills && snapshot_every && seq % snapshot_every == 0) {
+        const BookSnapshot snap{seq, book};
+        if (snapshot_file.empty()) snap_channel.publish(snap);
+        else                       snap_writer.append(snap);
+      }
+      if (seq <= start_at || (drop_every && seq % drop_every == 0)) continue;
+      FeedMsg m{e, TscClock::now_ns(), seq};
+      while (!ring.try_push(m)) ++producer_stalls;
+    }
+    feed_done.store(true, std::memory_order_release);
+  });
+
+  engine.run(feed_done);
+  feeder.join();
+  engine.flatten();
+  engine.publish_telemetry(TscClock::now_ns());
+  BinLog::stop();
+
+  const LiveStats& s = engine.stats();
+  std::cout << std::fixed << std::setprecision(2);
+  std::cout << "Events: " << s.events
+            << "  Fills: " << s.fills
+            << "  PnL: $" << s.pnl << "\n";
+  std::cout << "[live] quotes=" << s.quotes
+            << " trades=" << s.trades
+            << " gated=" << s.gated_quotes
+            << " decisions=" << s.decisions
+            << " signals=" << s.signals
+            << " max_depth=" << s.max_depth
+            << " producer_stalls=" << producer_stalls << "\n";
+  std::cout << "[burst] conflation_episodes=" << s.conflation_episodes
+            << " conflated_quotes=" << s.conflated_quotes
+            << " conflated_ms=" << s.conflated_ns / 1e6
+            << " behind_us(mean/max)=" << s.mean_behind_ns() / 1e3
+            << "/" << s.max_behind_ns / 1e3 << "\n";
+  print_funnel(std::cout, engine.strategy().counters());
+  print_load_counters(std::cout, CounterRegistry::total());
+  if (orders) {
+    const OrderEntryStats& o = order_entry.stats();
+    std::cout << "[orders] sent=" << o.sent
+              << " send_failed=" << o.send_failed
+              << " acks=" << o.acks
+              << " fills=" << o.fills
+              << " rejects=" << o.rejects << "\n";
+  }
+  if (const RecoveryStats* r = engine.recovery_stats()) {
+    std::cout << "[recovery] gaps=" << s.seq_gaps
+              << " stale=" << s.stale_msgs
+              << " recoveries=" << r->recoveries
+              << " restarts=" << r->restarts
+              << " buffered=" << r->buffered
+              << " replayed=" << r->replayed
+              << " max_buffered=" << r->max_buffered
+              << " snapshots_rejected=" << r->snapshots_rejected
+              << " abandoned=" << r->abandoned
+              << " recovery_us(mean/max)=" << r->mean_recovery_ns() / 1e3
+              << "/" << r->max_recovery_ns / 1e3
+              << " snapshot_wait_us=" << (r->recoveries ? r->snapshot_wait_ns / 1e3 / double(r->recoveries) : 0.0)
+              << "\n";
+  }
+  return 0;
+}
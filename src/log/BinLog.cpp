@@ -0,0 +1,113 @@
+#include "log/BinLog.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// File layout (little endian):
+//   "OFIBLOG1"
+//   double ns_per_tick, u64 tsc0, i64 ns0      -- TSC -> ns calibration
+//   u16 n_formats, then per format: u16 len, len bytes
+//   LogRecord * N
+namespace {
+const char* const kFormats[] = {
+#define OFI_BINLOG_STR(id, fmt) fmt,
+  OFI_BINLOG_FORMATS(OFI_BINLOG_STR)
+#undef OFI_BINLOG_STR
+};
+
+std::mutex reg_mu;
+std::vector<std::unique_ptr<SpscRing<LogRecord>>> rings;  // never shrinks while running
+std::FILE* out = nullptr;
+std::thread writer;
+std::atomic<bool> writer_stop{false};
+
+std::size_t drain_all(std::vector<LogRecord>& buf) {
+  std::size_t n = 0;
+  std::vector<SpscRing<LogRecord>*> snap;
+  {
+    std::lock_guard<std::mutex> lk(reg_mu);
+    for (auto& r : rings) snap.push_back(r.get());
+  }
+  for (auto* r : snap) {
+    LogRecord rec;
+    buf.clear();
+    while (buf.size() < 4096 && r->try_pop(rec)) buf.push_back(rec);
+    if (!buf.empty()) {
+      std::fwrite(buf.data(), sizeof(LogRecord), buf.size(), out);
+      n += buf.size();
+    }
+  }
+  return n;
+}
+
+void writer_loop() {
+  std::vector<LogRecord> buf;
+  buf.reserve(4096);
+  for (;;) {
+    const bool stopping = writer_stop.load(std::memory_order_acquire);
+    const std::size_t n = drain_all(buf);
+    BinLog::stats_add_written(n);
+    if (n == 0) {
+      if (stopping) break;
+      std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+  }
+  std::fflush(out);
+}
+}  // namespace
+
+const char* BinLog::format_of(LogFmt f) {
+  const auto i = static_cast<std::size_t>(f);
+  return i < static_cast<std::size_t>(LogFmt::Count) ? kFormats[i] : "?";
+}
+
+bool BinLog::start(const std::string& path) {
+  if (enabled()) return true;
+  out = std::fopen(path.c_str(), "wb");
+  if (!out) return false;
+
+  const double ns_per_tick = TscClock::ns_per_tick();
+  const std::uint64_t t0 = TscClock::ticks();
+  const std::int64_t ns0 = TscClock::to_ns(t0);
+  std::fwrite("OFIBLOG1", 1, 8, out);
+  std::fwrite(&ns_per_tick, sizeof ns_per_tick, 1, out);
+  std::fwrite(&t0, sizeof t0, 1, out);
+  std::fwrite(&ns0, sizeof ns0, 1, out);
+  const auto n_fmt = static_cast<std::uint16_t>(LogFmt::Count);
+  std::fwrite(&n_fmt, sizeof n_fmt, 1, out);
+  for (std::uint16_t i = 0; i < n_fmt; ++i) {
+    const auto len = static_cast<std::uint16_t>(std::strlen(kFormats[i]));
+    std::fwrite(&len, sizeof len, 1, out);
+    std::fwrite(kFormats[i], 1, len, out);
+  }
+
+  writer_stop.store(false);
+  writer = std::thread(writer_loop);
+  on.store(true, std::memory_order_release);
+  return true;
+}
+
+void BinLog::stop() {
+  if (!enabled()) return;
+  on.store(false, std::memory_order_release);
+  writer_stop.store(true, std::memory_order_release);
+  writer.join();
+  std::fclose(out);
+  out = nullptr;
+}
+
+void BinLog::stats_add_written(std::size_t n) {
+  if (n) n_written.fetch_add(n, std::memory_order_relaxed);
+}
+
+SpscRing<LogRecord>* BinLog::register_thread() {
+  std::lock_guard<std::mutex> lk(reg_mu);
+  rings.push_back(std::make_unique<SpscRing<LogRecord>>(kRingRecords));
+  tl_ring   = rings.back().get();
+  thread_no = static_cast<std::uint8_t>(rings.size() - 1);
+  return tl_ring;
+}
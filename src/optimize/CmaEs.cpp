@@ -0,0 +1,162 @@
+#include "optimize/CmaEs.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+// symmetric eigendecomposition by cyclic Jacobi rotations; A (n x n,
+// row-major) is destroyed, eigenvectors land in the columns of V
+static void jacobi_eigen(std::vector<double>& A, std::size_t n, std::vector<double>& V,
+                         std::vector<double>& eig) {
+  V.assign(n * n, 0.0);
+  for (std::size_t i = 0; i < n; ++i) V[i * n + i] = 1.0;
+  for (int sweep = 0; sweep < 64; ++sweep) {
+    double off = 0.0;
+    for (std::size_t i = 0; i < n; ++i)
+      for (std::size_t j = i + 1; j < n; ++j) off += A[i * n + j] * A[i * n + j];
+    if (off < 1e-30) break;
+    for (std::size_t p = 0; p < n; ++p)
+      for (std::size_t q = p + 1; q < n; ++q) {
+        const double apq = A[p * n + q];
+        if (std::fabs(apq) < 1e-300) continue;
+        const double theta = (A[q * n + q] - A[p * n + p]) / (2.0 * apq);
+        const double t = (theta >= 0 ? 1.0 : -1.0) / (std::fabs(theta) + std::sqrt(theta * theta + 1.0));
+        const double c = 1.0 / std::sqrt(t * t + 1.0), s = t * c;
+        for (std::size_t k = 0; k < n; ++k) {
+          const double akp = A[k * n + p], akq = A[k * n + q];
+          A[k * n + p] = c * akp - s * akq;
+          A[k * n + q] = s * akp + c * akq;
+        }
+        for (std::size_t k = 0; k < n; ++k) {
+          const double apk = A[p * n + k], aqk = A[q * n + k];
+          A[p * n + k] = c * apk - s * aqk;
+          A[q * n + k] = s * apk + c * aqk;
+        }
+        for (std::size_t k = 0; k < n; ++k) {
+          const double vkp = V[k * n + p], vkq = V[k * n + q];
+          V[k * n + p] = c * vkp - s * vkq;
+          V[k * n + q] = s * vkp + c * vkq;
+        }
+      }
+  }
+  eig.resize(n);
+  for (std::size_t i = 0; i < n; ++i) eig[i] = A[i * n + i];
+}
+
+// fold a coordinate back into [0,1] (mirror at the walls)
+static double reflect01(double v) {
+  v = std::fmod(std::fabs(v), 2.0);
+  return v > 1.0 ? 2.0 - v : v;
+}
+
+CmaEs::CmaEs(std::vector<double> x0, CmaEsOptions opt)
+    : n(x0.size()), m(std::move(x0)), sigma(opt.sigma0), tol_x(opt.tol_x),
+      bf(std::numeric_limits<double>::infinity()), rng(opt.seed) {
+  const double N = double(n);
+  lambda = opt.popsize ? opt.popsize : 4 + static_cast<std::size_t>(3.0 * std::log(N));
+  lambda = std::max<std::size_t>(lambda, 2);
+  mu = lambda / 2;
+
+  w.resize(mu);
+  for (std::size_t i = 0; i < mu; ++i) w[i] = std::log(double(mu) + 0.5) - std::log(double(i) + 1.0);
+  const double ws = std::accumulate(w.begin(), w.end(), 0.0);
+  for (double& x : w) x /= ws;
+  double w2 = 0.0;
+  for (double x : w) w2 += x * x;
+  mueff = 1.0 / w2;
+
+  cc    = (4.0 + mueff / N) / (N + 4.0 + 2.0 * mueff / N);
+  cs    = (mueff + 2.0) / (N + mueff + 5.0);
+  c1    = 2.0 / ((N + 1.3) * (N + 1.3) + mueff);
+  cmu   = std::min(1.0 - c1, 2.0 * (mueff - 2.0 + 1.0 / mueff) / ((N + 2.0) * (N + 2.0) + mueff));
+  damps = 1.0 + 2.0 * std::max(0.0, std::sqrt((mueff - 1.0) / (N + 1.0)) - 1.0) + cs;
+  chi_n = std::sqrt(N) * (1.0 - 1.0 / (4.0 * N) + 1.0 / (21.0 * N * N));
+
+  ps.assign(n, 0.0);
+  pc.assign(n, 0.0);
+  C.assign(n * n, 0.0);
+  for (std::size_t i = 0; i < n; ++i) C[i * n + i] = 1.0;
+  B = C;
+  D.assign(n, 1.0);
+  xs.assign(lambda, std::vector<double>(n));
+  ys.assign(lambda, std::vector<double>(n));
+  for (double& v : m) v = std::clamp(v, 0.0, 1.0);
+  bx = m;
+}
+
+const std::vector<std::vector<double>>& CmaEs::ask() {
+  std::vector<double> z(n);
+  for (std::size_t k = 0; k < lambda; ++k) {
+    for (double& v : z) v = gauss(rng);
+    for (std::size_t i = 0; i < n; ++i) {
+      double y = 0.0;
+      for (std::size_t j = 0; j < n; ++j) y += B[i * n + j] * D[j] * z[j];
+      xs[k][i] = reflect01(m[i] + sigma * y);
+      ys[k][i] = (xs[k][i] - m[i]) / sigma;   // the step actually taken, after reflection
+    }
+  }
+  return xs;
+}
+
+void CmaEs::tell(const std::vector<double>& fitness) {
+  std::vector<std::size_t> idx(lambda);
+  std::iota(idx.begin(), idx.end(), 0);
+  std::sort(idx.begin(), idx.end(), [&](std::size_t a, std::size_t b) { return fitness[a] < fitness[b]; });
+  evals += lambda;
+  ++gen;
+  if (fitness[idx[0]] < bf) { bf = fitness[idx[0]]; bx = xs[idx[0]]; }
+
+  // weighted mean step of the best mu
+  std::vector<double> yw(n, 0.0);
+  for (std::size_t r = 0; r < mu; ++r)
+    for (std::size_t i = 0; i < n; ++i) yw[i] += w[r] * ys[idx[r]][i];
+  for (std::size_t i = 0; i < n; ++i) m[i] += sigma * yw[i];
+
+  // C^{-1/2} yw = B D^{-1} B^T yw
+  std::vector<double> t(n, 0.0), cy(n, 0.0);
+  for (std::size_t j = 0; j < n; ++j) {
+    for (std::size_t i = 0; i < n; ++i) t[j] += B[i * n + j] * yw[i];
+    t[j] /= D[j];
+  }
+  for (std::size_t i = 0; i < n; ++i)
+    for (std::size_t j = 0; j < n; ++j) cy[i] += B[i * n + j] * t[j];
+
+  const double a_s = std::sqrt(cs * (2.0 - cs) * mueff);
+  double ps_norm = 0.0;
+  for (std::size_t i = 0; i < n; ++i) {
+    ps[i] = (1.0 - cs) * ps[i] + a_s * cy[i];
+    ps_norm += ps[i] * ps[i];
+  }
+  ps_norm = std::sqrt(ps_norm);
+  const double hsig_den = std::sqrt(1.0 - std::pow(1.0 - cs, 2.0 * double(gen)));
+  const bool hsig = ps_norm / hsig_den / chi_n < 1.4 + 2.0 / (double(n) + 1.0);
+
+  const double a_c = std::sqrt(cc * (2.0 - cc) * mueff);
+  for (std::size_t i = 0; i < n; ++i) pc[i] = (1.0 - cc) * pc[i] + (hsig ? a_c * yw[i] : 0.0);
+
+  const double keep = 1.0 - c1 - cmu + (hsig ? 0.0 : c1 * cc * (2.0 - cc));
+  for (std::size_t i = 0; i < n; ++i)
+    for (std::size_t j = 0; j <= i; ++j) {
+      double rank_mu = 0.0;
+      for (std::size_t r = 0; r < mu; ++r) rank_mu += w[r] * ys[idx[r]][i] * ys[idx[r]][j];
+      const double v = keep * C[i * n + j] + c1 * pc[i] * pc[j] + cmu * rank_mu;
+      C[i * n + j] = C[j * n + i] = v;
+    }
+
+  sigma *= std::exp((cs / damps) * (ps_norm / chi_n - 1.0));
+  sigma = std::min(sigma, 1.0);   // the whole box is 1 wide
+  decompose();
+}
+
+void CmaEs::decompose() {
+  std::vector<double> A = C, eig;
+  jacobi_eigen(A, n, B, eig);
+  for (std::size_t i = 0; i < n; ++i) D[i] = std::sqrt(std::max(eig[i], 1e-20));
+}
+
+bool CmaEs::converged() const {
+  for (std::size_t i = 0; i < n; ++i)
+    if (sigma * std::sqrt(C[i * n + i]) > tol_x) return false;
+  return true;
+}
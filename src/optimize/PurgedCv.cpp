@@ -0,0 +1,48 @@
+#include "optimize/PurgedCv.hpp"
+
+#include <algorithm>
+
+std::vector<std::size_t> cv_groups_of(std::size_t n_days, std::size_t groups) {
+  std::vector<std::size_t> g(n_days);
+  for (std::size_t d = 0; d < n_days; ++d) g[d] = d * groups / n_days;   // sizes differ by at most one
+  return g;
+}
+
+std::vector<CvSplit> cpcv_splits(std::size_t n_days, const CvOptions& o) {
+  std::vector<CvSplit> out;
+  if (o.groups == 0 || o.test_groups == 0 || o.test_groups >= o.groups || n_days < o.groups) return out;
+  const auto group = cv_groups_of(n_days, o.groups);
+
+  // every test_groups-subset of groups, in lexicographic order
+  std::vector<bool> pick(o.groups, false);
+  std::fill(pick.begin(), pick.begin() + static_cast<std::ptrdiff_t>(o.test_groups), true);
+  do {
+    CvSplit s;
+    for (std::size_t g = 0; g < o.groups; ++g)
+      if (pick[g]) s.test_groups.push_back(g);
+    for (std::size_t d = 0; d < n_days; ++d) {
+      if (pick[group[d]]) { s.test.push_back(d); continue; }
+      const std::size_t lo = d >= o.embargo ? d - o.embargo : 0;
+      const std::size_t hi = std::min(n_days - 1, d + o.embargo);
+      bool near_test = false;
+      for (std::size_t k = lo; k <= hi && !near_test; ++k) near_test = pick[group[k]];
+      if (!near_test) s.train.push_back(d);
+    }
+    out.push_back(std::move(s));
+  } while (std::prev_permutation(pick.begin(), pick.end()));
+  return out;
+}
+
+std::vector<std::vector<std::size_t>> cpcv_paths(const std::vector<CvSplit>& splits, std::size_t groups) {
+  std::vector<std::vector<std::size_t>> tested_in(groups);
+  for (std::size_t i = 0; i < splits.size(); ++i)
+    for (std::size_t g : splits[i].test_groups) tested_in[g].push_back(i);
+
+  std::size_t n_paths = tested_in.empty() ? 0 : tested_in[0].size();
+  for (const auto& t : tested_in) n_paths = std::min(n_paths, t.size());
+
+  std::vector<std::vector<std::size_t>> paths(n_paths, std::vector<std::size_t>(groups));
+  for (std::size_t p = 0; p < n_paths; ++p)
+    for (std::size_t g = 0; g < groups; ++g) paths[p][g] = tested_in[g][p];
+  return paths;
+}
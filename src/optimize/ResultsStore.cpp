@@ -0,0 +1,39 @@
+#include "optimize/ResultsStore.hpp"
+
+bool ResultsStore::open(const std::string& path) {
+  close();
+  f = std::fopen(path.c_str(), "a");
+  if (!f) return false;
+  std::fseek(f, 0, SEEK_END);
+  if (std::ftell(f) == 0)
+    std::fputs("run,candidate,theta_ofi,theta_imb,slip,max_hold_s,cooldown_ms,min_bid_sz,min_ask_sz,"
+               "scope,bucket,trades,pnl,mean,sd,win_pct,sharpe\n", f);
+  return true;
+}
+
+void ResultsStore::close() {
+  if (f) std::fclose(f);
+  f = nullptr;
+}
+
+void ResultsStore::add(const std::string& run, std::size_t candidate, const OfiParams& P,
+                       const char* scope, const std::string& bucket, const OnlineStats& s) {
+  if (!f) return;
+  std::fprintf(f, "%s,%zu,%.6g,%.6g,%d,%.6g,%.6g,%d,%d,%s,%s,%llu,%.2f,%.4f,%.4f,%.2f,%.4f\n",
+               run.c_str(), candidate, P.theta_ofi, P.theta_imb, P.slip_ticks,
+               double(P.max_hold_ns) / 1e9, double(P.min_flip_cooldown_ns) / 1e6,
+               int(P.min_bid_sz), int(P.min_ask_sz), scope, bucket.c_str(),
+               static_cast<unsigned long long>(s.n), s.sum, s.mean, s.sd(), s.winrate(), s.sharpe());
+  ++n_rows;
+}
+
+void ResultsStore::add_all(const std::string& run, std::size_t candidate, const OfiParams& P,
+                           const SessionBuckets& b) {
+  OnlineStats all;
+  for (std::size_t d = 0; d < 7; ++d) all.merge(b.weekday(d));
+  add(run, candidate, P, "all", "", all);
+  for (std::size_t i = 0; i < b.buckets(); ++i)
+    if (b.bucket(i).n) add(run, candidate, P, "tod", b.bucket_label(i), b.bucket(i));
+  for (std::size_t d = 0; d < 7; ++d)
+    if (b.weekday(d).n) add(run, candidate, P, "dow", SessionBuckets::weekday_label(d), b.weekday(d));
+}
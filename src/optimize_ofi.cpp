@@ -1,47 +1,53 @@
 #include <algorithm>
+#include <array>
 #include <filesystem>
 #include <iomanip>
 #include <iostream>
+#include <map>
 #include <numeric>
+#include <span>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <vector>
 #include <cmath>
+#include <limits>
 
+#include "common/Clock.hpp"
+#include "common/Counters.hpp"
+#include "common/Rth.hpp"
+#include "common/SessionBuckets.hpp"
+#include "common/ThreadPool.hpp"
 #include "common/Types.hpp"
+#include "data/DayCache.hpp"
+#include "data/DayMerge.hpp"
+#include "data/ZoneMap.hpp"
+#include "data/DbnMemory.hpp"
 #include "data/DbnReader.hpp"
+#include "io/DayPrefetcher.hpp"
+#include "optimize/CmaEs.hpp"
+#include "optimize/Pareto.hpp"
+#include "optimize/PurgedCv.hpp"
+#include "optimize/ResultsStore.hpp"
 #include "strategy/QueueOfi.hpp"
-
-// ---------- Utilities ----------
-static std::vector<Event> merge_streams(const std::vector<QuoteL1>& qs,
-                                        const std::vector<Trade>& ts) {
-  std::vector<Event> ev;
-  ev.reserve(qs.size() + ts.size());
-  size_t i = 0, j = 0;
-  while (i < qs.size() || j < ts.size()) {
-    bool take_q = (j == ts.size()) || (i < qs.size() && qs[i].ts <= ts[j].ts);
-    if (take_q) { Event e; e.type = EvType::Quote; e.ts = qs[i].ts; e.q = qs[i]; ev.push_back(e); ++i; }
-    else        { Event e; e.type = EvType::Trade; e.ts = ts[j].ts; e.t = ts[j]; ev.push_back(e); ++j; }
-  }
-  return ev;
-}
-
-static double sharpe_annualized(const std::vector<double>& rets) {
-  if (rets.size() < 2) return 0.0;
-  double mean = std::accumulate(rets.begin(), rets.end(), 0.0) / rets.size();
-  double var = 0.0;
-  for (double r : rets) var += (r - mean) * (r - mean);
-  var /= (rets.size() - 1);
-  double sd = std::sqrt(std::max(1e-12, var));
-  const double trades_per_year = 60.0 * 252.0;
-  return (mean / sd) * std::sqrt(trades_per_year);
-}
+#include "telemetry/ShmTelemetry.hpp"
 
 struct RunStats {
+  explicit RunStats(std::int64_t bucket_s) : tod(bucket_s) {}   // --bucket-min, in seconds
+
   double pnl = 0.0;
-  std::vector<double> trade_pnls;
+  std::vector<double> trade_pnls;   // in time order (days added in date order)
+  size_t days = 0;
+  SessionBuckets tod;               // same fills, by intraday bucket and weekday
+  CounterSet ctr;                   // gate funnel of the strategy runs
   size_t trades() const { return trade_pnls.size(); }
   double sharpe() const { return sharpe_annualized(trade_pnls); }
+  double turnover() const { return days ? double(trades()) / double(days) : 0.0; }   // round trips per day
+  double max_drawdown() const {   // peak-to-trough of cumulative realized PnL, >= 0
+    double cum = 0.0, peak = 0.0, dd = 0.0;
+    for (double x : trade_pnls) { cum += x; peak = std::max(peak, cum); dd = std::max(dd, peak - cum); }
+    return dd;
+  }
   double winrate() const {
     if (trade_pnls.empty()) return 0.0;
     int wins=0; for (double x : trade_pnls) if (x > 0) ++wins;
@@ -49,71 +55,65 @@ struct RunStats {
   }
 };
 
-// --- RTH for Oct 2023 (EDT=UTC-4): 09:30–16:00 ET => 13:30–20:00 UTC
-static inline bool is_rth_utc(TsNanos ts_ns) {
-  const long long sec = ts_ns / 1'000'000'000LL;
-  const long long sec_in_day = sec % 86400LL;
-  return (sec_in_day >= 48600LL) && (sec_in_day < 72000LL);
-}
-
-static RunStats run_one_day(const std::string& ymd, const OfiParams& P) {
-  RunStats rs;
-
-  const std::string mbp_path = "data/mbp-1/glbx-mdp3-" + ymd + ".mbp-1.dbn.zst";
-  const std::string trd_path = "data/trades/glbx-mdp3-" + ymd + ".trades.dbn.zst";
-  if (!std::filesystem::exists(mbp_path)) return rs;
-
-  const std::uint32_t ESZ3_ID = 314863;
-
-  auto day_q = load_day_from_dbn(mbp_path, "mbp-1", ESZ3_ID);
-  DayEvents day_t;
-  if (std::filesystem::exists(trd_path)) day_t = load_day_from_dbn(trd_path, "trades", ESZ3_ID);
-
-  auto ev = merge_streams(day_q.quotes, day_t.trades);
-
-  QueueOfiStrategy strat(P);
-
-  for (const auto& e : ev) {
-    if (e.type == EvType::Trade) {
-      strat.on_trade(e.t);               // keep identical to backtest
-      continue;                          // no direct action on trades
+static RunStats run_one_day(const DayData& day, const OfiParams& P, std::int64_t bucket_s,
+                            const ZoneMap* zm = nullptr, ZoneStats* zs = nullptr) {
+  RunStats rs(bucket_s);
+  if (!day.has_quotes) return rs;
+
+  // zone map: a day that cannot signal trades nothing; idle minutes that
+  // cannot signal are skipped (the RLS alpha has no thresholds to check)
+  const bool zoned = zm && zs && !P.alpha_rls;
+  if (zoned) {
+    ++zs->day_runs;
+    if (!zm->may_signal(P)) {
+      ++zs->days_pruned;
+      for (const MinuteZone& m : zm->minutes()) count_skipped(rs.ctr, m);
+      return rs;
     }
+  }
 
-    const auto& q = e.q;
-
-    // --- SAME GATES AS BACKTEST (keep order identical) ---
-    if (P.rth_only && !is_rth_utc(e.ts)) continue;
+  QueueOfiStrategy strat(P);
+  auto record = [&](const Fill& f) {
+    rs.pnl += f.pnl;
+    rs.trade_pnls.push_back(f.pnl);
+    rs.tod.add(f.ts, f.pnl);
+  };
 
-    // spread == 1 tick
-    const double spr = q.ask_px - q.bid_px;
-    if (P.min_spread_ticks > 0) {
-      const double need = P.min_spread_ticks * P.tick_size;
-      if (std::fabs(spr - need) > 1e-9) continue;
+  // same gates as backtest, applied inside the batch loop
+  if (zoned) {
+    replay_with_zones(strat, day, *zm, P, *zs, record);
+  } else {
+    std::array<Fill, 1024> fills;
+    std::span<const Event> rest{day.events};
+    while (!rest.empty()) {
+      const BatchResult br = strat.on_events(rest, fills);
+      for (std::size_t k = 0; k < br.fills; ++k) record(fills[k]);
+      rest = rest.subspan(br.consumed);
     }
-
-    // min sizes
-    if (q.bid_sz < P.min_bid_sz || q.ask_sz < P.min_ask_sz) continue;
-
-    // signal & execution
-    auto sig = strat.on_quote(q);
-    const double mid = 0.5 * (q.bid_px + q.ask_px);
-    double realized = strat.act_and_fill(e.ts, mid, sig);
-    if (realized != 0.0) { rs.pnl += realized; rs.trade_pnls.push_back(realized); }
   }
 
   // EOD flatten
-  if (strat.pos().side != 0 && !day_q.quotes.empty()) {
-    const auto& q = day_q.quotes.back();
+  if (strat.pos().side != 0) {
+    const auto& q = day.last_quote;
     if (!P.rth_only || is_rth_utc(q.ts)) {
       const double mid = 0.5 * (q.bid_px + q.ask_px);
       double realized = strat.act_and_fill(q.ts, mid, 0);
-      if (realized != 0.0) { rs.pnl += realized; rs.trade_pnls.push_back(realized); }
+      if (realized != 0.0) { rs.pnl += realized; rs.trade_pnls.push_back(realized); rs.tod.add(q.ts, realized); }
     }
   }
 
+  rs.ctr = strat.counters();
   return rs;
 }
 
+static void add_day(RunStats& agg, const RunStats& rs) {
+  agg.pnl += rs.pnl;
+  ++agg.days;
+  agg.tod.merge(rs.tod);
+  agg.ctr.merge(rs.ctr);
+  agg.trade_pnls.insert(agg.trade_pnls.end(), rs.trade_pnls.begin(), rs.trade_pnls.end());
+}
+
 static std::vector<std::string> ymd_range_202310(int d0, int d1) {
   std::vector<std::string> v;
   for (int d=d0; d<=d1; ++d) {
@@ -124,6 +124,59 @@ static std::vector<std::string> ymd_range_202310(int d0, int d1) {
   return v;
 }
 
+static std::string mbp_path_for(const std::string& ymd) {
+  return "data/mbp-1/glbx-mdp3-" + ymd + ".mbp-1.dbn.zst";
+}
+static std::string trd_path_for(const std::string& ymd) {
+  return "data/trades/glbx-mdp3-" + ymd + ".trades.dbn.zst";
+}
+
+// One pass over the days on disk, scheduled by the cache: resident days
+// first, then misses, whose files are read ahead asynchronously while the
+// current day decodes. Callers run every combo on a day before moving on.
+template <class F>
+static std::size_t for_each_day(DayCache& cache, const std::vector<std::string>& days, F&& f) {
+  constexpr std::uint32_t ESZ3_ID = 314863;
+
+  std::vector<std::string> on_disk;
+  for (const auto& ymd : days)
+    if (std::filesystem::exists(mbp_path_for(ymd))) on_disk.push_back(ymd);
+
+  const auto order = cache.schedule(on_disk);
+  std::vector<std::string> misses, files;
+  for (const auto& ymd : order) {
+    if (cache.resident(ymd)) continue;
+    misses.push_back(ymd);
+    files.push_back(mbp_path_for(ymd));
+    files.push_back(trd_path_for(ymd));   // a missing trades file just reads as empty
+  }
+
+  DayPrefetcher pf(files);
+  std::size_t next_miss = 0;
+  auto loader = [&](const std::string& ymd) -> DayData {
+    if (next_miss < misses.size() && misses[next_miss] == ymd) {
+      const std::size_t d = next_miss++;
+      DayEvents day_q = load_day_from_buffer(pf.acquire(2 * d), "mbp-1", ESZ3_ID);
+      pf.release(2 * d);
+      DayEvents day_t = load_day_from_buffer(pf.acquire(2 * d + 1), "trades", ESZ3_ID);
+      pf.release(2 * d + 1);
+      return make_day(day_q, day_t);
+    }
+    // was resident at schedule time but got evicted since: read it synchronously
+    DayEvents day_q = load_day_from_dbn(mbp_path_for(ymd), "mbp-1", ESZ3_ID);
+    DayEvents day_t;
+    if (std::filesystem::exists(trd_path_for(ymd)))
+      day_t = load_day_from_dbn(trd_path_for(ymd), "trades", ESZ3_ID);
+    return make_day(day_q, day_t);
+  };
+
+  for (const auto& ymd : order) {
+    auto day = cache.get(ymd, loader);
+    f(ymd, *day);
+  }
+  return order.size();
+}
+
 struct ParamCombo {
   double theta_ofi;
   double theta_imb;
@@ -131,7 +184,264 @@ struct ParamCombo {
   std::int64_t max_hold_ns;
 };
 
-int main(int, char**) {
+static OfiParams params_for(const ParamCombo& pc) {
+  // product constants (ES)
+  OfiParams P;
+  P.tick_size   = 0.25;
+  P.tick_value  = 12.5;
+  P.theta_ofi   = pc.theta_ofi;
+  P.theta_imb   = pc.theta_imb;
+  P.slip_ticks  = pc.slip_ticks;
+  P.max_hold_ns = pc.max_hold_ns;
+
+  // --- gates/assumptions: EXACT match to working backtest ---
+  P.min_spread_ticks       = 1;
+  P.min_bid_sz             = 2;
+  P.min_ask_sz             = 2;
+  P.persist_updates        = 3;
+  P.min_flip_cooldown_ns   = 120'000'000LL;   // 120ms
+  P.rth_only               = true;
+
+  // Assumptions you used in backtest:
+  P.fill_at_touch_when_spread1 = true;
+  P.trade_confirm_ns           = 0;           // disabled
+  return P;
+}
+
+// --- continuous search space for --search=cmaes: each knob is a [0,1]
+// coordinate mapped onto [lo, hi]; log scale for ranges spanning decades,
+// size gates rounded to whole lots. Everything else as in params_for().
+struct SearchDim {
+  const char* name;
+  double lo, hi;
+  bool   log_scale;
+  bool   integer;
+};
+static constexpr SearchDim kSearchDims[] = {
+  {"theta_ofi",  1.0,  20.0, true,  false},
+  {"theta_imb",  0.0,  0.6,  false, false},
+  {"max_hold_s", 0.25, 10.0, true,  false},
+  {"cooldown_s", 0.01, 1.0,  true,  false},
+  {"min_bid_sz", 1.0,  20.0, false, true},
+  {"min_ask_sz", 1.0,  20.0, false, true},
+};
+static constexpr std::size_t kSearchN = std::size(kSearchDims);
+
+static double from_unit(const SearchDim& d, double u) {
+  const double v = d.log_scale ? d.lo * std::pow(d.hi / d.lo, u) : d.lo + u * (d.hi - d.lo);
+  return d.integer ? std::round(v) : v;
+}
+static double to_unit(const SearchDim& d, double v) {
+  const double u = d.log_scale ? std::log(v / d.lo) / std::log(d.hi / d.lo) : (v - d.lo) / (d.hi - d.lo);
+  return std::clamp(u, 0.0, 1.0);
+}
+
+static OfiParams params_from_unit(const std::vector<double>& u) {
+  double v[kSearchN];
+  for (std::size_t i = 0; i < kSearchN; ++i) v[i] = from_unit(kSearchDims[i], u[i]);
+  OfiParams P = params_for({v[0], v[1], 1, static_cast<std::int64_t>(v[2] * 1e9)});
+  P.min_flip_cooldown_ns = static_cast<std::int64_t>(v[3] * 1e9);
+  P.min_bid_sz = static_cast<QtyI>(v[4]);
+  P.min_ask_sz = static_cast<QtyI>(v[5]);
+  return P;
+}
+
+static std::vector<double> unit_from_params(const OfiParams& P) {
+  const double v[kSearchN] = {P.theta_ofi, P.theta_imb, P.max_hold_ns / 1e9,
+                              P.min_flip_cooldown_ns / 1e9, double(P.min_bid_sz), double(P.min_ask_sz)};
+  std::vector<double> u(kSearchN);
+  for (std::size_t i = 0; i < kSearchN; ++i) u[i] = to_unit(kSearchDims[i], v[i]);
+  return u;
+}
+
+static void print_params(std::ostream& os, const OfiParams& P) {
+  os << "ofi=" << P.theta_ofi
+     << " imb=" << P.theta_imb
+     << " slip=" << P.slip_ticks
+     << " hold=" << (P.max_hold_ns/1e9) << "s"
+     << " cooldown=" << (P.min_flip_cooldown_ns/1e6) << "ms"
+     << " sz=" << P.min_bid_sz << "/" << P.min_ask_sz;
+}
+
+// --- Pareto front over train results: PnL, Sharpe, drawdown, turnover ---
+struct FrontPoint {
+  OfiParams P{};
+  double pnl = 0.0, sharpe = 0.0, max_dd = 0.0, turnover = 0.0;
+  size_t trades = 0;
+  SessionBuckets tod;   // copied from the RunStats it came from
+  CounterSet ctr;
+};
+using TrainFront = ParetoFront<4, FrontPoint>;
+
+static TrainFront::Objectives objectives_of(const RunStats& rs) {
+  return {rs.pnl, rs.sharpe(), -rs.max_drawdown(), -rs.turnover()};   // all maximized
+}
+
+static void print_point(std::ostream& os, const FrontPoint& fp) {
+  print_params(os, fp.P);
+  os << " | trades=" << fp.trades
+     << " pnl=$" << fp.pnl
+     << " sharpe=" << fp.sharpe
+     << " max_dd=$" << fp.max_dd
+     << " turnover=" << fp.turnover << "/day";
+}
+
+static double quantile_sorted(const std::vector<double>& v, double q) {
+  if (v.empty()) return 0.0;
+  const double pos = q * double(v.size() - 1);
+  const std::size_t i = static_cast<std::size_t>(pos);
+  const double f = pos - double(i);
+  return i + 1 < v.size() ? v[i] * (1.0 - f) + v[i + 1] * f : v[i];
+}
+
+// Sharpe of one combo over a set of days, from the per-day results
+static double sharpe_over(const std::vector<std::vector<RunStats>>& res, std::size_t c,
+                          const std::vector<std::size_t>& days, std::size_t* trades = nullptr) {
+  std::vector<double> pnls;
+  for (std::size_t d : days) pnls.insert(pnls.end(), res[d][c].trade_pnls.begin(), res[d][c].trade_pnls.end());
+  if (trades) *trades = pnls.size();
+  return sharpe_annualized(pnls);
+}
+
+// Combinatorial purged CV over per-day results res[day][combo]: in every
+// split the best combo on train (by Sharpe) is scored on test; the paths
+// stitch those test segments into full out-of-sample histories.
+static bool report_cpcv(const std::vector<std::vector<RunStats>>& res, const std::vector<std::string>& days,
+                        const std::vector<ParamCombo>& combos, const CvOptions& cv, ThreadPool& pool) {
+  const auto splits = cpcv_splits(days.size(), cv);
+  if (splits.empty()) {
+    std::cerr << "CPCV needs test-groups < groups <= days (have " << days.size() << " days)\n";
+    return false;
+  }
+  struct Fold { std::size_t best = 0; double is = 0.0, oos = 0.0; std::size_t oos_trades = 0; bool overfit = false; };
+  std::vector<Fold> folds(splits.size());
+  pool.parallel_for(splits.size(), [&](std::size_t i) {
+    const CvSplit& s = splits[i];
+    Fold& f = folds[i];
+    f.is = -1e9;
+    std::vector<double> oos_all(combos.size());
+    for (std::size_t c = 0; c < combos.size(); ++c) {
+      const double is = sharpe_over(res, c, s.train);
+      if (is > f.is) { f.is = is; f.best = c; }
+      oos_all[c] = sharpe_over(res, c, s.test);
+    }
+    f.oos = sharpe_over(res, f.best, s.test, &f.oos_trades);
+    // overfit: the in-sample winner lands in the bottom half out of sample
+    std::sort(oos_all.begin(), oos_all.end());
+    f.overfit = f.oos <= quantile_sorted(oos_all, 0.5);
+  });
+
+  std::size_t overfit = 0;
+  for (std::size_t i = 0; i < splits.size(); ++i) {
+    const CvSplit& s = splits[i];
+    const Fold& f = folds[i];
+    const ParamCombo& pc = combos[f.best];
+    overfit += f.overfit;
+    std::cout << "[cv] split=" << i << " test_groups=";
+    for (std::size_t k = 0; k < s.test_groups.size(); ++k) std::cout << (k ? "," : "") << s.test_groups[k];
+    std::cout << " train_days=" << s.train.size()
+              << " test_days=" << s.test.size()
+              << " | best ofi=" << pc.theta_ofi << " imb=" << pc.theta_imb
+              << " hold=" << (pc.max_hold_ns/1e9) << "s"
+              << " | is_sharpe=" << f.is
+              << " oos_sharpe=" << f.oos
+              << " oos_trades=" << f.oos_trades << "\n";
+  }
+
+  // each path: for every group, the test segment of the split it was assigned to
+  const auto paths = cpcv_paths(splits, cv.groups);
+  const auto group = cv_groups_of(days.size(), cv.groups);
+  std::vector<double> path_sharpe;
+  for (const auto& path : paths) {
+    std::vector<double> pnls;
+    for (std::size_t d = 0; d < days.size(); ++d) {
+      const auto& r = res[d][folds[path[group[d]]].best];
+      pnls.insert(pnls.end(), r.trade_pnls.begin(), r.trade_pnls.end());
+    }
+    path_sharpe.push_back(sharpe_annualized(pnls));
+  }
+  std::vector<double> oos;
+  for (const Fold& f : folds) oos.push_back(f.oos);
+  std::sort(oos.begin(), oos.end());
+  std::sort(path_sharpe.begin(), path_sharpe.end());
+  double mean = 0.0, var = 0.0;
+  for (double x : oos) mean += x / double(oos.size());
+  for (double x : oos) var += (x - mean) * (x - mean);
+  const double sd = oos.size() > 1 ? std::sqrt(var / double(oos.size() - 1)) : 0.0;
+  const std::size_t positive = static_cast<std::size_t>(
+      std::count_if(path_sharpe.begin(), path_sharpe.end(), [](double x) { return x > 0.0; }));
+
+  std::cout << "\n=== CPCV (groups=" << cv.groups << " test_groups=" << cv.test_groups
+            << " embargo=" << cv.embargo << "d, " << days.size() << " days) ===\n"
+            << "splits=" << splits.size()
+            << " oos_sharpe mean=" << mean << " sd=" << sd
+            << " min/p25/median/p75/max=" << oos.front() << "/" << quantile_sorted(oos, 0.25)
+            << "/" << quantile_sorted(oos, 0.5) << "/" << quantile_sorted(oos, 0.75) << "/" << oos.back() << "\n"
+            << "paths=" << paths.size() << " path_sharpe";
+  for (double x : path_sharpe) std::cout << " " << x;
+  std::cout << " | positive=" << positive << "/" << path_sharpe.size() << "\n"
+            << "pbo=" << 100.0 * double(overfit) / double(splits.size())
+            << "% (in-sample winner at or below the out-of-sample median)\n";
+  return true;
+}
+
+int main(int argc, char** argv) {
+  // --- options: --cache-mb=N (decoded-day budget), --cache-policy=lru|cost ---
+  std::size_t cache_mb = 8192;
+  EvictPolicy policy = EvictPolicy::Lru;
+  bool telemetry = false;
+  // --- search: the fixed grid, or CMA-ES stopped by an evaluation and/or wall-clock budget ---
+  bool cmaes = false;
+  std::size_t max_evals = 300;       // candidate evaluations (each = all training days)
+  double time_budget_s = 0.0;        // 0 = no limit
+  std::size_t min_trades = 30;       // fewer trades on train: Sharpe too noisy to rank (or put on the front)
+  CmaEsOptions co;
+  // --- --cv=cpcv: grid scored by combinatorial purged CV over all of October instead ---
+  bool cv = false;
+  CvOptions cvo;
+  std::string results_path;          // --results=FILE: per-candidate CSV incl. time-of-day / weekday rows
+  std::int64_t bucket_s = 1800;      // --bucket-min: width of the time-of-day split every run carries
+  std::size_t threads = std::thread::hardware_concurrency();
+  bool zone_map = false;             // --zone-map: prune days / idle minutes that cannot signal
+  for (int i = 1; i < argc; ++i) {
+    const std::string a = argv[i];
+    if (a.rfind("--cache-mb=", 0) == 0)        cache_mb = std::stoull(a.substr(11));
+    else if (a == "--cache-policy=cost")       policy = EvictPolicy::CostAware;
+    else if (a == "--cache-policy=lru")        policy = EvictPolicy::Lru;
+    else if (a == "--telemetry")               telemetry = true;
+    else if (a == "--search=grid")             cmaes = false;
+    else if (a == "--search=cmaes")            cmaes = true;
+    else if (a.rfind("--max-evals=", 0) == 0)  max_evals = std::stoull(a.substr(12));
+    else if (a.rfind("--time-budget-s=", 0) == 0) time_budget_s = std::stod(a.substr(16));
+    else if (a.rfind("--popsize=", 0) == 0)    co.popsize = std::stoull(a.substr(10));
+    else if (a.rfind("--sigma0=", 0) == 0)     co.sigma0 = std::stod(a.substr(9));
+    else if (a.rfind("--seed=", 0) == 0)       co.seed = std::stoull(a.substr(7));
+    else if (a.rfind("--min-trades=", 0) == 0) min_trades = std::stoull(a.substr(13));
+    else if (a.rfind("--threads=", 0) == 0)    threads = std::stoull(a.substr(10));
+    else if (a == "--cv=cpcv")                 cv = true;
+    else if (a.rfind("--cv-groups=", 0) == 0)  cvo.groups = std::stoull(a.substr(12));
+    else if (a.rfind("--cv-test-groups=", 0) == 0) cvo.test_groups = std::stoull(a.substr(17));
+    else if (a.rfind("--embargo-days=", 0) == 0)   cvo.embargo = std::stoull(a.substr(15));
+    else if (a.rfind("--results=", 0) == 0)    results_path = a.substr(10);
+    else if (a.rfind("--bucket-min=", 0) == 0) bucket_s = std::stoll(a.substr(13)) * 60;
+    else if (a == "--zone-map")                zone_map = true;
+    else {
+      std::cerr << "Usage: optimize_ofi [--cache-mb=N] [--cache-policy=lru|cost] [--telemetry]\n"
+                   "                    [--search=grid|cmaes] [--max-evals=N] [--time-budget-s=X]\n"
+                   "                    [--popsize=N] [--sigma0=X] [--seed=N] [--min-trades=N] [--threads=N]\n"
+                   "                    [--cv=cpcv] [--cv-groups=N] [--cv-test-groups=K] [--embargo-days=N]\n"
+                   "                    [--results=FILE] [--bucket-min=N] [--zone-map]\n";
+      return 1;
+    }
+  }
+  if (cv && cmaes) { std::cerr << "--cv=cpcv scores the grid; drop --search=cmaes\n"; return 1; }
+  DayCache cache(cache_mb << 20, policy);
+  ThreadPool pool(threads);
+  ResultsStore store;   // train rows per candidate, plus one "validation" row set for the knee
+  if (!results_path.empty() && !store.open(results_path)) {
+    std::cerr << "Cannot open results file: " << results_path << "\n"; return 1;
+  }
+
   // --- small, safe grid (same ballpark as backtest that produced trades) ---
   std::vector<double> grid_ofi  = {5.0, 6.0};         // keep near 5
   std::vector<double> grid_imb  = {0.10, 0.15};       // near 0.15
@@ -141,113 +451,229 @@ int main(int, char**) {
     2'000'000'000LL                                   // 2s
   };
 
-  // product constants (ES)
-  const double TICK_SIZE  = 0.25;
-  const double TICK_VALUE = 12.5;
-
   // TRAIN and VALIDATION ranges
   auto train_days = ymd_range_202310(1, 15);
   auto valid_days = ymd_range_202310(16, 30);
 
-  struct Score { double sharpe; double pnl; size_t trades; ParamCombo pc; };
-  Score best{ -1e9, 0.0, 0, {0,0,0,0} };
-
-  std::cout << std::fixed << std::setprecision(2);
-
+  std::vector<ParamCombo> combos;
   for (double th_ofi : grid_ofi)
   for (double th_imb : grid_imb)
   for (int slip : grid_slip)
-  for (auto hold_ns : grid_hold) {
-    OfiParams P;
-    P.tick_size   = TICK_SIZE;
-    P.tick_value  = TICK_VALUE;
-    P.theta_ofi   = th_ofi;
-    P.theta_imb   = th_imb;
-    P.slip_ticks  = slip;
-    P.max_hold_ns = hold_ns;
-
-    // --- gates/assumptions: EXACT match to working backtest ---
-    P.min_spread_ticks       = 1;
-    P.min_bid_sz             = 2;
-    P.min_ask_sz             = 2;
-    P.persist_updates        = 3;
-    P.min_flip_cooldown_ns   = 120'000'000LL;   // 120ms
-    P.rth_only               = true;
-
-    // Assumptions you used in backtest:
-    P.fill_at_touch_when_spread1 = true;
-    P.trade_confirm_ns           = 0;           // disabled
-
-    RunStats agg{};
-    size_t days_used = 0;
+  for (auto hold_ns : grid_hold)
+    combos.push_back({th_ofi, th_imb, slip, hold_ns});
+
+  std::vector<OfiParams> params;
+  for (const auto& pc : combos) params.push_back(params_for(pc));
+
+  // progress for ofi_monitor: one unit per (candidate, day) run
+  TelemetryPublisher tlm;
+  if (telemetry && !tlm.open("optimize_ofi"))
+    std::cerr << "Telemetry unavailable; continuing without it\n";
+  TelemetryValues tv;
+  tv.total = cv ? combos.size() * (train_days.size() + valid_days.size())
+               : (cmaes ? max_evals : combos.size()) * train_days.size() + valid_days.size();
+  auto progress = [&](const DayData& day, std::size_t runs, const RunStats* rs, std::size_t n) {
+    tv.events += day.events.size() * runs;
+    tv.done   += runs;
+    for (std::size_t k = 0; k < n; ++k) { tv.fills += rs[k].trades(); tv.pnl += rs[k].pnl; }
+    tv.heartbeat_ns = TscClock::now_ns();
+    tlm.publish(tv);
+  };
+
+  ZoneIndex zones;
+  auto run_day = [&](const std::string& ymd, const DayData& day, const OfiParams& P) {
+    if (!zone_map) return run_one_day(day, P, bucket_s);
+    return run_one_day(day, P, bucket_s, zones.get(ymd, day, P).get(), &zones.stats());
+  };
+
+  // Every candidate over the training days. Day-major: each day is run by
+  // all candidates (in parallel on the pool) while it is resident. Totals
+  // are then built in date order (drawdown depends on it) and each finished
+  // candidate goes onto the Pareto front straight from its worker.
+  TrainFront front;
+  std::size_t n_stored = 0;
+  auto train_on = [&](const std::vector<OfiParams>& cands, std::vector<RunStats>& agg) {
+    std::map<std::string, std::vector<RunStats>> by_day;
+    // days whose zone maps (from an earlier pass) rule out every candidate are not even decoded
+    std::vector<std::string> to_run;
     for (const auto& ymd : train_days) {
-      if (!std::filesystem::exists("data/mbp-1/glbx-mdp3-" + ymd + ".mbp-1.dbn.zst"))
-        continue;
-      RunStats rs = run_one_day(ymd, P);
-      agg.pnl += rs.pnl;
-      agg.trade_pnls.insert(agg.trade_pnls.end(), rs.trade_pnls.begin(), rs.trade_pnls.end());
-      ++days_used;
+      if (zone_map && zones.prunable(ymd, cands)) {
+        by_day.emplace(ymd, std::vector<RunStats>(cands.size(), RunStats(bucket_s)));
+        ++zones.stats().days_not_loaded;
+        tv.done += cands.size();
+      } else {
+        to_run.push_back(ymd);
+      }
     }
-    if (days_used == 0) continue;
+    const size_t pruned = by_day.size();
+    const size_t used = pruned + for_each_day(cache, to_run,
+        [&](const std::string& ymd, const DayData& day) {
+          std::vector<RunStats> per(cands.size(), RunStats(bucket_s));
+          pool.parallel_for(cands.size(), [&](std::size_t c) { per[c] = run_day(ymd, day, cands[c]); });
+          progress(day, cands.size(), per.data(), per.size());
+          by_day.emplace(ymd, std::move(per));
+        });
+    agg.assign(cands.size(), RunStats(bucket_s));
+    pool.parallel_for(cands.size(), [&](std::size_t c) {
+      RunStats& a = agg[c];
+      for (const auto& [ymd, per] : by_day) add_day(a, per[c]);
+      if (a.trades() < min_trades) return;
+      front.insert(objectives_of(a), {cands[c], a.pnl, a.sharpe(), a.max_drawdown(), a.turnover(), a.trades(), a.tod, a.ctr});
+    });
+    for (size_t c = 0; c < cands.size(); ++c) store.add_all(cmaes ? "cmaes" : "grid", n_stored++, cands[c], agg[c].tod);
+    return used;
+  };
 
-    double s = agg.sharpe();
-    if (s > best.sharpe) {
-      best = { s, agg.pnl, agg.trades(), {th_ofi, th_imb, slip, hold_ns} };
+  if (cv) {
+    // each (combo, day) is simulated once; the folds only re-aggregate
+    auto all_days = train_days;
+    all_days.insert(all_days.end(), valid_days.begin(), valid_days.end());
+    std::map<std::string, std::vector<RunStats>> by_day;   // date order, whatever order the cache ran them in
+    for_each_day(cache, all_days, [&](const std::string& ymd, const DayData& day) {
+      std::vector<RunStats> per(params.size(), RunStats(bucket_s));
+      pool.parallel_for(params.size(), [&](std::size_t c) { per[c] = run_day(ymd, day, params[c]); });
+      progress(day, per.size(), per.data(), per.size());
+      by_day.emplace(ymd, std::move(per));
+    });
+    tv.done = tv.total;
+    tlm.publish(tv);
+    if (by_day.empty()) {
+      std::cerr << "No days found on disk for October.\n";
+      return 1;
     }
+    std::vector<std::string> days;
+    std::vector<std::vector<RunStats>> res;
+    for (auto& [ymd, per] : by_day) { days.push_back(ymd); res.push_back(std::move(per)); }
+    std::cout << std::fixed << std::setprecision(2);
+    return report_cpcv(res, days, combos, cvo, pool) ? 0 : 1;
+  }
 
-    std::cout << "[TRAIN] ofi=" << th_ofi
-              << " imb=" << th_imb
-              << " slip=" << slip
-              << " hold=" << (hold_ns/1e9) << "s"
-              << " | trades=" << agg.trades()
-              << " pnl=$" << agg.pnl
-              << " sharpe=" << s
-              << "\n";
+  size_t days_used = 0;
+  std::size_t evaluated = 0;
+  const std::int64_t t_start = TscClock::now_ns();
+
+  std::cout << std::fixed << std::setprecision(2);
+
+  if (!cmaes) {
+    std::vector<RunStats> train;
+    days_used = train_on(params, train);
+    evaluated = combos.size();
+
+    for (size_t c = 0; c < combos.size() && days_used > 0; ++c) {
+      const auto& pc = combos[c];
+      const RunStats& agg = train[c];
+
+      const double s = agg.sharpe();
+      std::cout << "[TRAIN] ofi=" << pc.theta_ofi
+                << " imb=" << pc.theta_imb
+                << " slip=" << pc.slip_ticks
+                << " hold=" << (pc.max_hold_ns/1e9) << "s"
+                << " | trades=" << agg.trades()
+                << " pnl=$" << agg.pnl
+                << " sharpe=" << s
+                << " max_dd=$" << agg.max_drawdown()
+                << " turnover=" << agg.turnover() << "/day"
+                << "\n";
+      print_funnel(std::cout, agg.ctr, "  ");
+    }
+  } else {
+    // CMA-ES from the grid's centre; minimizes -Sharpe, with too-few-trade
+    // candidates ranked below every scored one (more trades first)
+    CmaEs es(unit_from_params(params_for({5.0, 0.15, 1, 2'000'000'000LL})), co);
+    if (max_evals < es.popsize()) {
+      std::cerr << "--max-evals=" << max_evals << " is below the population size (" << es.popsize()
+                << "): not even one generation fits. Raise it or lower --popsize.\n";
+      return 1;
+    }
+    std::cout << "[cmaes] dims=" << kSearchN << " popsize=" << es.popsize()
+              << " max_evals=" << max_evals << " time_budget_s=" << time_budget_s
+              << " threads=" << pool.size() << "\n";
+    struct Score { double sharpe; double pnl; size_t trades; OfiParams P; };
+    Score best{ -1e9, 0.0, 0, {} };   // progress only; the front is the result
+    const char* stop = "max-evals";
+    while (evaluated + es.popsize() <= max_evals) {
+      const auto& xs = es.ask();
+      std::vector<OfiParams> cands;
+      for (const auto& x : xs) cands.push_back(params_from_unit(x));
+      std::vector<RunStats> train;
+      days_used = train_on(cands, train);
+      if (days_used == 0) break;
+      evaluated += cands.size();
+
+      std::vector<double> f(cands.size());
+      for (size_t c = 0; c < cands.size(); ++c) {
+        const RunStats& agg = train[c];
+        const double s = agg.sharpe();
+        f[c] = agg.trades() >= min_trades ? -s : 1e6 - double(agg.trades());
+        if (agg.trades() >= min_trades && s > best.sharpe) best = { s, agg.pnl, agg.trades(), cands[c] };
+      }
+      es.tell(f);
+
+      std::cout << "[cmaes] gen=" << es.generation() << " evals=" << evaluated
+                << " gen_best=" << -*std::min_element(f.begin(), f.end())
+                << " best_sharpe=" << best.sharpe
+                << " step=" << std::setprecision(4) << es.step() << std::setprecision(2) << " | ";
+      print_params(std::cout, best.P);
+      std::cout << "\n";
+
+      if (es.converged()) { stop = "converged"; break; }
+      if (time_budget_s > 0.0 && (TscClock::now_ns() - t_start) / 1e9 >= time_budget_s) {
+        stop = "time-budget"; break;
+      }
+    }
+    std::cout << "[cmaes] stop=" << stop << " generations=" << es.generation() << "\n";
   }
 
-  if (best.sharpe <= -1e8) {
+  tv.done = tv.total - valid_days.size();   // days missing on disk / unused budget count as done
+
+  if (days_used == 0) {
     std::cerr << "No training days found on disk. Make sure Oct 1–15 files exist.\n";
     return 1;
   }
+  const auto knee = front.knee();
+  if (!knee) {
+    std::cerr << "No candidate reached --min-trades=" << min_trades << " on train.\n";
+    return 1;
+  }
 
-  std::cout << "\n=== BEST ON TRAIN ===\n"
-            << "ofi=" << best.pc.theta_ofi
-            << " imb=" << best.pc.theta_imb
-            << " slip=" << best.pc.slip_ticks
-            << " hold=" << (best.pc.max_hold_ns/1e9) << "s"
-            << " | trades=" << best.trades
-            << " pnl=$" << best.pnl
-            << " sharpe=" << best.sharpe
+  // the front, best PnL first; the knee is what gets validated
+  const auto points = front.snapshot();
+  std::cout << "\n=== PARETO FRONT ON TRAIN (pnl, sharpe, -max_dd, -turnover) ===\n";
+  for (const auto& e : points) {
+    std::cout << (e.f == knee->f ? "* " : "  ");
+    print_point(std::cout, e.p);
+    std::cout << "\n";
+  }
+  std::cout << "front=" << points.size()
+            << " inserted=" << front.inserted()
+            << " dominated_on_arrival=" << front.rejected()
+            << " evicted=" << front.evicted() << "\n";
+  std::cout << "\n=== KNEE ===\n";
+  print_point(std::cout, knee->p);
+  std::cout << "\n";
+  print_buckets(std::cout, knee->p.tod);
+  print_funnel(std::cout, knee->p.ctr);
+  if (store.is_open()) std::cout << "[results] " << results_path << " rows=" << store.rows() << "\n";
+  std::cout
+            << "[search] " << (cmaes ? "cmaes" : "grid")
+            << " evaluations=" << evaluated
+            << " backtests=" << evaluated * days_used
+            << " wall=" << (TscClock::now_ns() - t_start) / 1e9 << "s"
             << "\n\n";
 
   // --- VALIDATION ---
-  OfiParams Pbest;
-  Pbest.tick_size   = TICK_SIZE;
-  Pbest.tick_value  = TICK_VALUE;
-  Pbest.theta_ofi   = best.pc.theta_ofi;
-  Pbest.theta_imb   = best.pc.theta_imb;
-  Pbest.slip_ticks  = best.pc.slip_ticks;
-  Pbest.max_hold_ns = best.pc.max_hold_ns;
-
-  Pbest.min_spread_ticks       = 1;
-  Pbest.min_bid_sz             = 2;
-  Pbest.min_ask_sz             = 2;
-  Pbest.persist_updates        = 3;
-  Pbest.min_flip_cooldown_ns   = 120'000'000LL;
-  Pbest.rth_only               = true;
-  Pbest.fill_at_touch_when_spread1 = true;
-  Pbest.trade_confirm_ns           = 0;
-
-  RunStats vagg{};
-  size_t vdays_used = 0;
-  for (const auto& ymd : valid_days) {
-    if (!std::filesystem::exists("data/mbp-1/glbx-mdp3-" + ymd + ".mbp-1.dbn.zst"))
-      continue;
-    RunStats rs = run_one_day(ymd, Pbest);
-    vagg.pnl += rs.pnl;
-    vagg.trade_pnls.insert(vagg.trade_pnls.end(), rs.trade_pnls.begin(), rs.trade_pnls.end());
-    ++vdays_used;
-  }
+  const OfiParams Pbest = knee->p.P;
+
+  RunStats vagg(bucket_s);
+  const size_t vdays_used = for_each_day(cache, valid_days,
+      [&](const std::string& ymd, const DayData& day) {
+        const RunStats rs = run_day(ymd, day, Pbest);
+        add_day(vagg, rs);
+        progress(day, 1, &rs, 1);
+      });
+  tv.done = tv.total;
+  tv.heartbeat_ns = TscClock::now_ns();
+  tlm.publish(tv);
 
   std::cout << "=== VALIDATION (Oct 16–30) ===\n"
             << "days=" << vdays_used
@@ -256,6 +682,32 @@ int main(int, char**) {
             << " sharpe=" << vagg.sharpe()
             << " win%=" << vagg.winrate()
             << "\n";
+  print_buckets(std::cout, vagg.tod);
+  print_funnel(std::cout, vagg.ctr);
+  store.add_all("validation", 0, Pbest, vagg.tod);
+
+  const DayCacheStats cs = cache.stats();
+  std::cout << "[cache] budget=" << (cache.budget_bytes() >> 20) << "MB"
+            << " policy=" << (policy == EvictPolicy::Lru ? "lru" : "cost")
+            << " hits=" << cs.hits
+            << " misses=" << cs.misses
+            << " hit%=" << 100.0 * cs.hit_rate()
+            << " evictions=" << cs.evictions
+            << " decoded=" << (cs.bytes_decoded >> 20) << "MB"
+            << " decode=" << cs.decode_ns / 1e9 << "s"
+            << " peak=" << (cs.peak_bytes >> 20) << "MB"
+            << "\n";
+  print_load_counters(std::cout, CounterRegistry::total());
+  if (zone_map) {
+    ZoneStats& zs = zones.stats();
+    std::cout << "[zone] maps=" << zs.maps_built.load()
+              << " build=" << zs.build_ns.load() / 1e9 << "s"
+              << " day_runs=" << zs.day_runs.load()
+              << " pruned=" << zs.days_pruned.load()
+              << " not_loaded=" << zs.days_not_loaded.load()
+              << " minutes_skipped=" << zs.minutes_skipped.load() << "/" << zs.minutes.load()
+              << "\n";
+  }
 
   return 0;
 }
@@ -0,0 +1,141 @@
+#include "order/Gateway.hpp"
+#include "common/Clock.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+std::size_t GatewaySim::handle(const std::uint8_t* in, std::size_t len, std::uint8_t* out,
+                               std::int64_t now_ns) {
+  SbeHeader h;
+  if (!sbe_peek_header(in, len, h)) return 0;
+
+  ExecReportEncoder er(out);
+  er.exec_id(next_exec_id++).transact_ts(now_ns);
+  switch (h.template_id) {
+    case NewOrderLayout::kTemplateId: {
+      const NewOrderDecoder m(in);
+      const bool market = m.ord_type() == OrdType::Market;
+      er.cl_ord_id(m.cl_ord_id()).price(m.price()).side(m.side())
+        .qty(market ? m.qty() : 0).leaves_qty(market ? 0 : m.qty())
+        .exec_type(market ? ExecType::Trade : ExecType::New);
+      break;
+    }
+    case CancelLayout::kTemplateId: {
+      const CancelDecoder m(in);
+      er.cl_ord_id(m.cl_ord_id()).price(0).side(m.side()).qty(0).leaves_qty(0)
+        .exec_type(ExecType::Canceled);
+      break;
+    }
+    case ReplaceLayout::kTemplateId: {
+      const ReplaceDecoder m(in);
+      er.cl_ord_id(m.cl_ord_id()).price(m.price()).side(m.side()).qty(0).leaves_qty(m.qty())
+        .exec_type(ExecType::Replaced);
+      break;
+    }
+    default:
+      return 0;
+  }
+  return er.size();
+}
+
+bool LoopbackTransport::send(const std::uint8_t* buf, std::size_t len) {
+  SbeFrame f;
+  f.len = static_cast<std::uint8_t>(gw.handle(buf, len, f.data, TscClock::now_ns()));
+  return f.len == 0 || acks.try_push(f);
+}
+
+std::size_t LoopbackTransport::recv(std::uint8_t* buf, std::size_t cap) {
+  SbeFrame f;
+  if (!acks.try_pop(f)) return 0;
+  const std::size_t n = std::min<std::size_t>(f.len, cap);
+  std::memcpy(buf, f.data, n);
+  return n;
+}
+
+static bool fill_addr(const std::string& path, sockaddr_un& addr) {
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(addr.sun_path)) return false;
+  std::memcpy(addr.sun_path, path.c_str(), path.size());
+  return true;
+}
+
+bool UnixSocketTransport::connect(const std::string& path) {
+  close();
+  sockaddr_un addr;
+  if (!fill_addr(path, addr)) return false;
+  fd = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK, 0);
+  if (fd < 0) return false;
+  if (::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+    close();
+    return false;
+  }
+  return true;
+}
+
+void UnixSocketTransport::close() {
+  if (fd >= 0) ::close(fd);
+  fd = -1;
+}
+
+bool UnixSocketTransport::send(const std::uint8_t* buf, std::size_t len) {
+  return fd >= 0 && ::send(fd, buf, len, MSG_DONTWAIT | MSG_NOSIGNAL) == static_cast<ssize_t>(len);
+}
+
+std::size_t UnixSocketTransport::recv(std::uint8_t* buf, std::size_t cap) {
+  if (fd < 0) return 0;
+  const ssize_t n = ::recv(fd, buf, cap, MSG_DONTWAIT);
+  return n > 0 ? static_cast<std::size_t>(n) : 0;
+}
+
+bool UnixGatewayServer::start(const std::string& p) {
+  stop();
+  sockaddr_un addr;
+  if (!fill_addr(p, addr)) return false;
+  listen_fd = ::socket(AF_UNIX, SOCK_SEQPACKET, 0);
+  if (listen_fd < 0) return false;
+  ::unlink(p.c_str());
+  if (::bind(listen_fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0 ||
+      ::listen(listen_fd, 4) != 0) {
+    ::close(listen_fd);
+    listen_fd = -1;
+    return false;
+  }
+  path = p;
+  running.store(true, std::memory_order_release);
+  th = std::thread([this] { serve(); });
+  return true;
+}
+
+void UnixGatewayServer::stop() {
+  if (!running.exchange(false)) return;
+  if (th.joinable()) th.join();
+  ::close(listen_fd);
+  listen_fd = -1;
+  ::unlink(path.c_str());
+}
+
+// one client at a time; polls with a short timeout so stop() is prompt
+void UnixGatewayServer::serve() {
+  GatewaySim gw;
+  std::uint8_t in[kSbeMaxFrame], out[kSbeMaxFrame];
+  int client = -1;
+  while (running.load(std::memory_order_acquire)) {
+    pollfd pfd{client >= 0 ? client : listen_fd, POLLIN, 0};
+    if (::poll(&pfd, 1, 50) <= 0) continue;
+    if (client < 0) {
+      client = ::accept(listen_fd, nullptr, nullptr);
+      continue;
+    }
+    const ssize_t n = ::recv(client, in, sizeof(in), 0);
+    if (n <= 0) { ::close(client); client = -1; continue; }
+    const std::size_t len = gw.handle(in, static_cast<std::size_t>(n), out, TscClock::now_ns());
+    if (len) ::send(client, out, len, MSG_NOSIGNAL);
+  }
+  if (client >= 0) ::close(client);
+}
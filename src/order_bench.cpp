@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+#include "common/Clock.hpp"
+#include "common/HdrHistogram.hpp"
+#include "order/Gateway.hpp"
+#include "order/OrderEntry.hpp"
+#include "order/Sbe.hpp"
+
+// Cost of turning a decision into bytes on the wire. Three cases, each
+// timed per order with the TSC: encode only (into the session buffer, no
+// transport), encode + send over the in-process loopback (gateway runs
+// inline), and encode + send over a Unix SOCK_SEQPACKET socket to a
+// gateway thread. Acks are drained outside the timed section. Orders
+// alternate new/replace/cancel so every encoder is exercised.
+
+// Transport that accepts and drops every frame: isolates the encoder.
+struct NullTransport {
+  std::uint64_t bytes = 0;
+  bool send(const std::uint8_t*, std::size_t len) { bytes += len; return true; }
+  std::size_t recv(std::uint8_t*, std::size_t) { return 0; }
+};
+
+struct BenchResult {
+  HdrHistogram h{};
+  std::uint64_t failed = 0;
+  std::uint64_t acks = 0;
+  double batch_mean_ns = 0.0;   // untimed pass: one TSC pair per drain_every orders
+};
+
+// new/replace/cancel in rotation; returns the cl_ord_id (0 if not sent)
+template <class Transport>
+static std::uint64_t send_one(OrderEntry<Transport>& oe, std::uint64_t i, std::uint64_t last) {
+  const double px = 4300.0 + 0.25 * double(i & 15);
+  switch (i % 3) {
+    case 0:  return oe.new_order(i & 1 ? OrdSide::Buy : OrdSide::Sell, 1, px, OrdType::Limit, TsNanos(i));
+    case 1:  return oe.replace(last, OrdSide::Buy, 2, px, TsNanos(i));
+    default: return oe.cancel(last, OrdSide::Buy, TsNanos(i));
+  }
+}
+
+// With acks expected, drain() waits for every outstanding one, so the
+// gateway (a separate thread for the socket case) is caught up before the
+// next timed batch and the socket buffer never fills.
+template <class Transport>
+static BenchResult run_case(Transport& t, std::uint64_t orders, std::uint64_t drain_every, bool acks) {
+  BenchResult r;
+  OrderEntry<Transport> oe(t, 314863);
+  const double ns_per_tick = TscClock::ns_per_tick();
+  const auto drain = [&] {
+    for (;;) {
+      while (oe.poll([](const ExecReportDecoder&) {}) != 0) {}
+      if (!acks || oe.stats().acks >= oe.stats().sent) break;
+      std::this_thread::yield();
+    }
+  };
+
+  // per-order latency
+  std::uint64_t last = 0;
+  for (std::uint64_t i = 0; i < orders; ++i) {
+    const std::uint64_t t0 = TscClock::ticks();
+    const std::uint64_t id = send_one(oe, i, last);
+    const std::uint64_t t1 = TscClock::ticks();
+    r.h.record(static_cast<std::int64_t>(double(t1 - t0) * ns_per_tick));
+    if (id) last = id;
+    if ((i + 1) % drain_every == 0) drain();
+  }
+  drain();
+
+  // throughput: timer reads amortized over each batch
+  std::uint64_t batch_ticks = 0;
+  for (std::uint64_t i = 0; i < orders;) {
+    const std::uint64_t n = std::min(drain_every, orders - i);
+    const std::uint64_t t0 = TscClock::ticks();
+    for (std::uint64_t k = 0; k < n; ++k, ++i) {
+      const std::uint64_t id = send_one(oe, i, last);
+      if (id) last = id;
+    }
+    batch_ticks += TscClock::ticks() - t0;
+    drain();
+  }
+  r.batch_mean_ns = double(batch_ticks) * ns_per_tick / double(orders);
+  r.failed = oe.stats().send_failed;
+  r.acks = oe.stats().acks;
+  return r;
+}
+
+static void print(const char* name, const BenchResult& r, double target_ns) {
+  std::cout << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(0)
+            << std::setw(8)  << double(r.h.percentile(50))
+            << std::setw(8)  << double(r.h.percentile(99))
+            << std::setw(9)  << double(r.h.percentile(99.9))
+            << std::setw(10) << double(r.h.max())
+            << std::setprecision(1) << std::setw(9) << r.h.mean()
+            << std::setw(9) << r.batch_mean_ns
+            << std::setw(8) << r.failed << std::setw(10) << r.acks
+            << (double(r.h.percentile(99)) < target_ns ? "  ok" : "  over") << "\n";
+}
+
+int main(int argc, char** argv) {
+  std::uint64_t orders = 1'000'000;
+  std::uint64_t drain_every = 64;
+  double target_ns = 1000.0;
+  bool unix_sock = true;
+  std::string sock_path = "/tmp/ofi_gateway_" + std::to_string(::getpid()) + ".sock";
+  for (int i = 1; i < argc; ++i) {
+    const std::string a = argv[i];
+    if      (a.rfind("--orders=", 0) == 0)      orders = std::stoull(a.substr(9));
+    else if (a.rfind("--drain-every=", 0) == 0) drain_every = std::stoull(a.substr(14));
+    else if (a.rfind("--target-ns=", 0) == 0)   target_ns = std::stod(a.substr(12));
+    else if (a.rfind("--socket=", 0) == 0)      sock_path = a.substr(9);
+    else if (a == "--no-unix")                  unix_sock = false;
+    else {
+      std::cerr << "Usage: order_bench [--orders=N] [--drain-every=N] [--target-ns=X]\n"
+                   "                   [--socket=PATH] [--no-unix]\n";
+      return 1;
+    }
+  }
+  if (orders == 0 || drain_every == 0) { std::cerr << "--orders and --drain-every must be > 0\n"; return 1; }
+
+  std::cout << "[bench] orders=" << orders << " frame_bytes new/replace/cancel="
+            << NewOrderLayout::kFrameLen << "/" << ReplaceLayout::kFrameLen << "/" << CancelLayout::kFrameLen
+            << " target_p99_ns=" << target_ns << "\n";
+  std::cout << std::left << std::setw(16) << "case" << std::right
+            << std::setw(8) << "p50" << std::setw(8) << "p99" << std::setw(9) << "p99.9"
+            << std::setw(10) << "max" << std::setw(9) << "mean" << std::setw(9) << "batch"
+            << std::setw(8) << "failed" << std::setw(10) << "acks" << "   (ns)\n";
+
+  {
+    NullTransport t;
+    print("encode", run_case(t, orders, drain_every, false), target_ns);
+  }
+  {
+    LoopbackTransport t(2 * drain_every);
+    print("loopback", run_case(t, orders, drain_every, true), target_ns);
+  }
+  if (unix_sock) {
+    UnixGatewayServer gw;
+    if (!gw.start(sock_path)) { std::cerr << "Cannot listen on " << sock_path << "\n"; return 1; }
+    UnixSocketTransport t;
+    if (!t.connect(sock_path)) { std::cerr << "Cannot connect to " << sock_path << "\n"; return 1; }
+    print("unix-socket", run_case(t, orders, drain_every, true), target_ns);
+  }
+  return 0;
+}
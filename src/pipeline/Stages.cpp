@@ -0,0 +1,59 @@
+#include "pipeline/Stages.hpp"
+#include "data/DbnStream.hpp"
+#include "data/TradeSign.hpp"
+
+#include <algorithm>
+
+Generator<DayEvents> decode_stage(std::string path,
+                                  std::string schema_name,
+                                  std::optional<std::uint32_t> instrument_filter,
+                                  bool rth_only,
+                                  std::size_t chunk) {
+  if (path.empty()) co_return;
+  DbnChunkReader reader(path, schema_name, instrument_filter, rth_only);
+  DayEvents buf;
+  buf.quotes.reserve(schema_name == "mbp-1" ? chunk : 0);
+  buf.trades.reserve(schema_name == "trades" ? chunk : 0);
+  while (reader.next(buf, chunk)) co_yield buf;
+}
+
+Generator<EventChunk> merge_stage(Generator<DayEvents> quotes,
+                                  Generator<DayEvents> trades,
+                                  std::size_t chunk) {
+  const DayEvents* qc = quotes.next();
+  const DayEvents* tc = trades.next();
+  std::size_t i = 0, j = 0;
+
+  EventChunk out;
+  out.reserve(chunk);
+  TradeSignClassifier sides;   // Unknown prints signed as they merge
+  constexpr std::int64_t kDayNs = 86'400'000'000'000LL;
+  std::int64_t day = -1;        // UTC day of the last event; day files split there
+  for (;;) {
+    if (qc && i == qc->quotes.size()) { qc = quotes.next(); i = 0; continue; }
+    if (tc && j == tc->trades.size()) { tc = trades.next(); j = 0; continue; }
+    if (!qc && !tc) break;
+
+    const bool take_q = !tc || (qc && qc->quotes[i].ts <= tc->trades[j].ts);
+    const std::int64_t ts = take_q ? qc->quotes[i].ts : tc->trades[j].ts;
+    if (ts / kDayNs != day) { sides.reset(); day = ts / kDayNs; }
+    Event e;
+    if (take_q) { e.type = EvType::Quote; e.ts = qc->quotes[i].ts; e.q = qc->quotes[i]; sides.on_quote(e.q); ++i; }
+    else        { e.type = EvType::Trade; e.ts = tc->trades[j].ts; e.t = tc->trades[j]; sides.classify(e.t); ++j; }
+    out.push_back(e);
+
+    if (out.size() == chunk) { sides.flush_counters(); co_yield out; out.clear(); }
+  }
+  sides.flush_counters();
+  if (!out.empty()) co_yield out;
+}
+
+Generator<EventChunk> day_stage(const std::string& mbp_path,
+                                const std::string& trd_path,
+                                std::optional<std::uint32_t> instrument_filter,
+                                bool rth_only,
+                                std::size_t chunk) {
+  return merge_stage(decode_stage(mbp_path, "mbp-1", instrument_filter, rth_only, chunk),
+                     decode_stage(trd_path, "trades", instrument_filter, rth_only, chunk),
+                     chunk);
+}
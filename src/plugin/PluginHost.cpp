@@ -0,0 +1,121 @@
+#include "plugin/PluginHost.hpp"
+#include "common/Clock.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <dlfcn.h>
+#include <limits>
+
+// batches are handed over in place: Event must match OfiEvent field for field
+static_assert(sizeof(Event) == sizeof(OfiEvent));
+static_assert(offsetof(Event, ts) == offsetof(OfiEvent, ts));
+static_assert(offsetof(Event, q) == offsetof(OfiEvent, q));
+static_assert(offsetof(Event, t) == offsetof(OfiEvent, t));
+static_assert(sizeof(QuoteL1) == sizeof(OfiQuote) && offsetof(QuoteL1, ask_sz) == offsetof(OfiQuote, ask_sz));
+static_assert(sizeof(Trade) == sizeof(OfiTrade) && offsetof(Trade, side) == offsetof(OfiTrade, aggressor));
+static_assert(int(EvType::Trade) == OFI_EV_TRADE && int(Aggressor::Sell) == OFI_AGG_SELL);
+
+std::unique_ptr<StrategyPlugin> StrategyPlugin::open(const std::string& spec, std::string& err) {
+  const auto colon = spec.find(':');
+  const std::string path   = spec.substr(0, colon);
+  const std::string config = colon == std::string::npos ? "" : spec.substr(colon + 1);
+
+  std::unique_ptr<StrategyPlugin> p(new StrategyPlugin());
+  p->so_path = path;
+  // RTLD_LOCAL: each plugin keeps its own copy of whatever it links in
+  p->dl = ::dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+  if (!p->dl) { err = ::dlerror(); return nullptr; }
+  const auto entry = reinterpret_cast<OfiStrategyEntryFn>(::dlsym(p->dl, "ofi_strategy_entry"));
+  if (!entry) { err = path + ": no ofi_strategy_entry"; return nullptr; }
+  p->api = entry();
+  if (!p->api || p->api->abi_version != OFI_STRATEGY_ABI_VERSION) {
+    err = path + ": ABI version mismatch";
+    return nullptr;
+  }
+  if (!p->api->init || !p->api->on_event_batch || !p->api->finish) {
+    err = path + ": incomplete OfiStrategyApi";
+    return nullptr;
+  }
+  p->plugin_name = p->api->name ? p->api->name : path;
+  p->host = OfiHost{p.get(), &StrategyPlugin::report_fill, &StrategyPlugin::schedule};
+  p->self = p->api->init(&p->host, config.c_str());
+  if (!p->self) { err = path + ": init failed (config '" + config + "')"; return nullptr; }
+  return p;
+}
+
+StrategyPlugin::~StrategyPlugin() {
+  if (self) api->finish(self, 0);
+  if (dl) ::dlclose(dl);
+}
+
+void StrategyPlugin::report_fill(void* ctx, std::int64_t, double pnl) {
+  PluginStats& s = static_cast<StrategyPlugin*>(ctx)->st;
+  ++s.fills;
+  if (pnl > 0.0) ++s.wins;
+  s.pnl += pnl;
+}
+
+void StrategyPlugin::schedule(void* ctx, std::int64_t deadline_ns, std::uint64_t cookie) {
+  static_cast<StrategyPlugin*>(ctx)->timers.emplace(deadline_ns, cookie);
+}
+
+void StrategyPlugin::on_batch(std::span<const Event> ev) {
+  if (!self || ev.empty()) return;
+  const std::uint64_t t0 = TscClock::ticks();
+  api->on_event_batch(self, reinterpret_cast<const OfiEvent*>(ev.data()), ev.size());
+  st.busy_ns += TscClock::to_ns(TscClock::ticks()) - TscClock::to_ns(t0);
+  st.events += ev.size();
+  ++st.batches;
+}
+
+void StrategyPlugin::fire_timers(TsNanos now) {
+  if (!self || !api->on_timer) return;
+  while (!timers.empty() && timers.top().first <= now) {
+    const Timer t = timers.top();
+    timers.pop();   // before the call: on_timer may schedule more
+    const std::uint64_t t0 = TscClock::ticks();
+    api->on_timer(self, t.first, t.second);
+    st.busy_ns += TscClock::to_ns(TscClock::ticks()) - TscClock::to_ns(t0);
+    ++st.timers;
+  }
+}
+
+void StrategyPlugin::finish(TsNanos now) {
+  if (!self) return;
+  fire_timers(now);
+  api->finish(self, now);
+  self = nullptr;
+}
+
+TsNanos StrategyPlugin::next_deadline() const {
+  return timers.empty() || !self ? std::numeric_limits<TsNanos>::max() : timers.top().first;
+}
+
+bool PluginHost::load(const std::string& spec, std::string& err) {
+  auto p = StrategyPlugin::open(spec, err);
+  if (!p) return false;
+  loaded.push_back(std::move(p));
+  return true;
+}
+
+void PluginHost::run(std::span<const Event> ev, std::size_t batch) {
+  batch = std::max<std::size_t>(batch, 1);
+  std::size_t i = 0;
+  while (i < ev.size()) {
+    TsNanos next = std::numeric_limits<TsNanos>::max();
+    for (auto& p : loaded) {
+      p->fire_timers(ev[i].ts);
+      next = std::min(next, p->next_deadline());
+    }
+    std::size_t end = std::min(ev.size(), i + batch);
+    for (std::size_t j = i + 1; j < end; ++j)
+      if (ev[j].ts >= next) { end = j; break; }
+    const auto chunk = ev.subspan(i, end - i);
+    for (auto& p : loaded) p->on_batch(chunk);
+    i = end;
+  }
+}
+
+void PluginHost::finish(TsNanos now) {
+  for (auto& p : loaded) p->finish(now);
+}
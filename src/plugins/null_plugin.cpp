@@ -0,0 +1,31 @@
+// Baseline plugin: touches every event and does nothing else, so its
+// ns/event is the host's per-plugin dispatch cost.
+#include <cstdint>
+#include <new>
+
+#include "plugin/StrategyAbi.h"
+
+namespace {
+
+struct NullPlugin {
+  std::uint64_t quotes = 0, trades = 0;
+};
+
+void* null_init(const OfiHost*, const char*) { return new (std::nothrow) NullPlugin(); }
+
+void null_on_event_batch(void* self, const OfiEvent* ev, std::size_t n) {
+  NullPlugin& p = *static_cast<NullPlugin*>(self);
+  for (std::size_t i = 0; i < n; ++i) {
+    if (ev[i].type == OFI_EV_QUOTE) ++p.quotes;
+    else ++p.trades;
+  }
+}
+
+void null_finish(void* self, std::int64_t) { delete static_cast<NullPlugin*>(self); }
+
+const OfiStrategyApi kApi{OFI_STRATEGY_ABI_VERSION, "null", &null_init, &null_on_event_batch, nullptr,
+                          &null_finish};
+
+}  // namespace
+
+extern "C" const OfiStrategyApi* ofi_strategy_entry(void) { return &kApi; }
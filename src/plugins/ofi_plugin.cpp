@@ -0,0 +1,114 @@
+// QueueOfiStrategy as a strategy plugin: the same per-event loop as
+// backtest_ofi behind the C ABI. Config is comma-separated key=value:
+// theta_ofi, theta_imb, hold_ms, cooldown_ms, persist, lots, min_bid_sz,
+// min_ask_sz, rth_only (0/1).
+#include <cstdlib>
+#include <new>
+#include <string>
+
+#include "plugin/StrategyAbi.h"
+#include "strategy/QueueOfi.hpp"
+
+namespace {
+
+struct OfiPlugin {
+  OfiHost host;
+  QueueOfiStrategy strat;
+  TsNanos watched_entry = -1;
+
+  OfiPlugin(const OfiHost& h, const OfiParams& p) : host(h), strat(p) {}
+
+  void realize(TsNanos ts, double pnl) {
+    if (pnl != 0.0) host.report_fill(host.ctx, ts, pnl);
+  }
+
+  // hold exits must fire on time even if the feed goes quiet: ask the host
+  void watch_position() {
+    const Position& p = strat.pos();
+    if (p.side == 0 || p.entry_ts == watched_entry) return;
+    host.schedule(host.ctx, p.entry_ts + strat.params().max_hold_ns + 1, 0);
+    watched_entry = p.entry_ts;
+  }
+};
+
+bool parse_config(const char* cfg, OfiParams& P) {
+  std::string s = cfg ? cfg : "";
+  std::size_t pos = 0;
+  while (pos < s.size()) {
+    std::size_t end = s.find(',', pos);
+    if (end == std::string::npos) end = s.size();
+    const std::string kv = s.substr(pos, end - pos);
+    pos = end + 1;
+    if (kv.empty()) continue;
+    const auto eq = kv.find('=');
+    if (eq == std::string::npos) return false;
+    const std::string k = kv.substr(0, eq);
+    // the whole value must be a number: "abc" or "5x" fail init instead of reading as 0 / 5
+    const char* val = kv.c_str() + eq + 1;
+    char* val_end = nullptr;
+    const double v = std::strtod(val, &val_end);
+    if (val_end == val || *val_end != '\0') return false;
+    if (k == "theta_ofi")        P.theta_ofi = v;
+    else if (k == "theta_imb")   P.theta_imb = v;
+    else if (k == "hold_ms")     P.max_hold_ns = static_cast<std::int64_t>(v * 1e6);
+    else if (k == "cooldown_ms") P.min_flip_cooldown_ns = static_cast<std::int64_t>(v * 1e6);
+    else if (k == "persist")     P.persist_updates = static_cast<int>(v);
+    else if (k == "lots")        P.lots = static_cast<QtyI>(v);
+    else if (k == "min_bid_sz")  P.min_bid_sz = static_cast<QtyI>(v);
+    else if (k == "min_ask_sz")  P.min_ask_sz = static_cast<QtyI>(v);
+    else if (k == "rth_only")    P.rth_only = v != 0.0;
+    else return false;
+  }
+  return true;
+}
+
+void* ofi_init(const OfiHost* host, const char* config) {
+  // backtest_ofi defaults
+  OfiParams P;
+  P.theta_ofi = 5.0;
+  P.theta_imb = 0.15;
+  P.persist_updates = 3;
+  P.min_flip_cooldown_ns = 120'000'000LL;
+  P.trade_confirm_ns = 0;
+  if (!host || !parse_config(config, P)) return nullptr;
+  return new (std::nothrow) OfiPlugin(*host, P);
+}
+
+void ofi_on_event_batch(void* self, const OfiEvent* ev, std::size_t n) {
+  OfiPlugin& p = *static_cast<OfiPlugin*>(self);
+  QueueOfiStrategy& s = p.strat;
+  const Event* e = reinterpret_cast<const Event*>(ev);
+  for (std::size_t i = 0; i < n; ++i) {
+    p.realize(e[i].ts, s.advance(e[i].ts));
+    if (e[i].type == EvType::Trade) {
+      s.on_trade(e[i].t);
+    } else {
+      const QuoteL1& q = e[i].q;
+      s.mark(q);
+      if (s.passes_gates(q)) {
+        const auto sig = s.on_quote(q);
+        p.realize(q.ts, s.act_and_fill(q.ts, 0.5 * (q.bid_px + q.ask_px), sig));
+      }
+    }
+    p.watch_position();
+  }
+}
+
+void ofi_on_timer(void* self, std::int64_t now_ns, std::uint64_t) {
+  OfiPlugin& p = *static_cast<OfiPlugin*>(self);
+  p.realize(now_ns, p.strat.advance(now_ns));
+}
+
+void ofi_finish(void* self, std::int64_t now_ns) {
+  OfiPlugin* p = static_cast<OfiPlugin*>(self);
+  if (p->strat.pos().side != 0 && now_ns > 0)
+    p->realize(now_ns, p->strat.act_and_fill(now_ns, p->strat.mid(), 0));
+  delete p;
+}
+
+const OfiStrategyApi kApi{OFI_STRATEGY_ABI_VERSION, "queue_ofi",
+                          &ofi_init, &ofi_on_event_batch, &ofi_on_timer, &ofi_finish};
+
+}  // namespace
+
+extern "C" const OfiStrategyApi* ofi_strategy_entry(void) { return &kApi; }
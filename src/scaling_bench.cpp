@@ -0,0 +1,366 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/resource.h>
+#include <time.h>
+
+#include "common/Clock.hpp"
+#include "common/ThreadPool.hpp"
+#include "common/Types.hpp"
+#include "data/DayCache.hpp"
+#include "data/DayMerge.hpp"
+#include "data/DbnReader.hpp"
+#include "data/SyntheticDay.hpp"
+#include "strategy/QueueOfi.hpp"
+
+// Thread-scaling study. Each workload runs at every --threads count on the
+// same input, best of --reps:
+//   load      decode + merge every day in parallel (synthetic generation
+//             stands in for the DBN decoder without --ymd)
+//   optimize  the optimizer's day-major loop: per day, all candidates in
+//             parallel on the shared DayData
+//   stream    STREAM-style triad over --stream-mb arrays, the bandwidth
+//             ceiling the other two are compared against
+// Per run: wall, throughput, speedup/efficiency vs 1 thread, per-worker
+// utilization (busy wall and CPU time over run wall), bytes moved per
+// second and minor faults (allocator / first-touch pressure). Each
+// workload ends with an Amdahl fit of its parallel fraction; the Karp-Flatt
+// column is the serial fraction implied at each point, and a value that
+// rises with n means something other than the serial part (locks,
+// allocator, bandwidth) is eating the speedup.
+
+static std::int64_t thread_cpu_ns() {
+  timespec t{};
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t);
+  return std::int64_t(t.tv_sec) * 1'000'000'000LL + t.tv_nsec;
+}
+
+// Busy time per pool worker. Workers claim a slot on their first task of a
+// run; the generation check makes a fresh pool (or run) re-claim.
+class WorkerProbe {
+ public:
+  explicit WorkerProbe(std::size_t n) : busy(n), cpu(n), tasks(n) {}
+
+  template <class F>
+  void timed(F&& f) {
+    const std::size_t s = slot();
+    const std::int64_t c0 = thread_cpu_ns();
+    const std::uint64_t t0 = TscClock::ticks();
+    f();
+    busy[s] += std::int64_t(double(TscClock::ticks() - t0) * TscClock::ns_per_tick());
+    cpu[s]  += thread_cpu_ns() - c0;
+    ++tasks[s];
+  }
+
+  std::vector<std::int64_t> busy, cpu;
+  std::vector<std::uint64_t> tasks;
+
+ private:
+  std::atomic<std::size_t> next{0};
+  const std::uint64_t gen = next_gen().fetch_add(1) + 1;
+
+  static std::atomic<std::uint64_t>& next_gen() { static std::atomic<std::uint64_t> g{0}; return g; }
+
+  std::size_t slot() {
+    thread_local std::uint64_t my_gen = 0;
+    thread_local std::size_t my_slot = 0;
+    if (my_gen != gen) { my_gen = gen; my_slot = next.fetch_add(1) % busy.size(); }
+    return my_slot;
+  }
+};
+
+struct ScalePoint {
+  std::size_t threads = 0;
+  std::int64_t wall_ns = 0;
+  double units = 0.0;          // events (load/optimize) or array elements (stream)
+  double bytes = 0.0;          // bytes read + written by the workload
+  double util_busy = 0.0;      // mean over workers of busy wall / run wall
+  double util_cpu = 0.0;       // mean over workers of thread CPU / run wall
+  double util_min = 0.0;       // least busy worker (imbalance shows here)
+  long   minflt = 0;
+};
+
+static long minor_faults() {
+  rusage ru{};
+  getrusage(RUSAGE_SELF, &ru);
+  return ru.ru_minflt;
+}
+
+template <class Run>
+static ScalePoint measure(std::size_t threads, int reps, Run&& run) {
+  ScalePoint best;
+  for (int r = 0; r < reps; ++r) {
+    ThreadPool pool(threads);
+    WorkerProbe probe(threads);
+    ScalePoint p;
+    p.threads = threads;
+    const long f0 = minor_faults();
+    const std::int64_t t0 = TscClock::now_ns();
+    run(pool, probe, p);
+    p.wall_ns = std::max<std::int64_t>(1, TscClock::now_ns() - t0);
+    p.minflt = minor_faults() - f0;
+
+    double sb = 0.0, sc = 0.0, mn = 1e300;
+    for (std::size_t w = 0; w < threads; ++w) {
+      const double u = double(probe.busy[w]) / double(p.wall_ns);
+      sb += u;
+      sc += double(probe.cpu[w]) / double(p.wall_ns);
+      mn = std::min(mn, u);
+    }
+    p.util_busy = sb / double(threads);
+    p.util_cpu  = sc / double(threads);
+    p.util_min  = mn;
+    if (r == 0 || p.wall_ns < best.wall_ns) best = p;
+  }
+  return best;
+}
+
+// Least squares for the parallel fraction p in 1/S(n) = (1-p) + p/n, i.e.
+// y = p·x with y = 1/S - 1 and x = 1/n - 1 (no intercept: S(1) = 1).
+static double amdahl_fit(const std::vector<ScalePoint>& pts) {
+  double sxy = 0.0, sxx = 0.0;
+  const double t1 = double(pts.front().wall_ns);
+  for (const auto& p : pts) {
+    if (p.threads < 2) continue;
+    const double x = 1.0 / double(p.threads) - 1.0;
+    const double y = double(p.wall_ns) / t1 - 1.0;
+    sxy += x * y;
+    sxx += x * x;
+  }
+  return sxx > 0.0 ? std::clamp(sxy / sxx, 0.0, 1.0) : 1.0;
+}
+
+static void print_curve(const std::string& name, const char* unit, const std::vector<ScalePoint>& pts) {
+  const double t1 = double(pts.front().wall_ns);
+  std::cout << "[" << name << "]\n" << std::fixed
+            << std::setw(8) << "threads" << std::setw(11) << "wall_ms" << std::setw(13) << unit
+            << std::setw(9) << "speedup" << std::setw(8) << "eff%" << std::setw(15) << "busy/cpu/min%"
+            << std::setw(9) << "GB/s" << std::setw(11) << "minflt" << std::setw(12) << "karp_flatt"
+            << std::setw(10) << "amdahl\n";
+  const double p = amdahl_fit(pts);
+  for (const auto& pt : pts) {
+    const double n = double(pt.threads);
+    const double wall_s = double(pt.wall_ns) / 1e9;
+    const double s = t1 / double(pt.wall_ns);
+    const double kf = pt.threads > 1 ? (1.0 / s - 1.0 / n) / (1.0 - 1.0 / n) : 0.0;
+    const double model = 1.0 / ((1.0 - p) + p / n);
+    std::ostringstream util;
+    util << std::fixed << std::setprecision(0) << 100.0 * pt.util_busy << "/" << 100.0 * pt.util_cpu
+         << "/" << 100.0 * pt.util_min;
+    std::cout << std::setw(8) << pt.threads
+              << std::setw(11) << std::setprecision(1) << double(pt.wall_ns) / 1e6
+              << std::setw(13) << std::setprecision(3) << pt.units / wall_s / 1e6
+              << std::setw(9) << std::setprecision(2) << s
+              << std::setw(8) << std::setprecision(0) << 100.0 * s / n
+              << std::setw(15) << util.str()
+              << std::setw(9) << std::setprecision(2) << pt.bytes / wall_s / 1e9
+              << std::setw(11) << pt.minflt
+              << std::setw(12) << std::setprecision(3) << kf
+              << std::setw(9) << std::setprecision(2) << model << "\n";
+  }
+  std::cout << "  amdahl p=" << std::setprecision(3) << p << " serial=" << (1.0 - p)
+            << " max_speedup=" << std::setprecision(1);
+  if (p < 1.0) std::cout << 1.0 / (1.0 - p) << "\n"; else std::cout << "inf\n";
+}
+
+struct DaySource {
+  std::vector<std::string> ymds;   // real days; empty = synthetic
+  std::size_t synth_days = 8;
+  SyntheticOptions so;
+
+  std::size_t count() const { return ymds.empty() ? synth_days : ymds.size(); }
+
+  DayData load(std::size_t d) const {
+    DayData day;
+    if (ymds.empty()) {
+      SyntheticOptions o = so;
+      o.seed = so.seed + d;
+      o.start_ts = so.start_ts + std::int64_t(d) * 86'400'000'000'000LL;
+      day.events = synthetic_day(o);
+      for (auto it = day.events.rbegin(); it != day.events.rend(); ++it)
+        if (it->type == EvType::Quote) { day.last_quote = it->q; day.has_quotes = true; break; }
+      return day;
+    }
+    constexpr std::uint32_t ESZ3_ID = 314863;
+    const std::string mbp = "data/mbp-1/glbx-mdp3-" + ymds[d] + ".mbp-1.dbn.zst";
+    const std::string trd = "data/trades/glbx-mdp3-" + ymds[d] + ".trades.dbn.zst";
+    DayEvents q = load_day_from_dbn(mbp, "mbp-1", ESZ3_ID);
+    DayEvents t;
+    if (std::filesystem::exists(trd)) t = load_day_from_dbn(trd, "trades", ESZ3_ID);
+    return make_day(q, t);
+  }
+};
+
+// candidate k of K: a small grid around the backtest defaults so the
+// replays branch differently (same shape as an optimizer generation)
+static OfiParams candidate(std::size_t k) {
+  static constexpr std::array<double, 4> kTheta = {3.0, 5.0, 8.0, 12.0};
+  static constexpr std::array<double, 3> kImb = {0.10, 0.15, 0.25};
+  static constexpr std::array<int, 3> kPersist = {1, 3, 5};
+  OfiParams P;
+  P.theta_ofi = kTheta[k % kTheta.size()];
+  P.theta_imb = kImb[(k / kTheta.size()) % kImb.size()];
+  P.persist_updates = kPersist[(k / (kTheta.size() * kImb.size())) % kPersist.size()];
+  P.slip_ticks = 1;
+  P.max_hold_ns = 2'000'000'000LL;
+  P.min_flip_cooldown_ns = 120'000'000LL;
+  P.rth_only = true;
+  P.fill_at_touch_when_spread1 = true;
+  P.trade_confirm_ns = 0;
+  return P;
+}
+
+static std::size_t replay(const DayData& day, const OfiParams& P) {
+  QueueOfiStrategy strat(P);
+  std::array<Fill, 1024> fills;
+  std::size_t n_fills = 0;
+  std::span<const Event> rest{day.events};
+  while (!rest.empty()) {
+    const BatchResult br = strat.on_events(rest, fills);
+    n_fills += br.fills;
+    rest = rest.subspan(br.consumed);
+  }
+  return n_fills;
+}
+
+static std::vector<std::size_t> parse_threads(const std::string& s) {
+  std::vector<std::size_t> v;
+  std::stringstream ss(s);
+  std::string tok;
+  while (std::getline(ss, tok, ',')) if (!tok.empty()) v.push_back(std::stoull(tok));
+  return v;
+}
+
+static std::vector<std::string> parse_list(const std::string& s) {
+  std::vector<std::string> v;
+  std::stringstream ss(s);
+  std::string tok;
+  while (std::getline(ss, tok, ',')) if (!tok.empty()) v.push_back(tok);
+  return v;
+}
+
+int main(int argc, char** argv) {
+  std::vector<std::size_t> threads;
+  std::string workloads = "load,optimize,stream";
+  DaySource src;
+  src.so.events = 500'000;
+  std::size_t candidates = 32;
+  std::size_t stream_mb = 256;
+  int reps = 3;
+  for (int i = 1; i < argc; ++i) {
+    const std::string a = argv[i];
+    if      (a.rfind("--threads=", 0) == 0)    threads = parse_threads(a.substr(10));
+    else if (a.rfind("--workloads=", 0) == 0)  workloads = a.substr(12);
+    else if (a.rfind("--days=", 0) == 0)       src.synth_days = std::stoull(a.substr(7));
+    else if (a.rfind("--events=", 0) == 0)     src.so.events = std::stoull(a.substr(9));
+    else if (a.rfind("--ymd=", 0) == 0)        src.ymds = parse_list(a.substr(6));
+    else if (a.rfind("--candidates=", 0) == 0) candidates = std::stoull(a.substr(13));
+    else if (a.rfind("--stream-mb=", 0) == 0)  stream_mb = std::stoull(a.substr(12));
+    else if (a.rfind("--reps=", 0) == 0)       reps = std::stoi(a.substr(7));
+    else {
+      std::cerr << "Usage: scaling_bench [--threads=1,2,4,...] [--workloads=load,optimize,stream]\n"
+                   "                     [--days=N] [--events=N] [--ymd=YYYYMMDD,...] [--candidates=K]\n"
+                   "                     [--stream-mb=MB] [--reps=N]\n";
+      return 1;
+    }
+  }
+  const std::size_t hw = std::max(1u, std::thread::hardware_concurrency());
+  if (threads.empty()) {
+    for (std::size_t n = 1; n < hw; n *= 2) threads.push_back(n);
+    threads.push_back(hw);
+  }
+  std::sort(threads.begin(), threads.end());
+  threads.erase(std::unique(threads.begin(), threads.end()), threads.end());
+  if (threads.front() == 0) { std::cerr << "--threads must be >= 1\n"; return 1; }
+  if (threads.front() != 1) threads.insert(threads.begin(), 1);   // speedups are relative to 1 thread
+  for (const auto& ymd : src.ymds) {
+    const std::string mbp = "data/mbp-1/glbx-mdp3-" + ymd + ".mbp-1.dbn.zst";
+    if (!std::filesystem::exists(mbp)) { std::cerr << "Missing MBP-1 file: " << mbp << "\n"; return 1; }
+  }
+  if (src.count() == 0 || candidates == 0 || reps < 1) { std::cerr << "Nothing to run\n"; return 1; }
+
+  const auto want = [&](const char* w) { return ("," + workloads + ",").find(std::string(",") + w + ",") != std::string::npos; };
+  std::cout << "[bench] hw_threads=" << hw << " days=" << src.count()
+            << (src.ymds.empty() ? " source=synthetic events/day=" + std::to_string(src.so.events) : " source=dbn")
+            << " candidates=" << candidates << " reps=" << reps << "\n";
+
+  if (want("load")) {
+    std::vector<ScalePoint> pts;
+    for (std::size_t n : threads) {
+      pts.push_back(measure(n, reps, [&](ThreadPool& pool, WorkerProbe& probe, ScalePoint& p) {
+        std::vector<std::size_t> sizes(src.count());
+        pool.parallel_for(src.count(), [&](std::size_t d) {
+          probe.timed([&] { sizes[d] = src.load(d).events.size(); });
+        });
+        for (std::size_t s : sizes) p.units += double(s);
+        p.bytes = p.units * double(sizeof(Event));   // merged output written (decoder input not counted)
+      }));
+    }
+    print_curve("load", "Mev/s", pts);
+  }
+
+  if (want("optimize")) {
+    // decoded once, outside the timed region: this measures the replay fan-out only
+    std::vector<DayData> days(src.count());
+    {
+      ThreadPool pool(hw);
+      pool.parallel_for(days.size(), [&](std::size_t d) { days[d] = src.load(d); });
+    }
+    std::vector<OfiParams> cands;
+    for (std::size_t k = 0; k < candidates; ++k) cands.push_back(candidate(k));
+    std::size_t total = 0;
+    for (const auto& d : days) total += d.events.size();
+
+    std::vector<ScalePoint> pts;
+    for (std::size_t n : threads) {
+      pts.push_back(measure(n, reps, [&](ThreadPool& pool, WorkerProbe& probe, ScalePoint& p) {
+        std::vector<std::size_t> fills(cands.size());
+        for (const auto& day : days)
+          pool.parallel_for(cands.size(), [&](std::size_t c) {
+            probe.timed([&] { fills[c] += replay(day, cands[c]); });
+          });
+        p.units = double(total) * double(cands.size());
+        p.bytes = p.units * double(sizeof(Event));   // every candidate streams the whole day
+      }));
+    }
+    print_curve("optimize", "Mev/s", pts);
+  }
+
+  if (want("stream")) {
+    const std::size_t n_el = std::max<std::size_t>(1, stream_mb * (1u << 20) / sizeof(double) / 3);
+    std::unique_ptr<double[]> a(new double[n_el]), b(new double[n_el]), c(new double[n_el]);
+    for (std::size_t i = 0; i < n_el; ++i) { a[i] = 0.0; b[i] = 1.0; c[i] = 2.0; }
+    constexpr int kPasses = 4;
+    std::vector<ScalePoint> pts;
+    for (std::size_t n : threads) {
+      pts.push_back(measure(n, reps, [&](ThreadPool& pool, WorkerProbe& probe, ScalePoint& p) {
+        const std::size_t chunk = (n_el + n - 1) / n;
+        for (int pass = 0; pass < kPasses; ++pass)
+          pool.parallel_for(n, [&](std::size_t w) {
+            probe.timed([&] {
+              const std::size_t lo = w * chunk, hi = std::min(n_el, lo + chunk);
+              for (std::size_t i = lo; i < hi; ++i) a[i] = b[i] + 3.0 * c[i];
+            });
+          });
+        p.units = double(n_el) * kPasses;
+        p.bytes = p.units * 3.0 * sizeof(double);   // 2 reads + 1 write (write-allocate not counted)
+      }));
+    }
+    double sink = 0.0;
+    for (std::size_t i = 0; i < n_el; i += 4096) sink += a[i];
+    print_curve("stream", "Mel/s", pts);
+    if (sink < 0.0) std::cout << sink;   // keep the triad observable
+  }
+  return 0;
+}
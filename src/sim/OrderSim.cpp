@@ -0,0 +1,251 @@
+#include "sim/OrderSim.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+static bool same_px(double a, double b) { return std::fabs(a - b) <= 1e-9; }
+
+OrderSim::OrderSim(OrderSimParams p, std::size_t reserve) : P(p), table(reserve) {
+  live.reserve(reserve);
+  wire.reserve(reserve);
+  reports.reserve(reserve);
+}
+
+SimHandle OrderSim::submit(int side, double px, QtyI qty, TsNanos now, bool may_take) {
+  if (side == 0 || qty <= 0) return {};
+  const SimHandle h = table.alloc();
+  SimOrder& o = *table.get(h);
+  o.side = side > 0 ? 1 : -1;
+  o.px = px;
+  o.leaves = qty;
+  o.may_take = may_take;
+  wire.push_back({h, now + P.to_exchange_ns});
+  ++st.submits;
+  return h;
+}
+
+bool OrderSim::busy(SimHandle h) const {
+  const SimOrder* o = table.get(h);
+  return o && (o->state == SimOrder::InFlight || o->action != SimOrder::None);
+}
+
+bool OrderSim::cancel(SimHandle h, TsNanos now) {
+  SimOrder* o = table.get(h);
+  if (!o || busy(h)) return false;
+  o->action = SimOrder::Cancel;
+  wire.push_back({h, now + P.to_exchange_ns});
+  ++st.cancels;
+  return true;
+}
+
+bool OrderSim::replace(SimHandle h, double px, QtyI qty, TsNanos now) {
+  SimOrder* o = table.get(h);
+  if (!o || busy(h) || qty <= 0) return false;
+  o->action = SimOrder::Replace;
+  o->new_px = px;
+  o->new_qty = qty;
+  wire.push_back({h, now + P.to_exchange_ns});
+  ++st.replaces;
+  return true;
+}
+
+void OrderSim::arrive_until(TsNanos ts) {
+  while (wire_head < wire.size() && wire[wire_head].arrive_ts <= ts) {
+    const InFlightAction a = wire[wire_head++];
+    if (SimOrder* o = table.get(a.h)) arrive(a.h, *o, a.arrive_ts);
+  }
+  if (wire_head == wire.size()) { wire.clear(); wire_head = 0; }
+}
+
+bool OrderSim::crosses(const SimOrder& o) const {
+  if (!have_book) return false;
+  return o.side > 0 ? book.ask_px > 0.0 && o.px >= book.ask_px - 1e-9
+                    : book.bid_px > 0.0 && o.px <= book.bid_px + 1e-9;
+}
+
+void OrderSim::arrive(SimHandle h, SimOrder& o, TsNanos ts) {
+  if (o.state == SimOrder::InFlight) {   // new order
+    if (crosses(o)) {
+      if (P.post_only && !o.may_take) {
+        o.state = SimOrder::Done;
+        ++st.rejects;
+        report(h, o, SimExec::Rejected, 0, ts, o.px);
+        table.release(h);
+        return;
+      }
+      // fills in full on arrival without ever resting: stays out of `live`
+      ++st.taker_fills;
+      fill(h, o, o.leaves, o.side > 0 ? book.ask_px : book.bid_px, ts);
+      return;
+    }
+    o.state = SimOrder::Live;
+    join_queue(o);
+    add_live(h, o);
+    report(h, o, SimExec::New, o.leaves, ts, o.px);
+    return;
+  }
+
+  const SimOrder::Action act = o.action;
+  o.action = SimOrder::None;
+  if (o.state == SimOrder::Done) {   // filled while the action was on the wire
+    ++st.too_late;
+    report(h, o, SimExec::Rejected, 0, ts, o.px);
+    table.release(h);
+    return;
+  }
+
+  if (act == SimOrder::Cancel) {
+    remove_live(o);
+    o.state = SimOrder::Done;
+    report(h, o, SimExec::Canceled, o.leaves, ts, o.px);
+    table.release(h);
+    return;
+  }
+
+  // replace: only a pure size reduction keeps the place in the queue
+  const bool keeps_priority = same_px(o.new_px, o.px) && o.new_qty <= o.leaves;
+  if (!keeps_priority) {
+    SimOrder moved = o;
+    moved.px = o.new_px;
+    if (crosses(moved) && P.post_only && !o.may_take) {   // the resting order stays as it was
+      ++st.rejects;
+      report(h, o, SimExec::Rejected, 0, ts, o.new_px);
+      return;
+    }
+  }
+  o.px = o.new_px;
+  o.leaves = o.new_qty;
+  if (keeps_priority) {
+    o.ahead = std::min(o.ahead, double(o.level_sz));
+  } else {
+    ++st.priority_resets;
+    if (crosses(o)) {
+      ++st.taker_fills;
+      fill(h, o, o.leaves, o.side > 0 ? book.ask_px : book.bid_px, ts);
+      return;
+    }
+    join_queue(o);
+  }
+  report(h, o, SimExec::Replaced, o.leaves, ts, o.px);
+}
+
+// back of the queue at o.px as the book stands now
+void OrderSim::join_queue(SimOrder& o) {
+  o.traded = 0.0;
+  o.improving = false;
+  o.at_touch = false;
+  o.queue_known = false;
+  o.ahead = 0.0;
+  if (!have_book) return;
+  const double touch = o.side > 0 ? book.bid_px : book.ask_px;
+  const QtyI   sz    = o.side > 0 ? book.bid_sz : book.ask_sz;
+  if (touch <= 0.0) return;
+  if (same_px(o.px, touch)) {
+    o.at_touch = o.queue_known = true;
+    o.ahead = double(sz);
+    o.level_sz = sz;
+  } else if (o.side > 0 ? o.px > touch : o.px < touch) {
+    o.improving = o.at_touch = o.queue_known = true;
+    o.level_sz = 0;
+  }
+}
+
+void OrderSim::on_quote(const QuoteL1& q) {
+  arrive_until(q.ts);
+  book = q;
+  have_book = true;
+  for (std::size_t i = live.size(); i-- > 0;) {
+    const SimHandle h = live[i];
+    SimOrder& o = *table.get(h);
+    const double touch = o.side > 0 ? q.bid_px : q.ask_px;
+    const double other = o.side > 0 ? q.ask_px : q.bid_px;
+    const QtyI   sz    = o.side > 0 ? q.bid_sz : q.ask_sz;
+    if (touch <= 0.0) continue;
+    const bool below = o.side > 0 ? touch < o.px - 1e-9 : touch > o.px + 1e-9;   // touch behind our price
+    const bool above = o.side > 0 ? touch > o.px + 1e-9 : touch < o.px - 1e-9;   // touch ahead of it
+
+    if (o.improving) {
+      if (other > 0.0 && (o.side > 0 ? other <= o.px + 1e-9 : other >= o.px - 1e-9)) {
+        fill(h, o, o.leaves, o.px, q.ts);    // the other side came to us
+      } else if (above) {                    // outbid; we are first at our price
+        o.improving = o.at_touch = false;
+        o.ahead = 0.0;
+      } else if (!below) {                   // others joined us, behind
+        o.improving = false;
+        o.level_sz = sz;
+      }
+      continue;
+    }
+    if (below) { fill(h, o, o.leaves, o.px, q.ts); continue; }   // our level traded through
+    if (above) { o.at_touch = false; o.traded = 0.0; continue; }
+
+    if (!o.at_touch) {
+      o.at_touch = true;
+      o.ahead = o.queue_known ? std::min(o.ahead, double(sz)) : double(sz);
+      o.queue_known = true;
+    } else if (sz < o.level_sz) {
+      const double unexplained = std::max(0.0, double(o.level_sz - sz) - o.traded);
+      o.ahead = std::max(0.0, o.ahead - P.cancel_ahead * unexplained);
+    }
+    o.ahead = std::min(o.ahead, double(sz));
+    o.level_sz = sz;
+    o.traded = 0.0;
+  }
+}
+
+void OrderSim::on_trade(const Trade& t) {
+  arrive_until(t.ts);
+  for (std::size_t i = live.size(); i-- > 0;) {
+    const SimHandle h = live[i];
+    SimOrder& o = *table.get(h);
+    if (o.side > 0 ? t.px < o.px - 1e-9 : t.px > o.px + 1e-9) {   // printed through our price
+      fill(h, o, o.leaves, o.px, t.ts);
+      continue;
+    }
+    const Aggressor hits = o.side > 0 ? Aggressor::Sell : Aggressor::Buy;
+    if (t.side != hits && t.side != Aggressor::Unknown) continue;
+    if (o.improving) {
+      // sellers reaching a lower bid would have hit us first
+      if (o.side > 0 ? t.px <= o.px + 1e-9 : t.px >= o.px - 1e-9)
+        fill(h, o, std::min<QtyI>(o.leaves, t.sz), o.px, t.ts);
+      continue;
+    }
+    if (!o.at_touch || !same_px(t.px, o.px)) continue;
+    o.traded += double(t.sz);
+    const double past = double(t.sz) - o.ahead;
+    o.ahead = std::max(0.0, o.ahead - double(t.sz));
+    if (past > 0.0) fill(h, o, std::min<QtyI>(o.leaves, static_cast<QtyI>(past)), o.px, t.ts);
+  }
+}
+
+void OrderSim::fill(SimHandle h, SimOrder& o, QtyI qty, double px, TsNanos ts) {
+  if (qty <= 0) return;
+  o.leaves -= qty;
+  ++st.fills;
+  st.filled_qty += static_cast<std::uint64_t>(qty);
+  report(h, o, SimExec::Fill, qty, ts, px);
+  if (o.leaves > 0) return;
+  remove_live(o);
+  o.state = SimOrder::Done;
+  if (o.action == SimOrder::None) table.release(h);   // else on the action's arrival
+}
+
+void OrderSim::report(SimHandle h, const SimOrder& o, SimExec type, QtyI qty, TsNanos ts, double px) {
+  reports.push_back({h, type, o.side, px, qty, o.leaves, ts, ts + P.to_client_ns});
+}
+
+void OrderSim::add_live(SimHandle h, SimOrder& o) {
+  o.live_pos = static_cast<std::uint32_t>(live.size());
+  live.push_back(h);
+  st.max_live = std::max(st.max_live, live.size());
+}
+
+void OrderSim::remove_live(SimOrder& o) {
+  if (o.state != SimOrder::Live) return;
+  const std::uint32_t pos = o.live_pos;
+  if (pos >= live.size()) return;
+  const SimHandle last = live.back();
+  live[pos] = last;
+  table.get(last)->live_pos = pos;
+  live.pop_back();
+}
@@ -7,6 +7,7 @@
 
 #include "common/Types.hpp"
 #include "data/DbnReader.hpp"
+#include "pipeline/Stages.hpp"
 
 static double microprice(const QuoteL1& q) {
   const double A = q.ask_px;                // PriceI is double now
@@ -16,22 +17,6 @@ static double microprice(const QuoteL1& q) {
   return (A * Bsz + B * Asz) / (Asz + Bsz);
 }
 
-static std::vector<Event> merge_streams(const std::vector<QuoteL1>& qs,
-                                        const std::vector<Trade>& ts) {
-  std::vector<Event> ev;
-  ev.reserve(qs.size() + ts.size());
-  size_t i = 0, j = 0;
-  while (i < qs.size() || j < ts.size()) {
-    const bool take_q = (j == ts.size()) || (i < qs.size() && qs[i].ts <= ts[j].ts);
-    if (take_q) {
-      Event e; e.type = EvType::Quote; e.ts = qs[i].ts; e.q = qs[i]; ev.push_back(e); ++i;
-    } else {
-      Event e; e.type = EvType::Trade; e.ts = ts[j].ts; e.t = ts[j]; ev.push_back(e); ++j;
-    }
-  }
-  return ev;
-}
-
 int main(int argc, char** argv) {
   // Auto-pick a day you likely have (override via argv[1])
   std::string ymd = (argc > 1) ? argv[1] : "20231002";
@@ -44,20 +29,13 @@ int main(int argc, char** argv) {
   }
   const bool have_trades = std::filesystem::exists(trd_path);
 
-  std::cout << "Loading MBP-1: " << mbp_path << "\n";
-  auto day_q = load_day_from_dbn(mbp_path, "mbp-1");
-
-  std::cout << "Loading Trades: " << trd_path
+  std::cout << "Streaming MBP-1: " << mbp_path << "\n";
+  std::cout << "Streaming Trades: " << trd_path
             << (have_trades ? "" : " (not found, skipping)") << "\n";
-  DayEvents day_t;
-  if (have_trades) day_t = load_day_from_dbn(trd_path, "trades");
-
-  std::cout << "quotes: " << day_q.quotes.size()
-            << ", trades: " << day_t.trades.size() << "\n";
 
-  // Merge and compute a couple of sanity checks
-  auto ev = merge_streams(day_q.quotes, day_t.trades);
-  std::cout << "merged events: " << ev.size() << "\n";
+  // decode + merge run on a worker thread; merged chunks arrive through a bounded channel.
+  // merge_stage signs Unknown prints as it merges, so no infer_aggressors pass here
+  auto events = threaded_stage(day_stage(mbp_path, have_trades ? trd_path : std::string{}));
 
   // sample microprice + simple OFI(L1) running sum
   std::int64_t ofi_sum = 0;
@@ -67,8 +45,12 @@ int main(int argc, char** argv) {
 
   std::cout << std::fixed << std::setprecision(2);
 
-  for (const auto& e : ev) {
+  std::size_t n_quotes = 0, n_trades = 0;
+  for (const auto& chunk : events)
+  for (const auto& e : chunk) {
+    if (e.type == EvType::Trade) ++n_trades;
     if (e.type == EvType::Quote) {
+      ++n_quotes;
       const double mp = microprice(e.q);
       if (sampled < 3) {
         std::cout << "ts=" << e.ts
@@ -86,6 +68,9 @@ int main(int argc, char** argv) {
       last_bid_sz = e.q.bid_sz; last_ask_sz = e.q.ask_sz;
     }
   }
+  std::cout << "quotes: " << n_quotes
+            << ", trades: " << n_trades << "\n";
+  std::cout << "merged events: " << (n_quotes + n_trades) << "\n";
   std::cout << "OFI(L1) running sum ~ " << ofi_sum << "\n";
   std::cout << "Smoke test OK.\n";
   return 0;
@@ -0,0 +1,141 @@
+#include "strategy/MakerOfi.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+MakerOfi::MakerOfi(const OfiParams& p, const MakerParams& m)
+    : P(p), M(m), sig(p), sim(m.sim) {}
+
+double MakerOfi::on_event(const Event& e) {
+  double realized = 0.0;
+  sim.advance(e.ts, [&](const SimExecReport& r) { realized += on_report(r); });
+  sig.advance(e.ts);   // cooldown / confirmation timers
+
+  if (e.type == EvType::Trade) {
+    sim.on_trade(e.t);
+    sig.on_trade(e.t);
+    return realized;
+  }
+  const QuoteL1& q = e.q;
+  sim.on_quote(q);
+  if (q.bid_px <= 0.0 || q.ask_px <= q.bid_px) return realized;
+  int s = 0;
+  if (sig.admit(q)) {
+    const auto v = sig.on_quote(q);
+    if (v) s = *v;
+  }
+  decide(q, s);
+  return realized;
+}
+
+double MakerOfi::flatten(const QuoteL1& q) {
+  if (pos == 0) return 0.0;
+  const double px = pos > 0 ? q.bid_px : q.ask_px;
+  const double realized = (px - entry_px) / P.tick_size * P.tick_value * pos;
+  pos = 0;
+  ++ms.take_exits;
+  ++ms.round_trips;
+  return realized;
+}
+
+double MakerOfi::on_report(const SimExecReport& r) {
+  double realized = 0.0;
+  if (r.type == SimExec::Fill) {
+    const int signed_qty = r.side * r.qty;
+    if (pos == 0 || (pos > 0) == (r.side > 0)) {
+      if (pos == 0) entry_ts = r.client_ts;
+      entry_px = (entry_px * std::abs(pos) + r.px * r.qty) / (std::abs(pos) + r.qty);
+    } else {
+      const int closed = std::min(std::abs(pos), int(r.qty));
+      const int dir = pos > 0 ? 1 : -1;
+      realized = dir * (r.px - entry_px) / P.tick_size * P.tick_value * closed;
+      if (closed == std::abs(pos)) ++ms.round_trips;
+      if (int(r.qty) > closed) { entry_px = r.px; entry_ts = r.client_ts; }   // flipped through
+    }
+    pos += signed_qty;
+  }
+  if (r.h != working) return realized;
+  bool done = false;
+  switch (r.type) {
+    case SimExec::New:      acked = true; [[fallthrough]];
+    case SimExec::Replaced: working_px = r.px; working_leaves = r.leaves; pending = false; break;
+    case SimExec::Fill:
+      if (!acked) { acked = true; pending = false; }   // a marketable order filled on arrival
+      working_leaves = r.leaves;
+      done = r.leaves == 0 && !pending;
+      break;
+    case SimExec::Canceled: done = true; break;
+    case SimExec::Rejected:   // a refused new order, or a cancel/replace after the last fill
+      pending = false;
+      done = !acked || working_leaves == 0;
+      break;
+  }
+  if (done) working = {};
+  return realized;
+}
+
+double MakerOfi::passive_px(const QuoteL1& q, int side) const {
+  const bool wide = q.ask_px - q.bid_px > P.tick_size + 1e-9;
+  const double step = M.improve && wide ? P.tick_size : 0.0;
+  return side > 0 ? q.bid_px + step : q.ask_px - step;
+}
+
+void MakerOfi::send(const QuoteL1& q, Role r, int side, double px, QtyI qty, bool take) {
+  working = sim.submit(side, px, qty, q.ts, take);
+  role = r;
+  working_side = side;
+  working_px = px;
+  working_leaves = qty;
+  working_take = take;
+  acked = false;
+  pending = true;
+  working_ts = q.ts;
+}
+
+// follow the touch; a new price costs the order its place in the queue
+void MakerOfi::repeg(const QuoteL1& q, int side) {
+  const double px = passive_px(q, side);
+  if (std::fabs(px - working_px) <= 1e-9 || working_leaves <= 0) return;
+  if (sim.replace(working, px, working_leaves, q.ts)) { pending = true; ++ms.repegs; }
+}
+
+void MakerOfi::decide(const QuoteL1& q, int s) {
+  if (working && pending) return;   // wait for the ack
+
+  if (role == Entry && working) {
+    if (s == -working_side || q.ts - working_ts >= P.queue_max_wait_ns) {
+      if (sim.cancel(working, q.ts)) { pending = true; ++ms.entry_cancels; }
+      return;
+    }
+    repeg(q, working_side);
+    return;
+  }
+
+  if (pos == 0) {
+    if (!working && s != 0) {
+      send(q, Entry, s, passive_px(q, s), M.lots, false);
+      ++ms.entries;
+    }
+    return;
+  }
+
+  const int out = pos > 0 ? -1 : 1;
+  const bool urgent = q.ts - entry_ts >= P.max_hold_ns || s == out;
+  if (working) {
+    if (working_take) return;
+    if (urgent) {   // take once the cancel is confirmed
+      if (sim.cancel(working, q.ts)) pending = true;
+      return;
+    }
+    repeg(q, out);
+    return;
+  }
+  if (urgent) {
+    send(q, Exit, out, out > 0 ? q.ask_px : q.bid_px, std::abs(pos), true);
+    ++ms.take_exits;
+  } else {
+    send(q, Exit, out, passive_px(q, out), std::abs(pos), false);
+    ++ms.exits;
+  }
+}
@@ -1,5 +1,8 @@
 #include "strategy/QueueOfi.hpp"
+#include "common/L1Ofi.hpp"
+#include "common/Rth.hpp"
 #include <algorithm>
+#include <cassert>
 #include <cmath>
 
 static inline bool spread_is_one_tick(double bid_px, double ask_px, double tick) {
@@ -27,19 +30,8 @@ bool QueueOfiStrategy::price_moved(const QuoteL1& q) const {
 void QueueOfiStrategy::update_ofi_l1(const QuoteL1& q) {
   if (!have_prev) { ofi_l1 = 0.0; return; }
 
-  double e_b = 0.0;
-  if (q.bid_px > last_bid_px)      e_b = static_cast<double>(q.bid_sz);
-  else if (q.bid_px < last_bid_px) e_b = -static_cast<double>(last_bid_sz);
-  else                             e_b = static_cast<double>(q.bid_sz) - static_cast<double>(last_bid_sz);
+  const double ofi_inst = l1_ofi(QuoteL1{q.ts, last_bid_px, last_ask_px, last_bid_sz, last_ask_sz}, q);
 
-  double e_a = 0.0;
-  if (q.ask_px < last_ask_px)      e_a = static_cast<double>(q.ask_sz);
-  else if (q.ask_px > last_ask_px) e_a = -static_cast<double>(last_ask_sz);
-  else                             e_a = static_cast<double>(last_ask_sz) - static_cast<double>(q.ask_sz);
-
-  const double ofi_inst = e_b - e_a;
-
-  static double ofi_ewm = 0.0;
   constexpr double ALPHA = 0.20;
   ofi_ewm = (1.0 - ALPHA) * ofi_ewm + ALPHA * ofi_inst;
   ofi_l1 = ofi_ewm;
@@ -50,6 +42,15 @@ int QueueOfiStrategy::desired_position() const {
   if (!spread_is_one_tick(last_bid_px, last_ask_px, P.tick_size)) return 0;
   if (last_bid_sz < P.min_bid_sz || last_ask_sz < P.min_ask_sz)   return 0;
 
+  int raw = 0;
+  if (P.alpha_rls) {
+    if (alpha.updates() < P.alpha_warmup) return 0;
+    const double edge = alpha.predict();
+    if (edge >  P.alpha_cost_ticks) raw = +1;
+    if (edge < -P.alpha_cost_ticks) raw = -1;
+    return raw;
+  }
+
   const double micro_skew_ticks = (micro() - mid()) / P.tick_size;
   constexpr double SKEW_TH = 0.10;
 
@@ -63,37 +64,44 @@ int QueueOfiStrategy::desired_position() const {
       (imbalance_ticks() < -P.theta_imb) &&
       (micro_skew_ticks < -SKEW_TH);
 
-  int raw = 0;
   if (long_raw)  raw = +1;
   if (short_raw) raw = -1;
-  if (raw == 0)  return 0;
+  return raw;
+}
 
+int QueueOfiStrategy::confirmed(int raw) const {
   // NEW: trade confirmation within P.trade_confirm_ns
   if (P.trade_confirm_ns > 0) {
     // require a recent aggressive trade in the same direction
     // (we update last_trade_dir/last_trade_ts in on_trade)
     if (last_trade_dir != raw) return 0;
     if (last_trade_ts == 0)    return 0;
-    // (callers pass the event ts into act_and_fill; here we only have last_* state,
-    //  so we check "recency" via on_quote’s updated last_*; a stricter check is
-    //  enforced in act_and_fill by ignoring sig after staleness if desired.)
-    // We keep the gating here simple: rely on on_quote cadence (µs–ms).
+    // recency: the confirmation timer resets last_trade_dir once the window lapses
   }
   return raw;
 }
 
-std::optional<int> QueueOfiStrategy::on_quote(const QuoteL1& q) {
+// Per-event bodies are inline so the batch loops below get them fully
+// inlined; the public single-event calls are thin wrappers.
+inline void QueueOfiStrategy::step_absorb(const QuoteL1& q) {
   update_ofi_l1(q);
+  if (P.alpha_rls) alpha.on_quote(q);
 
   // update L1 state AFTER computing OFI vs previous
   last_bid_px = q.bid_px; last_ask_px = q.ask_px;
   last_bid_sz = q.bid_sz; last_ask_sz = q.ask_sz;
   have_prev = true;
+}
 
+inline std::optional<int> QueueOfiStrategy::step_decide() {
   // persistence
-  static int last_raw_sig = 0;
-  static int same_dir_count = 0;
-  const int raw_sig = desired_position();
+  int raw_sig = desired_position();
+  if (raw_sig == 0) {
+    ctr.add(Ctr::no_signal);
+  } else if (confirmed(raw_sig) == 0) {
+    ctr.add(Ctr::rej_confirm);
+    raw_sig = 0;
+  }
 
   if (raw_sig == 0) {
     last_raw_sig = 0;
@@ -106,73 +114,362 @@ std::optional<int> QueueOfiStrategy::on_quote(const QuoteL1& q) {
     last_raw_sig = raw_sig;
     same_dir_count = 1;
   }
-  if (same_dir_count >= P.persist_updates) return raw_sig;
+  if (same_dir_count >= P.persist_updates) {
+    ctr.add(Ctr::signals);
+    return raw_sig;
+  }
+  ctr.add(Ctr::rej_persist);
   return std::optional<int>{};
 }
 
+inline std::optional<int> QueueOfiStrategy::step_quote(const QuoteL1& q) {
+  step_absorb(q);
+  return step_decide();
+}
+
+void QueueOfiStrategy::load_snapshot(const QuoteL1& q) {
+  last_bid_px = q.bid_px; last_ask_px = q.ask_px;
+  last_bid_sz = q.bid_sz; last_ask_sz = q.ask_sz;
+  have_prev = true;
+  ofi_l1 = ofi_ewm = 0.0;
+  if (P.alpha_rls) alpha.load_snapshot(q);
+  last_raw_sig = 0;
+  same_dir_count = 0;
+  cancel_entry();   // its queue position is unknown across a gap
+  mark(q);
+}
+
 void QueueOfiStrategy::on_trade(const Trade& t) {
+  ctr.add(Ctr::trades);
   last_trade_ts  = t.ts;
   // map aggressor to +/-1
   if      (t.side == Aggressor::Buy)  last_trade_dir = +1;
   else if (t.side == Aggressor::Sell) last_trade_dir = -1;
   else                                last_trade_dir = 0;
+  if (P.alpha_rls) alpha.on_trade(t);
+
+  if (entry_order.active() && entry_order.on_trade(t)) fill_entry(t.ts);
+
+  // confirmation lapses trade_confirm_ns after the print
+  wheel.cancel(confirm_timer);
+  if (P.trade_confirm_ns > 0 && last_trade_dir != 0)
+    confirm_timer = wheel.insert(t.ts + P.trade_confirm_ns, ConfirmExpiry);
 }
 
-double QueueOfiStrategy::act_and_fill(TsNanos ts, double mid_px, std::optional<int> sig) {
-  static TsNanos last_flip_ts = 0;
-
-  // time-based exit
-  if (position.side != 0 && ts - position.entry_ts > P.max_hold_ns) {
-    // exit at touch if spread==1 and allowed; else mid±½ tick
-    double slip = 0.5 * P.slip_ticks * P.tick_size;
-    if (P.fill_at_touch_when_spread1 &&
-        spread_is_one_tick(last_bid_px, last_ask_px, P.tick_size) &&
-        last_bid_sz >= P.min_bid_sz && last_ask_sz >= P.min_ask_sz) {
-      slip = 0.0;
+// exit at touch if spread==1 and allowed; else mid±½ tick
+double QueueOfiStrategy::slip_for(double bid_px, double ask_px, QtyI bid_sz, QtyI ask_sz) const {
+  if (P.fill_at_touch_when_spread1 &&
+      spread_is_one_tick(bid_px, ask_px, P.tick_size) &&
+      bid_sz >= P.min_bid_sz && ask_sz >= P.min_ask_sz) {
+    return 0.0;
+  }
+  return 0.5 * P.slip_ticks * P.tick_size;
+}
+
+// aggressive fill of up to `qty` lots (side > 0 buys): at mid +/- slip, or
+// walked through the attached depth book; returns the lots filled, price in px
+QtyI QueueOfiStrategy::take(int side, QtyI qty, double mid_px, double slip, double& px) {
+  if (!depth) {
+    px = mid_px + side * slip;
+    return qty;
+  }
+  const BookWalk w = depth->walk(side, qty);
+  ++dstats.takes;
+  dstats.lots_wanted += static_cast<std::uint64_t>(qty);
+  dstats.lots_filled += static_cast<std::uint64_t>(w.filled);
+  dstats.levels_walked += static_cast<std::uint64_t>(w.levels);
+  if (w.filled < qty) ++dstats.partial;
+  if (w.filled > 0) {
+    px = w.vwap;
+    dstats.slip_ticks += std::fabs(w.vwap - depth->level(-side, 0).px) / P.tick_size * w.filled;
+  }
+  return w.filled;
+}
+
+void QueueOfiStrategy::place_entry(int side, TsNanos ts) {
+  assert(P.lots == 1 && "queue_fill models a single 1-lot order");
+  const QuoteL1 q = have_mark ? mark_q
+                              : QuoteL1{ts, last_bid_px, last_ask_px, last_bid_sz, last_ask_sz};
+  entry_order.place(side, q);
+  ++qstats.placed;
+  ctr.add(Ctr::entries);
+  entry_timer = wheel.insert(ts + P.queue_max_wait_ns, EntryExpiry);
+}
+
+void QueueOfiStrategy::cancel_entry() {
+  if (!entry_order.active()) return;
+  entry_order.cancel();
+  wheel.cancel(entry_timer);
+  ++qstats.cancelled;
+}
+
+// the resting entry filled at its price; the hold timer starts now
+void QueueOfiStrategy::fill_entry(TsNanos ts) {
+  ++qstats.filled;
+  qstats.traded_through += entry_order.traded_through();
+  wheel.cancel(entry_timer);
+  position.side     = entry_order.side();
+  position.entry_px = entry_order.price();
+  position.entry_ts = ts;
+  position.qty      = P.lots;
+  ctr.set(Gauge::position_lots, position.qty);
+  hold_timer = wheel.insert(ts + P.max_hold_ns + 1, HoldExpiry);
+  entry_order.cancel();
+}
+
+void QueueOfiStrategy::start_cooldown(TsNanos ts) {
+  last_flip_ts = ts;
+  wheel.cancel(cooldown_timer);
+  cooldown_active = P.min_flip_cooldown_ns > 0;
+  if (cooldown_active) cooldown_timer = wheel.insert(ts + P.min_flip_cooldown_ns, CooldownEnd);
+}
+
+// time-based exit at the prevailing book when the hold timer fires
+double QueueOfiStrategy::exit_on_timer(TsNanos ts) {
+  if (position.side == 0) return 0.0;
+  const QuoteL1 q = have_mark ? mark_q
+                              : QuoteL1{ts, last_bid_px, last_ask_px, last_bid_sz, last_ask_sz};
+  const double slip = slip_for(q.bid_px, q.ask_px, q.bid_sz, q.ask_sz);
+  double exit = 0.0;
+  const QtyI out = take(-position.side, position.qty, 0.5 * (q.bid_px + q.ask_px), slip, exit);
+  const double pnl_ticks = (exit - position.entry_px) / P.tick_size * position.side;
+  position.qty -= out;
+  if (out > 0) ctr.add(Ctr::fills);
+  ctr.set(Gauge::position_lots, position.qty);
+  if (position.qty > 0) {   // the book ran out: the rest once it has been updated
+    exit_retry = true;
+    exit_book_ts = depth ? depth->time() : ts;
+    return out > 0 ? pnl_ticks * P.tick_value * out : 0.0;
+  }
+  position = {};
+  start_cooldown(ts);
+  return pnl_ticks * P.tick_value * out;
+}
+
+double QueueOfiStrategy::advance(TsNanos now) {
+  double realized = 0.0;
+  wheel.advance(now, [&](std::uint32_t kind, std::uint64_t, std::int64_t deadline) {
+    switch (kind) {
+      case HoldExpiry:    realized += exit_on_timer(deadline); break;
+      case CooldownEnd:   cooldown_active = false;             break;
+      case ConfirmExpiry: last_trade_dir = 0;                  break;
+      case EntryExpiry:   entry_order.cancel(); ++qstats.expired; break;
+      default: break;
     }
-    const double exit = mid_px - position.side * slip;
-    const double pnl_ticks = (exit - position.entry_px) / P.tick_size * position.side;
-    position = {};
-    last_flip_ts = ts;
-    return pnl_ticks * P.tick_value;
+  });
+  if (exit_retry && depth && depth->time() != exit_book_ts) {
+    exit_retry = false;
+    realized += exit_on_timer(now);
   }
+  return realized;
+}
 
+inline double QueueOfiStrategy::step_fill(TsNanos ts, double mid_px, std::optional<int> sig) {
   if (sig.has_value()) {
-    // flip cooldown
+    // flip cooldown (cleared by its timer)
     if (position.side != 0 && sig.value() != 0 && sig.value() != position.side) {
-      if (ts - last_flip_ts < P.min_flip_cooldown_ns) return 0.0;
+      if (cooldown_active) { ctr.add(Ctr::rej_cooldown); return 0.0; }
     }
 
+    // queue_fill: an entry for this side is already resting; going flat pulls it
+    if (entry_order.active() && sig.value() == entry_order.side()) return 0.0;
+    if (sig.value() == 0) cancel_entry();
+
     double realized = 0.0;
     if (sig.value() != position.side) {
+      const double slip = slip_for(last_bid_px, last_ask_px, last_bid_sz, last_ask_sz);
       // exit current
       if (position.side != 0) {
-        double slip = 0.5 * P.slip_ticks * P.tick_size;
-        if (P.fill_at_touch_when_spread1 &&
-            spread_is_one_tick(last_bid_px, last_ask_px, P.tick_size) &&
-            last_bid_sz >= P.min_bid_sz && last_ask_sz >= P.min_ask_sz) {
-          slip = 0.0;
-        }
-        const double exit = mid_px - position.side * slip;
+        double exit = 0.0;
+        const QtyI out = take(-position.side, position.qty, mid_px, slip, exit);
         const double pnl_ticks = (exit - position.entry_px) / P.tick_size * position.side;
-        realized = pnl_ticks * P.tick_value;
+        realized = out > 0 ? pnl_ticks * P.tick_value * out : 0.0;
+        position.qty -= out;
+        if (out > 0) ctr.add(Ctr::fills);
+        ctr.set(Gauge::position_lots, position.qty);
+        if (position.qty > 0) return realized;   // still partly in: no new entry yet
         position = {};
+        exit_retry = false;
+        wheel.cancel(hold_timer);
       }
-      // open desired
-      if (sig.value() != 0) {
-        double slip = 0.5 * P.slip_ticks * P.tick_size;
-        if (P.fill_at_touch_when_spread1 &&
-            spread_is_one_tick(last_bid_px, last_ask_px, P.tick_size) &&
-            last_bid_sz >= P.min_bid_sz && last_ask_sz >= P.min_ask_sz) {
-          slip = 0.0;
+      cancel_entry();
+      // open desired; the hold timer fires once ts - entry_ts > max_hold_ns
+      if (sig.value() != 0 && P.queue_fill) {
+        place_entry(sig.value(), ts);
+      } else if (sig.value() != 0) {
+        double px = 0.0;
+        const QtyI in = take(sig.value(), P.lots, mid_px, slip, px);
+        if (in > 0) {
+          position.side     = sig.value();
+          position.entry_px = px;
+          position.entry_ts = ts;
+          position.qty      = in;
+          ctr.add(Ctr::entries);
+          ctr.set(Gauge::position_lots, position.qty);
+          hold_timer = wheel.insert(ts + P.max_hold_ns + 1, HoldExpiry);
+        } else {
+          return realized;   // the book gave nothing: no flip happened, no cooldown
         }
-        position.side     = sig.value();
-        position.entry_px = mid_px + position.side * slip;
-        position.entry_ts = ts;
       }
-      last_flip_ts = ts;
+      start_cooldown(ts);
     }
     return realized;
   }
   return 0.0;
 }
+
+std::optional<int> QueueOfiStrategy::on_quote(const QuoteL1& q) { return step_quote(q); }
+
+double QueueOfiStrategy::act_and_fill(TsNanos ts, double mid_px, std::optional<int> sig) {
+  const double timed = advance(ts);
+  return timed + step_fill(ts, mid_px, sig);
+}
+
+void QueueOfiStrategy::absorb_quote(const QuoteL1& q) { step_absorb(q); }
+
+std::optional<int> QueueOfiStrategy::decide() { return step_decide(); }
+
+void QueueOfiStrategy::skip_quiet(const QuietStretch& s) {
+  if (s.traded) {   // on_trade: only the last print survives the stretch
+    last_trade_ts  = s.trade_ts;
+    last_trade_dir = s.trade_dir;
+    wheel.cancel(confirm_timer);
+    if (P.trade_confirm_ns > 0 && s.trade_dir != 0)
+      confirm_timer = wheel.insert(s.trade_ts + P.trade_confirm_ns, ConfirmExpiry);
+  }
+  if (s.fed) {      // step_absorb, and a decide() that never saw a raw signal
+    last_bid_px = s.last_fed.bid_px; last_ask_px = s.last_fed.ask_px;
+    last_bid_sz = s.last_fed.bid_sz; last_ask_sz = s.last_fed.ask_sz;
+    have_prev = true;
+    ofi_l1 = ofi_ewm = s.ofi;
+    last_raw_sig = 0;
+    same_dir_count = 0;
+  }
+  if (s.quoted) { mark_q = s.last_quote; have_mark = true; }
+  advance(s.end_ts);   // cooldown / confirmation expiries; idle, so nothing realizes
+}
+
+// ---------- batch API ----------
+namespace {
+// gate invariants hoisted out of the per-event loop
+struct QuoteGate {
+  bool   rth_only;
+  bool   check_spread;
+  double need_spread;
+  QtyI   min_bid_sz, min_ask_sz;
+
+  explicit QuoteGate(const OfiParams& P)
+      : rth_only(P.rth_only),
+        check_spread(P.min_spread_ticks > 0),
+        need_spread(P.min_spread_ticks * P.tick_size),
+        min_bid_sz(P.min_bid_sz),
+        min_ask_sz(P.min_ask_sz) {}
+
+  // 0 if q passes, else the first gate that rejects it (1 rth, 2 spread,
+  // 3 size); branch-free so the mask pass over a block can vectorize
+  std::uint8_t reject(const QuoteL1& q) const {
+    const bool rth  = !rth_only | is_rth_utc(q.ts);
+    const bool spr  = !check_spread | (std::fabs((q.ask_px - q.bid_px) - need_spread) <= 1e-9);
+    const bool size = (q.bid_sz >= min_bid_sz) & (q.ask_sz >= min_ask_sz);
+    return static_cast<std::uint8_t>((!rth) | ((rth & !spr) << 1) | ((rth & spr & !size) * 3));
+  }
+  bool pass(const QuoteL1& q) const { return reject(q) == 0; }
+};
+
+constexpr std::uint8_t kNotQuote = 4;
+
+// gate verdicts of the first n events of a block into the counters
+inline void tally(CounterSet& c, const std::uint8_t* why, std::size_t n) {
+  std::uint64_t quotes = 0, rth = 0, spread = 0, size = 0;
+  for (std::size_t k = 0; k < n; ++k) {
+    quotes += why[k] != kNotQuote;
+    rth    += why[k] == 1;
+    spread += why[k] == 2;
+    size   += why[k] == 3;
+  }
+  c.add(Ctr::quotes, quotes);
+  c.add(Ctr::gate_rth, rth);
+  c.add(Ctr::gate_spread, spread);
+  c.add(Ctr::gate_size, size);
+}
+
+constexpr std::size_t kBlock    = 256;  // events per gate-mask pass
+constexpr std::size_t kPrefetch = 8;    // events ahead
+}  // namespace
+
+bool QueueOfiStrategy::passes_gates(const QuoteL1& q) const { return QuoteGate(P).pass(q); }
+
+bool QueueOfiStrategy::admit(const QuoteL1& q) {
+  const std::uint8_t why = QuoteGate(P).reject(q);
+  tally(ctr, &why, 1);
+  return why == 0;
+}
+
+BatchResult QueueOfiStrategy::on_events(std::span<const Event> ev, std::span<Fill> fills) {
+  assert(fills.size() >= 2 && "a batch needs room for two exits, or it consumes nothing");
+  const QuoteGate gate(P);
+  BatchResult r;
+  std::uint8_t why[kBlock];
+
+  while (r.consumed < ev.size()) {
+    const std::size_t base = r.consumed;
+    const std::size_t n = std::min(kBlock, ev.size() - base);
+
+    for (std::size_t k = 0; k < n; ++k) {
+      const Event& e = ev[base + k];
+      why[k] = e.type == EvType::Quote ? gate.reject(e.q) : kNotQuote;
+    }
+
+    for (std::size_t k = 0; k < n; ++k) {
+      // an event realizes at most a timer exit and a signal exit; stop before overflowing
+      if (fills.size() - r.fills < 2) { tally(ctr, why, k); return r; }
+      if (base + k + kPrefetch < ev.size()) __builtin_prefetch(&ev[base + k + kPrefetch]);
+
+      const Event& e = ev[base + k];
+      ++r.consumed;
+      const double timed = advance(e.ts);
+      if (timed != 0.0) fills[r.fills++] = Fill{e.ts, timed};
+      if (e.type == EvType::Trade) { on_trade(e.t); continue; }
+      mark(e.q);
+      if (why[k] != 0) continue;
+
+      const auto sig = step_quote(e.q);
+      const double realized = step_fill(e.ts, 0.5 * (e.q.bid_px + e.q.ask_px), sig);
+      if (realized != 0.0) fills[r.fills++] = Fill{e.ts, realized};
+    }
+    tally(ctr, why, n);
+  }
+  return r;
+}
+
+BatchResult QueueOfiStrategy::on_quotes(std::span<const QuoteL1> qs, std::span<Fill> fills) {
+  assert(fills.size() >= 2 && "a batch needs room for two exits, or it consumes nothing");
+  const QuoteGate gate(P);
+  BatchResult r;
+  std::uint8_t why[kBlock];
+
+  while (r.consumed < qs.size()) {
+    const std::size_t base = r.consumed;
+    const std::size_t n = std::min(kBlock, qs.size() - base);
+
+    for (std::size_t k = 0; k < n; ++k) why[k] = gate.reject(qs[base + k]);
+
+    for (std::size_t k = 0; k < n; ++k) {
+      if (fills.size() - r.fills < 2) { tally(ctr, why, k); return r; }
+      if (base + k + kPrefetch < qs.size()) __builtin_prefetch(&qs[base + k + kPrefetch]);
+
+      const QuoteL1& q = qs[base + k];
+      ++r.consumed;
+      const double timed = advance(q.ts);
+      if (timed != 0.0) fills[r.fills++] = Fill{q.ts, timed};
+      mark(q);
+      if (why[k] != 0) continue;
+
+      const auto sig = step_quote(q);
+      const double realized = step_fill(q.ts, 0.5 * (q.bid_px + q.ask_px), sig);
+      if (realized != 0.0) fills[r.fills++] = Fill{q.ts, realized};
+    }
+    tally(ctr, why, n);
+  }
+  return r;
+}
@@ -0,0 +1,83 @@
+#include "telemetry/ShmTelemetry.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+bool telemetry_pid_alive(std::int32_t pid) {
+  if (pid <= 0) return false;
+  return ::kill(pid, 0) == 0 || errno == EPERM;
+}
+
+bool TelemetryPublisher::open(const std::string& label, const std::string& segment) {
+  close();
+  const int fd = ::shm_open(segment.c_str(), O_CREAT | O_RDWR, 0644);
+  if (fd < 0) return false;
+  // every creator truncates to the same size, so racing processes agree
+  if (::ftruncate(fd, sizeof(TelemetrySegment)) != 0) { ::close(fd); return false; }
+  void* p = ::mmap(nullptr, sizeof(TelemetrySegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (p == MAP_FAILED) return false;
+
+  // fresh pages are zero, which is a valid empty segment
+  seg = static_cast<TelemetrySegment*>(p);
+  if (seg->magic.load(std::memory_order_acquire) != kTelemetryMagic) {
+    seg->version = kTelemetryVersion;
+    seg->nslots  = kTelemetrySlots;
+    seg->nfields = kTelemetryFields;
+    seg->magic.store(kTelemetryMagic, std::memory_order_release);
+  } else if (seg->version != kTelemetryVersion || seg->nfields != kTelemetryFields) {
+    ::munmap(p, sizeof(TelemetrySegment));   // left behind by an older build
+    seg = nullptr;
+    return false;
+  }
+
+  const std::int32_t me = static_cast<std::int32_t>(::getpid());
+  for (auto& s : seg->slots) {
+    std::int32_t owner = s.owner_pid.load(std::memory_order_acquire);
+    if (owner != 0 && telemetry_pid_alive(owner)) continue;
+    // claim it with a sentinel so readers skip the slot while we reset it
+    if (!s.owner_pid.compare_exchange_strong(owner, -1, std::memory_order_acq_rel)) continue;
+
+    telemetry_store(s, TelemetryValues{});
+    std::memset(s.name, 0, sizeof(s.name));
+    std::strncpy(s.name, label.c_str(), sizeof(s.name) - 1);
+    s.owner_pid.store(me, std::memory_order_release);
+    slot = &s;
+    return true;
+  }
+  ::munmap(p, sizeof(TelemetrySegment));
+  seg = nullptr;
+  return false;
+}
+
+void TelemetryPublisher::close() {
+  if (slot) slot->owner_pid.store(0, std::memory_order_release);
+  if (seg) ::munmap(seg, sizeof(TelemetrySegment));
+  slot = nullptr;
+  seg = nullptr;
+}
+
+bool TelemetryReader::open(const std::string& segment) {
+  const int fd = ::shm_open(segment.c_str(), O_RDONLY, 0);
+  if (fd < 0) return false;
+  void* p = ::mmap(nullptr, sizeof(TelemetrySegment), PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (p == MAP_FAILED) return false;
+
+  const auto* s = static_cast<const TelemetrySegment*>(p);
+  if (s->magic.load(std::memory_order_acquire) != kTelemetryMagic ||
+      s->version != kTelemetryVersion || s->nfields != kTelemetryFields) {
+    ::munmap(p, sizeof(TelemetrySegment));
+    return false;
+  }
+  seg = s;
+  return true;
+}
+
+TelemetryReader::~TelemetryReader() {
+  if (seg) ::munmap(const_cast<TelemetrySegment*>(seg), sizeof(TelemetrySegment));
+}
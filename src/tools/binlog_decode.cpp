@@ -0,0 +1,78 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "log/BinLog.hpp"
+
+// Renders a BinLog file as text: "<ns> [thread] <formatted message>".
+static std::string render(const std::string& fmt, const LogRecord& r) {
+  std::string out;
+  std::size_t k = 0;
+  char buf[64];
+  for (std::size_t i = 0; i < fmt.size(); ++i) {
+    if (fmt[i] == '{' && i + 1 < fmt.size() && fmt[i + 1] == '}' && k < r.nargs) {
+      const auto t = static_cast<LogArg>((r.types >> (2 * k)) & 3u);
+      const std::uint64_t w = r.args[k++];
+      if (t == LogArg::F64) {
+        double d;
+        std::memcpy(&d, &w, sizeof d);
+        std::snprintf(buf, sizeof buf, "%.6g", d);
+      } else if (t == LogArg::I64) {
+        std::snprintf(buf, sizeof buf, "%lld", static_cast<long long>(w));
+      } else {
+        std::snprintf(buf, sizeof buf, "%llu", static_cast<unsigned long long>(w));
+      }
+      out += buf;
+      ++i;
+    } else {
+      out += fmt[i];
+    }
+  }
+  return out;
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::cerr << "Usage: binlog_decode <file.blog>\n";
+    return 1;
+  }
+  std::FILE* f = std::fopen(argv[1], "rb");
+  if (!f) { std::cerr << "Cannot open " << argv[1] << "\n"; return 1; }
+
+  char magic[8];
+  double ns_per_tick = 1.0;
+  std::uint64_t t0 = 0;
+  std::int64_t ns0 = 0;
+  std::uint16_t n_fmt = 0;
+  if (std::fread(magic, 1, 8, f) != 8 || std::memcmp(magic, "OFIBLOG1", 8) != 0 ||
+      std::fread(&ns_per_tick, sizeof ns_per_tick, 1, f) != 1 ||
+      std::fread(&t0, sizeof t0, 1, f) != 1 ||
+      std::fread(&ns0, sizeof ns0, 1, f) != 1 ||
+      std::fread(&n_fmt, sizeof n_fmt, 1, f) != 1) {
+    std::cerr << "Not a BinLog file: " << argv[1] << "\n";
+    return 1;
+  }
+  std::vector<std::string> formats(n_fmt);
+  for (auto& s : formats) {
+    std::uint16_t len = 0;
+    if (std::fread(&len, sizeof len, 1, f) != 1) { std::cerr << "Truncated header\n"; return 1; }
+    s.resize(len);
+    if (len && std::fread(s.data(), 1, len, f) != len) { std::cerr << "Truncated header\n"; return 1; }
+  }
+
+  LogRecord r;
+  std::size_t n = 0;
+  while (std::fread(&r, sizeof r, 1, f) == 1) {
+    const auto dt = static_cast<std::int64_t>(r.tsc - t0);
+    const auto ns = ns0 + static_cast<std::int64_t>(static_cast<double>(dt) * ns_per_tick);
+    const std::string& fmt = r.fmt < formats.size() ? formats[r.fmt] : std::string("<unknown format>");
+    std::cout << ns << " [" << int(r.thread) << "] " << render(fmt, r) << "\n";
+    ++n;
+  }
+  std::fclose(f);
+  std::cerr << n << " records\n";
+  return 0;
+}
@@ -0,0 +1,177 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/Clock.hpp"
+#include "common/ThreadPool.hpp"
+#include "common/Types.hpp"
+#include "data/BarStore.hpp"
+#include "data/Bars.hpp"
+#include "data/DayMerge.hpp"
+#include "data/DbnReader.hpp"
+#include "data/SyntheticDay.hpp"
+
+// Builds 1s/10s/1m (or --res=) bars for every day in one scan per day,
+// days in parallel, into the columnar bar store; --show prints a stored
+// file back. Bar-level studies then never touch tick data again.
+
+static std::vector<std::string> split(const std::string& s) {
+  std::vector<std::string> v;
+  std::stringstream ss(s);
+  std::string tok;
+  while (std::getline(ss, tok, ',')) if (!tok.empty()) v.push_back(tok);
+  return v;
+}
+
+static int show(const std::string& path, std::size_t max_rows) {
+  BarColumns b;
+  if (!read_bars(path, b)) { std::cerr << "Cannot read bar file: " << path << "\n"; return 1; }
+  std::cout << "[bars] " << path << " size=" << bar_size_label(b.bar_ns) << " rows=" << b.size() << "\n";
+  std::cout << std::fixed << std::setprecision(3);
+  for (std::size_t i = 0; i < std::min(max_rows, b.size()); ++i) {
+    std::cout << b.ts[i]
+              << " mid=" << b.mid_o[i] << "/" << b.mid_h[i] << "/" << b.mid_l[i] << "/" << b.mid_c[i]
+              << " micro=" << b.micro_o[i] << "/" << b.micro_h[i] << "/" << b.micro_l[i] << "/" << b.micro_c[i]
+              << " vol=" << b.buy_vol[i] << "/" << b.sell_vol[i] << "/" << b.other_vol[i]
+              << " ofi=" << std::setprecision(0) << b.ofi[i] << std::setprecision(3)
+              << " quotes=" << b.quotes[i] << " trades=" << b.trades[i] << "\n";
+  }
+  return 0;
+}
+
+struct DayJob {
+  std::string ymd;
+  std::size_t events = 0, bars = 0, bytes = 0;
+  std::int64_t load_ns = 0, build_ns = 0, write_ns = 0;
+  bool ok = true;
+};
+
+int main(int argc, char** argv) {
+  std::vector<std::string> days;
+  std::size_t synthetic = 0;
+  SyntheticOptions so;
+  std::vector<std::string> res = {"1s", "10s", "1m"};
+  std::string out_dir = "bars";
+  std::size_t threads = std::thread::hardware_concurrency();
+  for (int i = 1; i < argc; ++i) {
+    const std::string a = argv[i];
+    if      (a.rfind("--ymd=", 0) == 0)       days = split(a.substr(6));
+    else if (a.rfind("--synthetic=", 0) == 0) synthetic = std::stoull(a.substr(12));
+    else if (a.rfind("--events=", 0) == 0)    so.events = std::stoull(a.substr(9));
+    else if (a.rfind("--res=", 0) == 0)       res = split(a.substr(6));
+    else if (a.rfind("--out=", 0) == 0)       out_dir = a.substr(6);
+    else if (a.rfind("--threads=", 0) == 0)   threads = std::stoull(a.substr(10));
+    else if (a.rfind("--show=", 0) == 0) {
+      const std::string spec = a.substr(7);
+      const auto colon = spec.rfind(':');
+      if (colon == std::string::npos) return show(spec, 20);
+      return show(spec.substr(0, colon), std::stoull(spec.substr(colon + 1)));
+    } else {
+      std::cerr << "Usage: build_bars [--ymd=YYYYMMDD,...] [--synthetic=N_DAYS] [--events=N]\n"
+                   "                  [--res=1s,10s,1m] [--out=DIR] [--threads=N]\n"
+                   "       build_bars --show=FILE[:ROWS]\n";
+      return 1;
+    }
+  }
+
+  std::vector<std::int64_t> bar_ns;
+  for (const auto& r : res) {
+    const std::int64_t ns = parse_bar_size(r);
+    if (ns == 0) { std::cerr << "Bad bar size: " << r << "\n"; return 1; }
+    bar_ns.push_back(ns);
+  }
+  if (bar_ns.empty()) { std::cerr << "No bar sizes given\n"; return 1; }
+  const std::int64_t finest = *std::min_element(bar_ns.begin(), bar_ns.end());
+  for (std::int64_t ns : bar_ns)
+    if (ns % finest != 0) {
+      std::cerr << "Bar size " << bar_size_label(ns) << " is not a multiple of " << bar_size_label(finest) << "\n";
+      return 1;
+    }
+
+  const auto mbp_path = [](const std::string& ymd) { return "data/mbp-1/glbx-mdp3-" + ymd + ".mbp-1.dbn.zst"; };
+  const auto trd_path = [](const std::string& ymd) { return "data/trades/glbx-mdp3-" + ymd + ".trades.dbn.zst"; };
+  if (synthetic > 0) {
+    days.clear();
+    for (std::size_t d = 0; d < synthetic; ++d) days.push_back("synthetic" + std::to_string(d));
+  } else {
+    if (days.empty())
+      for (int d = 1; d <= 30; ++d) {
+        char buf[16];
+        std::snprintf(buf, sizeof(buf), "202310%02d", d);
+        days.emplace_back(buf);
+      }
+    std::erase_if(days, [&](const std::string& ymd) { return !std::filesystem::exists(mbp_path(ymd)); });
+  }
+  if (days.empty()) { std::cerr << "No days found on disk.\n"; return 1; }
+
+  std::error_code ec;
+  std::filesystem::create_directories(out_dir, ec);
+  if (ec) { std::cerr << "Cannot create " << out_dir << ": " << ec.message() << "\n"; return 1; }
+
+  // one task per day: decode, one bar pass for every size, write the columns
+  constexpr std::uint32_t ESZ3_ID = 314863;
+  std::vector<DayJob> jobs(days.size());
+  ThreadPool pool(threads);
+  const std::int64_t t0 = TscClock::now_ns();
+  pool.parallel_for(days.size(), [&](std::size_t d) {
+    DayJob& j = jobs[d];
+    j.ymd = days[d];
+    std::int64_t t = TscClock::now_ns();
+    std::vector<Event> ev;
+    if (synthetic > 0) {
+      SyntheticOptions o = so;
+      o.seed = so.seed + d;
+      o.start_ts = so.start_ts + std::int64_t(d) * 86'400'000'000'000LL;
+      ev = synthetic_day(o);
+    } else {
+      DayEvents q = load_day_from_dbn(mbp_path(j.ymd), "mbp-1", ESZ3_ID);
+      DayEvents tr;
+      if (std::filesystem::exists(trd_path(j.ymd))) tr = load_day_from_dbn(trd_path(j.ymd), "trades", ESZ3_ID);
+      ev = make_day(q, tr).events;
+    }
+    j.events = ev.size();
+    const std::int64_t t1 = TscClock::now_ns();
+    const auto bars = build_bars(ev, bar_ns);
+    const std::int64_t t2 = TscClock::now_ns();
+    for (const auto& b : bars) {
+      j.bars += b.size();
+      j.bytes += b.bytes();
+      j.ok = write_bars(bar_file_path(out_dir, j.ymd, b.bar_ns), b) && j.ok;
+    }
+    j.load_ns = t1 - t;
+    j.build_ns = t2 - t1;
+    j.write_ns = TscClock::now_ns() - t2;
+  });
+  const double wall_s = double(TscClock::now_ns() - t0) / 1e9;
+
+  std::cout << std::fixed << std::setprecision(1);
+  std::size_t events = 0, bars = 0, bytes = 0, failed = 0;
+  std::int64_t load_ns = 0, build_ns = 0, write_ns = 0;
+  for (const DayJob& j : jobs) {
+    std::cout << "[day] " << j.ymd << " events=" << j.events << " bars=" << j.bars
+              << " load_ms=" << j.load_ns / 1e6 << " build_ms=" << j.build_ns / 1e6
+              << " write_ms=" << j.write_ns / 1e6 << (j.ok ? "" : " WRITE_FAILED") << "\n";
+    events += j.events; bars += j.bars; bytes += j.bytes; failed += !j.ok;
+    load_ns += j.load_ns; build_ns += j.build_ns; write_ns += j.write_ns;
+  }
+  // build rate is per thread: the bar pass alone over the merged events
+  const double scanned_gb = double(events) * sizeof(Event) / 1e9;
+  std::cout << "[bars] days=" << jobs.size() << " sizes=";
+  for (std::size_t i = 0; i < bar_ns.size(); ++i) std::cout << (i ? "," : "") << bar_size_label(bar_ns[i]);
+  std::cout << " events=" << events << " bars=" << bars
+            << " stored_mb=" << double(bytes) / 1e6 << " out=" << out_dir << "\n"
+            << "[time] wall_s=" << std::setprecision(2) << wall_s
+            << " load_s=" << load_ns / 1e9 << " build_s=" << build_ns / 1e9 << " write_s=" << write_ns / 1e9
+            << " build_mev_s=" << (build_ns ? double(events) / (build_ns / 1e9) / 1e6 : 0.0)
+            << " build_gb_s=" << (build_ns ? scanned_gb / (build_ns / 1e9) : 0.0)
+            << " threads=" << pool.size() << "\n";
+  if (failed) { std::cerr << failed << " day(s) failed to write under " << out_dir << "\n"; return 1; }
+  return 0;
+}
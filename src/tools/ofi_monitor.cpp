@@ -0,0 +1,78 @@
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "common/Clock.hpp"
+#include "telemetry/ShmTelemetry.hpp"
+
+// Attaches to the telemetry segment read-only and prints every live slot
+// once per interval: counters, event rate since the last refresh, ring
+// depth, feed latency percentiles, PnL and progress.
+int main(int argc, char** argv) {
+  std::string segment = kTelemetrySegment;
+  int interval_ms = 1000;
+  bool once = false;
+  for (int i = 1; i < argc; ++i) {
+    const std::string a = argv[i];
+    if      (a.rfind("--segment=", 0) == 0)     segment = a.substr(10);
+    else if (a.rfind("--interval-ms=", 0) == 0) interval_ms = std::stoi(a.substr(14));
+    else if (a == "--once")                     once = true;
+    else {
+      std::cerr << "Usage: ofi_monitor [--segment=/name] [--interval-ms=N] [--once]\n";
+      return 1;
+    }
+  }
+
+  TelemetryReader reader;
+  while (!reader.open(segment)) {
+    if (once) { std::cerr << "No telemetry segment: " << segment << "\n"; return 1; }
+    std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+  }
+  const TelemetrySegment& seg = *reader.segment();
+
+  TelemetryValues prev[kTelemetrySlots]{};
+  std::int32_t    prev_pid[kTelemetrySlots]{};
+
+  for (;;) {
+    std::printf("%-4s %-7s %-16s %12s %10s %9s %8s %13s %4s %21s %12s %7s %6s\n",
+                "slot", "pid", "name", "events", "ev/s", "signals", "fills",
+                "depth/max", "conf", "lat_us p50/p99/max", "pnl", "done%", "age_s");
+    const std::int64_t now = TscClock::now_ns();
+    for (std::uint32_t k = 0; k < kTelemetrySlots; ++k) {
+      const TelemetrySlot& s = seg.slots[k];
+      const std::int32_t pid = s.owner_pid.load(std::memory_order_acquire);
+      if (pid <= 0) { prev_pid[k] = 0; continue; }
+
+      TelemetryValues x;
+      if (!telemetry_load(s, x)) continue;
+
+      double rate = 0.0;
+      if (prev_pid[k] == pid && x.heartbeat_ns > prev[k].heartbeat_ns && x.events >= prev[k].events)
+        rate = double(x.events - prev[k].events) * 1e9 / double(x.heartbeat_ns - prev[k].heartbeat_ns);
+      prev[k] = x;
+      prev_pid[k] = pid;
+
+      char depth[32], lat[48], done[16];
+      std::snprintf(depth, sizeof(depth), "%llu/%llu",
+                    (unsigned long long)x.ring_depth, (unsigned long long)x.max_depth);
+      std::snprintf(lat, sizeof(lat), "%.1f/%.1f/%.1f",
+                    x.lat_p50_ns / 1e3, x.lat_p99_ns / 1e3, x.lat_max_ns / 1e3);
+      if (x.total) std::snprintf(done, sizeof(done), "%.1f", 100.0 * double(x.done) / double(x.total));
+      else         std::snprintf(done, sizeof(done), "-");
+
+      std::printf("%-4u %-7d %-16.16s %12llu %10.0f %9llu %8llu %13s %4s %21s %12.2f %7s %6.1f%s\n",
+                  k, pid, s.name, (unsigned long long)x.events, rate,
+                  (unsigned long long)x.signals, (unsigned long long)x.fills,
+                  depth, x.conflating ? "yes" : "no", lat, x.pnl, done,
+                  x.heartbeat_ns ? (now - x.heartbeat_ns) / 1e9 : 0.0,
+                  telemetry_pid_alive(pid) ? "" : "  (dead)");
+    }
+    std::fflush(stdout);
+    if (once) break;
+    std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+    std::printf("\n");
+  }
+  return 0;
+}